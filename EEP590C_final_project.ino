@@ -5,7 +5,7 @@
  * @section overview Overview
  * This sketch sets up all system resources and tasks needed for a smart security and monitoring system 
  * implemented on ESP32. It includes I2C, RFID, servo control, LCD display, RTC setup, and FreeRTOS-based 
- * task management. Timers and semaphores are used to coordinate access to shared resources.
+ * task management. Timers, queues and a dedicated I2C bus manager task coordinate access to shared resources.
  *
  * @section author Author
  * Created by Sai Jayanth Kalisi, 2025  
@@ -25,7 +25,8 @@
  * a `Serial Print`.
  *
  * To enhance security, a Passive Infrared (PIR) sensor monitors motion near the door. If motion 
- * is detected without a corresponding unlock event, it flags potential unauthorized access. An 
+ * is detected without a corresponding unlock event, it flags potential unauthorized access (see
+ * `correlator.h`). An
  * Ultrasonic sensor further strengthens the intrusion detection by monitoring the proximity of
  * the potential intruder.
  * 
@@ -33,6 +34,10 @@
  * Sensor. This event is logged using the time provided by the RTC. A timer is also started. If the
  * values of the PIR or the Ultrasonic sensor correspond to a person close to the door by the time
  * the timer is up, the timer resets and the LED Flickers on again. If not, the LCD backlight switches off. 
+ * At power-up a boot scheduler (`boot.h`) brings the peripherals up on both cores, locking the
+ * servo and starting the RFID path first, and reports how long each stage took.
+ * The Ultrasonic stream also feeds an approach tracker (`approach.h`) that switches the backlight on
+ * and speeds up RFID polling shortly before someone walking up reaches the reader.
  * An ESP32 microcontroller serves as the system's central controller, managing sensor data, actuator control,
  * and task scheduling using FreeRTOS queues. Instead of the second ESP32, we used the dual-core functionality
  * of the ESP32 to provide parallel control for the sensors and the actuators. 
@@ -55,75 +60,139 @@
 #include "global_defs.h"
 #include "core0.h"
 #include "core1.h"
+#include "telemetry.h"
+#include "i2c_bus.h"
+#include "rfid_inventory.h"
+#include "profiler.h"
+#include "console.h"
+#include "correlator.h"
+#include "boot.h"
+
+//========= BOOT STAGES =========
+// Each stage brings up one part of the system and returns false if it did not
+// come up; boot.h schedules them on both cores. Stages before I2C_BUS use the
+// Wire bus directly, after it only the I2C bus manager does. The I2C stages are
+// pinned to core 0, next to the bus manager, so the slow LCD init never holds
+// up the sensor stage, which must run on core 1.
+
+/** @brief Boot stages, in priority order: the door-usable path first. */
+enum BootStage {
+  STAGE_SERVO = 0,
+  STAGE_GPIO,
+  STAGE_CONFIG,
+  STAGE_ACCESS,
+  STAGE_QUEUES,
+  STAGE_TIMERS,
+  STAGE_RFID,
+  STAGE_DOOR_TASKS,
+  STAGE_READER_TASK,
+  STAGE_SENSORS,
+  STAGE_I2C,
+  STAGE_RTC,
+  STAGE_LCD,
+  STAGE_I2C_BUS,
+  STAGE_DISPLAY,
+  STAGE_SERVICES,
+  STAGE_COUNT
+};
 
-//========= SETUP =========
 /**
- * @brief Arduino setup function
- * 
- * @details Initializes peripherals (pins, serial, servo, LCD, RTC), creates RTOS queues and tasks,
- * sets up timers and interrupts, and initializes I2C and SPI interfaces.
- * 
- * @note Name: setup
+ * @brief Attaches the servo, drives it to the locked position and sets up the LED PWM.
+ * @details No settling delay: the PWM keeps driving the servo while the rest
+ *          of the system comes up. Every LEDC timer and channel is allocated
+ *          here, so no other stage claims one concurrently.
  */
-void setup() {
-  Serial.begin(115200);
+static bool bootServo() {
+  ESP32PWM::allocateTimer(1);
+  myservo.setPeriodHertz(50);
+  myservo.attach(SERVO_PIN, 500, 2400);
+  if (!myservo.attached()) {
+    Serial.println("ERROR: servo attach failed");
+    return false;
+  }
+  myservo.write(180);  // locked, matching isLock
+  pinMode(LED, OUTPUT);
+  ledcAttach(LED, 100, 12);
+  return true;
+}
 
-  //========= GPIO PIN INIT =========
+/** @brief Sensor and button pins. */
+static bool bootGpio() {
   pinMode(PIR_PIN, INPUT);
-  pinMode(LED, OUTPUT);
   pinMode(BUTTON_PIN, INPUT_PULLUP);
   pinMode(TRIG_PIN, OUTPUT);
   pinMode(ECHO_PIN, INPUT);
+  return true;
+}
 
+/** @brief Runtime configuration: NVS if saved, compiled-in defaults otherwise. */
+static bool bootConfig() {
+  doorConfig_t config;
+  cfgDefaults(&config);
+  if (cfgLoad(&config)) {
+    Serial.println("Runtime config restored from NVS");
+  }
+  cfgStoreInit(&runtimeConfig, &config);
+  return true;
+}
 
-  //========= I2C INIT =========
-  Wire.begin(SDA_PIN, SCL_PIN);
-
-  //========= LCD INIT =========
-  lcd.begin(8, 9);
-  lcd.backlight();
-  lcd.clear();
-  lcd.setCursor(0, 0);
-  lcd.print("Person: ");
-  lcd.setCursor(0, 1);
-  lcd.print("State: ");
-
-  //========= PWM LED INIT =========
-  ledcAttach(LED, 100, 12);
-
-  //========= SERVO INIT =========
-  ESP32PWM::allocateTimer(1);
-  myservo.setPeriodHertz(50);
-  myservo.attach(SERVO_PIN, 500, 2400);
-  myservo.write(0);
-  delay(50);
-
-  //========= RTC INIT =========
-  rtc.begin();
-  if (rtc.lostPower()) {
-    Serial.println("RTC lost power, setting time!");
-    rtc.adjust(DateTime(F(__DATE__), F(__TIME__)));  // Set from compile time
+/** @brief Compiles the access policy; on failure the empty table denies every scan. */
+static bool bootAccess() {
+  char accessErr[96];
+  if (!accessCompile(&accessTable, &accessPolicy, accessErr, sizeof(accessErr))) {
+    // Fail closed: an empty table denies every scan
+    Serial.print("ERROR: access policy rejected: ");
+    Serial.println(accessErr);
+    return false;
   }
+  Serial.printf("Access policy: %u credentials, %u schedules\n", accessTable.numCreds, accessTable.numSchedules);
+  return true;
+}
 
-  //========= SEMAPHORE INIT =========
-  i2c_semaphore = xSemaphoreCreateMutex();
+/**
+ * @brief Creates the queues.
+ * @details Only the RFID and sensor queues are required. Without the
+ *          telemetry or correlator queue, producers drop those events and the
+ *          services stage leaves out the task that would read the queue.
+ */
+static bool bootQueues() {
+  rfidQueue = xQueueCreate(5, sizeof(rfidBatch_t));
+  if (!rfidQueue) {
+    Serial.println("ERROR: failed to create rfidQueue");
+  }
+  sensorQueue = xQueueCreate(10, sizeof(sensorData_t));
+  if (!sensorQueue) {
+    Serial.println("ERROR: failed to create sensorQueue");
+  }
+  if (!telemetryInit()) {
+    Serial.println("ERROR: failed to create telemetryQueue");
+  }
+  corrQueue = xQueueCreate(CORR_QUEUE_LEN, sizeof(corrEvent_t));
+  if (!corrQueue) {
+    Serial.println("ERROR: failed to create corrQueue");
+  }
+  return rfidQueue && sensorQueue;
+}
 
-  //========= TIMERS INIT =========
+/** @brief Lock and backlight esp_timers, and the 1 µs GP timer used for echo timing. */
+static bool bootTimers() {
   esp_timer_create_args_t timer_args = {
     .callback = &onLockTimer,
     .arg = NULL,
     .dispatch_method = ESP_TIMER_TASK,
     .name = "lockTimer"
   };
-  esp_timer_create(&timer_args, &lockTimer);
-
   esp_timer_create_args_t backlight_timer_args = {
     .callback = &onBacklightTimer,
     .arg = NULL,
     .dispatch_method = ESP_TIMER_TASK,
     .name = "backlightTimer"
   };
-  esp_timer_create(&backlight_timer_args, &backlightTimer);
+  if (esp_timer_create(&timer_args, &lockTimer) != ESP_OK ||
+      esp_timer_create(&backlight_timer_args, &backlightTimer) != ESP_OK) {
+    Serial.println("ERROR: failed to create timers");
+    return false;
+  }
 
   timer_config_t cfg = {
     .alarm_en = TIMER_ALARM_DIS,          // no alarm
@@ -138,59 +207,186 @@ void setup() {
   timer_init(TIMER_GROUP_0, TIMER_0, &cfg);
   timer_set_counter_value(TIMER_GROUP_0, TIMER_0, 0);
   timer_start(TIMER_GROUP_0, TIMER_0);
+  return true;
+}
 
-  //========= RFID INIT =========
+/** @brief SPI and MFRC522; fails if the reader does not answer with a version. */
+static bool bootRfid() {
   SPI.begin(SCK_PIN, MISO_PIN, MOSI_PIN, SS_PIN);
   rfid.PCD_Init(SS_PIN, RST_PIN);
-  if (xSemaphoreTake(i2c_semaphore, pdMS_TO_TICKS(50)) == pdTRUE) {
-    DateTime now = rtc.now();
-    Serial.printf("Time: %02d:%02d:%02d\n", now.hour(), now.minute(), now.second());
-    xSemaphoreGive(i2c_semaphore);
-  } else {
-    Serial.println("RTC I2C timeout");
+  byte version = rfid.PCD_ReadRegister(MFRC522::VersionReg);
+  if (version == 0x00 || version == 0xFF) {
+    Serial.println("ERROR: RFID reader not responding");
+    return false;
   }
+  return true;
+}
 
-  Serial.println(F("FreeRTOS RFID System Starting..."));
+/** @brief Access decisions and the lock (the servo task runs even without a servo). */
+static bool bootDoorTasks() {
+  return xTaskCreatePinnedToCore(ServoRunTask, "servoRun", 2048, NULL, 1, &TaskServoRun_Handle, 0) == pdPASS &&
+         xTaskCreatePinnedToCore(taskPrinter, "Printer", 2048, NULL, 1, &taskPrinter_Handle, 1) == pdPASS;
+}
 
-  //========= QUEUE INIT =========
-  rfidQueue = xQueueCreate(5, sizeof(char[20]));
-  if (rfidQueue == NULL) {
-    Serial.println("Error creating queue!");
-    while (1)
-      ;
-  }
-  sensorQueue = xQueueCreate(10, sizeof(sensorData_t));
-  if (!sensorQueue) {
-    Serial.println("ERROR: failed to create sensorQueue");
-  }
+/** @brief RFID polling. */
+static bool bootReaderTask() {
+  return xTaskCreatePinnedToCore(taskRFIDReader, "RFID Reader", 4096, NULL, 1, &taskRFIDReader_Handle, 1) == pdPASS;
+}
 
-  //========= TASK CREATION =========
+/**
+ * @brief Ultrasonic / PIR tasks and the echo interrupt.
+ * @details Critical: presence wakes the RFID reader from power-down. Runs on
+ *          core 1 so the echo interrupt is serviced there.
+ */
+static bool bootSensors() {
+  if (xTaskCreatePinnedToCore(sensorReadTask, "SensorReadTask", 8192, NULL, 1, &taskSensorRead_Handle, 1) != pdPASS ||
+      xTaskCreatePinnedToCore(sensorProcessTask, "SensorProcessTask", 8192, NULL, 1, &taskSensorProcess_Handle, 1) !=
+        pdPASS) {
+    return false;
+  }
+  attachInterrupt(ECHO_PIN, echoISR, CHANGE);
+  return true;
+}
 
-  // Name: RFID Reader Task
-  xTaskCreatePinnedToCore(taskRFIDReader, "RFID Reader", 4096, NULL, 1, &taskRFIDReader_Handle, 1);
+/** @brief I2C peripheral. */
+static bool bootI2c() {
+  return Wire.begin(SDA_PIN, SCL_PIN);
+}
 
-  // Name: RFID Printer Task
-  xTaskCreatePinnedToCore(taskPrinter, "Printer", 2048, NULL, 1, &taskPrinter_Handle, 1);
+/** @brief DS3231; sets it from the compile time after a power loss. */
+static bool bootRtc() {
+  if (!rtc.begin()) {
+    Serial.println("ERROR: RTC not found");
+    return false;
+  }
+  if (rtc.lostPower()) {
+    Serial.println("RTC lost power, setting time!");
+    rtc.adjust(DateTime(F(__DATE__), F(__TIME__)));  // Set from compile time
+  }
+  return true;
+}
 
-  // Name: Sensor Read Task
-  xTaskCreatePinnedToCore(sensorReadTask, "SensorReadTask", 8192, NULL, 1, &taskSensorRead_Handle, 1);
+/** @brief LCD and its static labels; fails if the display does not ACK. */
+static bool bootLcd() {
+  Wire.beginTransmission(0x27);
+  if (Wire.endTransmission() != 0) {
+    Serial.println("ERROR: LCD not found");
+    return false;
+  }
+  lcd.begin(8, 9);
+  lcd.backlight();
+  lcd.clear();
+  lcd.setCursor(0, 0);
+  lcd.print("Person: ");
+  lcd.setCursor(0, 1);
+  lcd.print("State: ");
+  return true;
+}
 
-  // Name: Sensor Process Task
-  xTaskCreatePinnedToCore(sensorProcessTask, "SensorProcessTask", 8192, NULL, 1, &taskSensorProcess_Handle, 1);
+/** @brief I2C bus manager; from here on the LCD and RTC are only accessed through i2cBusTask. */
+static bool bootI2cBus() {
+  i2cBusInit(NULL);
+  return xTaskCreatePinnedToCore(i2cBusTask, "I2CBus", 3072, NULL, 2, &TaskI2CBus_Handle, 0) == pdPASS;
+}
 
-  // Name: Servo Controller Task
-  xTaskCreatePinnedToCore(ServoRunTask, "servoRun", 2048, NULL, 1, &TaskServoRun_Handle, 0);
+/** @brief LCD display task. */
+static bool bootDisplay() {
+  return xTaskCreatePinnedToCore(LCDTask, "LCDTask", 2048, NULL, 1, &TaskLCD_Handle, 0) == pdPASS;
+}
 
-  // Name: LCD Display Task
-  xTaskCreatePinnedToCore(LCDTask, "LCDTask", 2048, NULL, 1, &TaskLCD_Handle, 0);
+/**
+ * @brief Telemetry, profiler, console, correlator and anomaly baseline tasks.
+ * @details The telemetry and correlator tasks block on their queue, so each is
+ *          only started if bootQueues() created it; a missing queue fails the
+ *          stage and the report names it, the other tasks still start.
+ */
+static bool bootServices() {
+  bool ok = true;
+  if (telemetryQueue) {
+    ok &= xTaskCreatePinnedToCore(telemetryTask, "Telemetry", 2048, NULL, 1, &TaskTelemetry_Handle, 0) == pdPASS;
+  } else {
+    Serial.println("ERROR: no telemetryQueue, telemetry task not started");
+    ok = false;
+  }
+  ok &= xTaskCreatePinnedToCore(profilerTask, "Profiler", 3072, NULL, 1, &TaskProfiler_Handle, 0) == pdPASS;
+  ok &= xTaskCreatePinnedToCore(consoleTask, "Console", 3072, NULL, 1, &TaskConsole_Handle, 0) == pdPASS;
+  if (corrQueue) {
+    ok &= xTaskCreatePinnedToCore(correlatorTask, "Correlator", 3072, NULL, 1, &TaskCorrelator_Handle, 0) == pdPASS;
+  } else {
+    Serial.println("ERROR: no corrQueue, correlator task not started");
+    ok = false;
+  }
+  ok &= xTaskCreatePinnedToCore(anomalySaveTask, "AnomalySave", 3072, NULL, tskIDLE_PRIORITY, &TaskAnomalySave_Handle,
+                                1) == pdPASS;
 
   //========= DEBUG TASKS =========
   // xTaskCreatePinnedToCore(motionTask, "MotionTask", 2048, NULL, 1, &TaskMotion_Handle, 0);
   // xTaskCreatePinnedToCore(updateButtonTask, "updateButton", 1024, NULL, 1, &TaskUpdateButton_Handle, 0);
   // xTaskCreatePinnedToCore(distanceTask, "UltraSonicTask", 2048, nullptr, 1, &TaskUltraSonic_Handle, 1);
+  return ok;
+}
 
-  //========= INTERRUPTS =========
-  attachInterrupt(ECHO_PIN, echoISR, CHANGE);
+#define B(stage) BOOT_BIT(STAGE_##stage)
+/**
+ * @brief Stage table: name, init, needs, after, core, critical.
+ *
+ * @details Stages with no ordering between them may run at the same time on
+ * the two cores, so they must not share unlocked driver state: LEDC belongs to
+ * servo alone, SPI (MFRC522 on SPI2) to rfid, Wire to the core 0 I2C chain.
+ * config reads NVS, which has its own lock and runs over the flash SPI bus;
+ * the rest only create FreeRTOS objects. rtc and i2c bus are critical because
+ * badges with a schedule or an expiry date are denied until the clock can be
+ * read.
+ */
+static const bootStage_t bootStages[STAGE_COUNT] = {
+  { "servo", bootServo, 0, 0, BOOT_ANY_CORE, true },
+  { "gpio", bootGpio, 0, 0, BOOT_ANY_CORE, true },
+  { "config", bootConfig, 0, 0, BOOT_ANY_CORE, true },
+  { "access", bootAccess, 0, 0, BOOT_ANY_CORE, true },
+  { "queues", bootQueues, 0, 0, BOOT_ANY_CORE, true },
+  { "timers", bootTimers, 0, 0, BOOT_ANY_CORE, true },
+  { "rfid", bootRfid, 0, 0, BOOT_ANY_CORE, true },
+  { "door tasks", bootDoorTasks, B(QUEUES) | B(TIMERS), B(SERVO) | B(CONFIG) | B(ACCESS), BOOT_ANY_CORE, true },
+  { "reader task", bootReaderTask, B(RFID) | B(QUEUES) | B(CONFIG), 0, BOOT_ANY_CORE, true },
+  { "sensors", bootSensors, B(GPIO) | B(QUEUES) | B(TIMERS) | B(CONFIG), B(READER_TASK), 1, true },
+  { "i2c", bootI2c, 0, 0, 0, true },
+  { "rtc", bootRtc, B(I2C), 0, 0, true },
+  { "lcd", bootLcd, B(I2C), B(RTC), 0, false },  // shares the bus with the RTC
+  { "i2c bus", bootI2cBus, B(I2C), B(RTC) | B(LCD), 0, true },
+  { "display", bootDisplay, B(I2C_BUS) | B(LCD), 0, BOOT_ANY_CORE, false },
+  { "services", bootServices, 0, B(QUEUES) | B(CONFIG), BOOT_ANY_CORE, false },
+};
+#undef B
+
+//========= SETUP =========
+/**
+ * @brief Arduino setup function
+ * 
+ * @details Brings the system up through the boot scheduler (`boot.h`): the
+ * stages above run on both cores as their dependencies allow, servo lock, access
+ * policy, RFID reader, sensing and the clock first, display and logging services
+ * in the background. A stage that fails is reported and the stages that need it are
+ * skipped; setup() never halts. Prints the time-to-ready of every stage.
+ * 
+ * @note Name: setup
+ */
+void setup() {
+  Serial.begin(115200);
+
+  char bootErr[96];
+  if (!bootPlanInit(&bootPlan, bootStages, STAGE_COUNT, bootErr, sizeof(bootErr))) {
+    Serial.print("ERROR: boot plan rejected: ");
+    Serial.println(bootErr);
+    return;
+  }
+  bootRun(&bootPlan);
+
+  logTimestamp();
+  Serial.println(F("FreeRTOS RFID System Starting..."));
+  bootPrintReport(&bootPlan);
+  if (bootPlan.broken & (BOOT_BIT(STAGE_RTC) | BOOT_BIT(STAGE_I2C_BUS))) {
+    Serial.println("No clock: badges with a schedule or expiry date are denied (fail closed)");
+  }
 }
 
 
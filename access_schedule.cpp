@@ -0,0 +1,320 @@
+/**
+ * @file access_schedule.cpp
+ * @brief Compiler and lookup for the bitmap access schedules.
+ *
+ * @details
+ * See `access_schedule.h` for the rule format and table layout. Compilation
+ * validates the whole policy and fails without touching the lookup path if
+ * any rule is malformed, so a bad entry is reported at boot instead of being
+ * silently skipped. Slots are rounded outwards: a window opening at 08:10 opens
+ * the 08:00 slot, one closing at 17:05 keeps the 17:00 slot open.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "access_schedule.h"
+
+#define MINUTES_PER_DAY (24 * 60)
+
+//========= HELPERS =========
+
+/**
+ * @brief Sets slots `[from, to)` in one day row.
+ */
+static void setSlots(accessSchedule_t* s, int dayType, int from, int to) {
+  for (int slot = from; slot < to; slot++) {
+    s->slots[dayType][slot / 32] |= 1UL << (slot % 32);
+  }
+}
+
+/**
+ * @brief Parses "YYYY-MM-DD" into a day number.
+ * @return false if the string is not a valid date in 2000-2099
+ */
+static bool parseDate(const char* s, uint16_t* dayNumber) {
+  unsigned y, m, d;
+  char tail;
+  if (sscanf(s, "%4u-%2u-%2u%c", &y, &m, &d, &tail) != 3) return false;
+  if (y < 2000 || y > 2099 || m < 1 || m > 12 || d < 1) return false;
+
+  static const uint8_t daysIn[12] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+  bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+  if (d > daysIn[m - 1] || (m == 2 && d == 29 && !leap)) return false;
+
+  *dayNumber = accessDayNumber((uint16_t)y, (uint8_t)m, (uint8_t)d);
+  return true;
+}
+
+static uint64_t credKey(const accessCredential_t* c) {
+  return ((uint64_t)c->keyHi << 32) | c->keyLo;
+}
+
+static int compareCreds(const void* a, const void* b) {
+  uint64_t ka = credKey((const accessCredential_t*)a);
+  uint64_t kb = credKey((const accessCredential_t*)b);
+  return ka < kb ? -1 : ka > kb ? 1 : 0;
+}
+
+//========= KEYS AND TIME =========
+
+/**
+ * @brief Packs a UID into a 64-bit lookup key.
+ *
+ * @details The length goes in the top byte and up to 7 UID bytes below it,
+ * so 4- and 7-byte UIDs never collide.
+ *
+ * @param uid Raw UID bytes
+ * @param len UID length
+ * @return Key, or 0 if the UID is empty or longer than 7 bytes
+ */
+uint64_t accessKeyFromBytes(const uint8_t* uid, uint8_t len) {
+  if (len == 0 || len > 7) return 0;
+  uint64_t key = (uint64_t)len << 56;
+  for (uint8_t i = 0; i < len; i++) {
+    key |= (uint64_t)uid[i] << (8 * (len - 1 - i));
+  }
+  return key;
+}
+
+/**
+ * @brief Packs a formatted "DE AD BE EF" UID into a lookup key.
+ * @param uid Hex bytes separated by single spaces
+ * @param key Receives the key
+ * @return false if the string is malformed
+ */
+bool accessKeyFromString(const char* uid, uint64_t* key) {
+  uint8_t bytes[7];
+  uint8_t len = 0;
+  const char* p = uid;
+  while (*p) {
+    char* end;
+    unsigned long b = strtoul(p, &end, 16);
+    if (end != p + 2 || b > 0xFF || len == sizeof(bytes)) return false;
+    bytes[len++] = (uint8_t)b;
+    p = end;
+    if (*p == ' ') p++;
+  }
+  *key = accessKeyFromBytes(bytes, len);
+  return *key != 0;
+}
+
+/**
+ * @brief Days since 2000-01-01 (valid for 2000-2099).
+ */
+uint16_t accessDayNumber(uint16_t year, uint8_t month, uint8_t day) {
+  // Shift the year to start in March so the leap day is last
+  int y = year - (month <= 2 ? 1 : 0);
+  int m = month <= 2 ? month + 9 : month - 3;
+  int days = 365 * y + y / 4 - y / 100 + y / 400 + (153 * m + 2) / 5 + day - 1;
+  return (uint16_t)(days - 730425);  // 730425 = same formula for 2000-01-01
+}
+
+/**
+ * @brief Resolves a calendar time to the day type and slot used by accessCheck().
+ *
+ * @details Done once per scan; the holiday lookup is a single bit test.
+ *
+ * @return false if the fields are out of range
+ */
+bool accessTimeFromCalendar(const accessTable_t* t, uint16_t year, uint8_t month, uint8_t day,
+                            uint8_t hour, uint8_t minute, accessTime_t* out) {
+  if (year < 2000 || year > 2099 || month < 1 || month > 12 || day < 1 || day > 31 ||
+      hour > 23 || minute > 59) {
+    return false;
+  }
+  out->day = accessDayNumber(year, month, day);
+  out->dayType = (uint8_t)((out->day + 6) % 7);  // 2000-01-01 was a Saturday
+  out->slot = (uint8_t)((hour * 60 + minute) / ACCESS_SLOT_MIN);
+
+  int idx = (int)out->day - t->holidayBase;
+  if (idx >= 0 && idx < ACCESS_HOLIDAY_DAYS && (t->holidays[idx / 8] & (1 << (idx % 8)))) {
+    out->dayType = 7;
+  }
+  return true;
+}
+
+//========= COMPILATION =========
+
+/**
+ * @brief Attaches caller-provided storage to an empty table.
+ */
+void accessTableInit(accessTable_t* t, accessCredential_t* creds, uint16_t credCap,
+                     accessSchedule_t* schedules, uint8_t schedCap) {
+  memset(t, 0, sizeof(*t));
+  t->creds = creds;
+  t->credCap = credCap;
+  t->schedules = schedules;
+  t->schedCap = schedCap;
+}
+
+/**
+ * @brief Compiles a policy into the table.
+ *
+ * @param t      Table from accessTableInit()
+ * @param policy Rules
+ * @param err    Receives a description of the first problem found
+ * @param errLen Size of `err`
+ * @return false if the policy is invalid or does not fit; the table is then empty
+ */
+bool accessCompile(accessTable_t* t, const accessPolicy_t* policy, char* err, size_t errLen) {
+  t->numCreds = 0;
+  t->numSchedules = 0;
+  t->holidayBase = 0;
+  memset(t->holidays, 0, sizeof(t->holidays));
+
+  if (policy->numSchedules > t->schedCap || policy->numCredentials > t->credCap) {
+    snprintf(err, errLen, "policy needs %u schedules / %u credentials, room for %u / %u",
+             policy->numSchedules, policy->numCredentials, t->schedCap, t->credCap);
+    return false;
+  }
+
+  // Schedules
+  for (uint8_t i = 0; i < policy->numSchedules; i++) {
+    const accessScheduleDef_t* def = &policy->schedules[i];
+    accessSchedule_t* s = &t->schedules[i];
+    memset(s, 0, sizeof(*s));
+
+    for (uint8_t w = 0; w < def->numWindows; w++) {
+      const accessWindow_t* win = &def->windows[w];
+      if (win->start >= MINUTES_PER_DAY || win->end > MINUTES_PER_DAY) {
+        snprintf(err, errLen, "schedule %s: window %u out of range", def->name, w);
+        return false;
+      }
+      int first = win->start / ACCESS_SLOT_MIN;
+      int last = (win->end + ACCESS_SLOT_MIN - 1) / ACCESS_SLOT_MIN;
+      bool wraps = win->end <= win->start;
+
+      for (int d = 0; d < ACCESS_DAY_TYPES; d++) {
+        if (!(win->days & (1 << d))) continue;
+        if (!wraps) {
+          setSlots(s, d, first, last);
+        } else {
+          setSlots(s, d, first, ACCESS_SLOTS_PER_DAY);
+          setSlots(s, d == 7 ? 7 : (d + 1) % 7, 0, last);
+        }
+      }
+    }
+  }
+
+  // Holidays
+  uint16_t days[256];
+  uint16_t base = 0xFFFF;
+  for (uint8_t i = 0; i < policy->numHolidays; i++) {
+    if (!parseDate(policy->holidays[i], &days[i])) {
+      snprintf(err, errLen, "holiday \"%s\" is not a valid date", policy->holidays[i]);
+      return false;
+    }
+    if (days[i] < base) base = days[i];
+  }
+  if (policy->numHolidays > 0) {
+    // Start the bitmap on 1 January of the earliest holiday's year
+    uint16_t year = 2000;
+    while (accessDayNumber(year + 1, 1, 1) <= base) year++;
+    t->holidayBase = accessDayNumber(year, 1, 1);
+  }
+  for (uint8_t i = 0; i < policy->numHolidays; i++) {
+    int idx = days[i] - t->holidayBase;
+    if (idx >= ACCESS_HOLIDAY_DAYS) {
+      snprintf(err, errLen, "holiday \"%s\" beyond the %d-year holiday range",
+               policy->holidays[i], ACCESS_HOLIDAY_YEARS);
+      return false;
+    }
+    t->holidays[idx / 8] |= (uint8_t)(1 << (idx % 8));
+  }
+
+  // Credentials
+  for (uint16_t i = 0; i < policy->numCredentials; i++) {
+    const accessCredentialDef_t* def = &policy->credentials[i];
+    accessCredential_t* c = &t->creds[i];
+    uint64_t key;
+    if (!accessKeyFromString(def->uid, &key)) {
+      snprintf(err, errLen, "credential %u: bad UID \"%s\"", i, def->uid);
+      return false;
+    }
+    if (def->schedule >= policy->numSchedules) {
+      snprintf(err, errLen, "credential %s: no schedule %u", def->uid, def->schedule);
+      return false;
+    }
+    c->keyHi = (uint32_t)(key >> 32);
+    c->keyLo = (uint32_t)key;
+    c->schedule = def->schedule;
+    c->reserved = 0;
+    c->expiryDay = ACCESS_NEVER_EXPIRES;
+    if (def->expires && !parseDate(def->expires, &c->expiryDay)) {
+      snprintf(err, errLen, "credential %s: bad expiry \"%s\"", def->uid, def->expires);
+      return false;
+    }
+  }
+  qsort(t->creds, policy->numCredentials, sizeof(accessCredential_t), compareCreds);
+  for (uint16_t i = 1; i < policy->numCredentials; i++) {
+    if (credKey(&t->creds[i]) == credKey(&t->creds[i - 1])) {
+      snprintf(err, errLen, "duplicate credential %08lX%08lX",
+               (unsigned long)t->creds[i].keyHi, (unsigned long)t->creds[i].keyLo);
+      return false;
+    }
+  }
+
+  t->numSchedules = policy->numSchedules;
+  t->numCreds = policy->numCredentials;
+  return true;
+}
+
+//========= LOOKUP =========
+
+/**
+ * @brief Decides whether a credential may open the door now.
+ *
+ * @param t   Compiled table
+ * @param key Key from accessKeyFromBytes() / accessKeyFromString()
+ * @param now Resolved time, or NULL if the clock is unavailable; then only
+ *            permanent credentials on an always-open schedule pass
+ * @return ::ACCESS_OK or the reason for denial
+ */
+accessResult_t accessCheck(const accessTable_t* t, uint64_t key, const accessTime_t* now) {
+  int lo = 0, hi = (int)t->numCreds - 1;
+  const accessCredential_t* c = NULL;
+  while (lo <= hi) {
+    int mid = (lo + hi) >> 1;
+    uint64_t k = credKey(&t->creds[mid]);
+    if (k == key) {
+      c = &t->creds[mid];
+      break;
+    }
+    if (k < key) lo = mid + 1;
+    else hi = mid - 1;
+  }
+  if (!c) return ACCESS_UNKNOWN;
+
+  const accessSchedule_t* s = &t->schedules[c->schedule];
+  if (!now) {
+    if (c->expiryDay != ACCESS_NEVER_EXPIRES) return ACCESS_NO_CLOCK;
+    for (int d = 0; d < ACCESS_DAY_TYPES; d++)
+      for (int w = 0; w < ACCESS_SLOT_WORDS; w++)
+        if (s->slots[d][w] != 0xFFFFFFFFUL) return ACCESS_NO_CLOCK;
+    return ACCESS_OK;
+  }
+
+  if (now->day > c->expiryDay) return ACCESS_EXPIRED;
+  if (!(s->slots[now->dayType][now->slot / 32] & (1UL << (now->slot % 32)))) return ACCESS_OUT_OF_HOURS;
+  return ACCESS_OK;
+}
+
+/**
+ * @brief Short name of a result for logs.
+ */
+const char* accessResultName(accessResult_t r) {
+  switch (r) {
+    case ACCESS_OK: return "ok";
+    case ACCESS_UNKNOWN: return "unknown";
+    case ACCESS_EXPIRED: return "expired";
+    case ACCESS_OUT_OF_HOURS: return "out of hours";
+    case ACCESS_NO_CLOCK: return "no clock";
+  }
+  return "?";
+}
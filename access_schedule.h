@@ -0,0 +1,155 @@
+/**
+ * @file access_schedule.h
+ * @brief Per-credential time-of-day access schedules, compiled into bitmaps.
+ *
+ * @details
+ * An access policy is written as rules:
+ * - **Schedules**: a list of weekly windows (`days`, `start`–`end` minutes).
+ *   A window whose end is at or before its start runs past midnight; the part
+ *   after midnight applies to the following day of the week (holiday windows
+ *   wrap onto the holiday row itself).
+ * - **Holidays**: dates on which every schedule uses its holiday row instead
+ *   of the weekday row.
+ * - **Credentials**: a UID, a schedule and an optional last valid date.
+ *
+ * `accessCompile()` turns the rules into tables, once at boot:
+ * - each schedule becomes 8 rows (Sunday..Saturday, holiday) of 96 bits, one
+ *   per 15-minute slot (96 bytes per schedule, shared by its credentials),
+ * - holidays become one bit per day over `ACCESS_HOLIDAY_YEARS` years,
+ * - credentials become 12-byte records sorted by packed UID.
+ *
+ * A scan is then decided by `accessCheck()` with a binary search over the
+ * credentials, one compare for expiry and one bit test in the schedule row;
+ * no rule is evaluated at scan time. The module has no Arduino or FreeRTOS
+ * dependencies and is benchmarked on a host by `tools/access_bench`.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef ACCESS_SCHEDULE_H
+#define ACCESS_SCHEDULE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//========= CONFIGURATION =========
+#define ACCESS_SLOT_MIN 15                                      ///< Schedule resolution in minutes
+#define ACCESS_SLOTS_PER_DAY (24 * 60 / ACCESS_SLOT_MIN)        ///< 96 slots
+#define ACCESS_SLOT_WORDS (ACCESS_SLOTS_PER_DAY / 32)           ///< 32-bit words per day row
+#define ACCESS_DAY_TYPES 8                                      ///< Sunday..Saturday, holiday
+#define ACCESS_HOLIDAY_YEARS 4                                  ///< Years covered by the holiday bitmap
+#define ACCESS_HOLIDAY_DAYS (ACCESS_HOLIDAY_YEARS * 366)        ///< Days covered (upper bound)
+#define ACCESS_HOLIDAY_BYTES ((ACCESS_HOLIDAY_DAYS + 7) / 8)    ///< Holiday bitmap size
+#define ACCESS_NEVER_EXPIRES 0xFFFF                             ///< Expiry value of a permanent credential
+
+//========= DAY MASKS =========
+#define ACCESS_SUN 0x01
+#define ACCESS_MON 0x02
+#define ACCESS_TUE 0x04
+#define ACCESS_WED 0x08
+#define ACCESS_THU 0x10
+#define ACCESS_FRI 0x20
+#define ACCESS_SAT 0x40
+#define ACCESS_HOLIDAY 0x80                              ///< Applies on listed holidays
+#define ACCESS_WEEKDAYS 0x3E                             ///< Monday..Friday
+#define ACCESS_EVERY_DAY 0x7F                            ///< Sunday..Saturday, not holidays
+#define ACCESS_ALL_DAYS 0xFF                             ///< Including holidays
+
+#define ACCESS_HM(h, m) ((uint16_t)((h) * 60 + (m)))     ///< Minute of day from hours and minutes
+
+//========= RULES (SOURCE) =========
+
+/** @brief One weekly time window. */
+typedef struct {
+  uint8_t days;    ///< `ACCESS_*` day mask
+  uint16_t start;  ///< First minute of the window (0-1439)
+  uint16_t end;    ///< Minute the window closes; <= start wraps past midnight
+} accessWindow_t;
+
+/** @brief A named set of windows. */
+typedef struct {
+  const char* name;               ///< For logs only
+  const accessWindow_t* windows;  ///< Windows, OR-ed together
+  uint8_t numWindows;             ///< Number of entries in `windows`
+} accessScheduleDef_t;
+
+/** @brief One badge and the schedule it follows. */
+typedef struct {
+  const char* uid;     ///< "DE AD BE EF" form, as printed by the reader
+  uint8_t schedule;    ///< Index into the policy's schedules
+  const char* expires; ///< Last valid date "YYYY-MM-DD", NULL = never
+} accessCredentialDef_t;
+
+/** @brief Complete policy handed to accessCompile(). */
+typedef struct {
+  const accessScheduleDef_t* schedules;
+  uint8_t numSchedules;
+  const accessCredentialDef_t* credentials;
+  uint16_t numCredentials;
+  const char* const* holidays;  ///< "YYYY-MM-DD" dates
+  uint8_t numHolidays;
+} accessPolicy_t;
+
+//========= COMPILED TABLES =========
+
+/** @brief Compiled schedule: one 96-bit row per day type. */
+typedef struct {
+  uint32_t slots[ACCESS_DAY_TYPES][ACCESS_SLOT_WORDS];
+} accessSchedule_t;
+
+/** @brief Compiled credential, 12 bytes. */
+typedef struct {
+  uint32_t keyHi;      ///< Upper half of the packed UID (see accessKeyFromBytes())
+  uint32_t keyLo;      ///< Lower half of the packed UID
+  uint16_t expiryDay;  ///< Last valid day (days since 2000-01-01), ::ACCESS_NEVER_EXPIRES
+  uint8_t schedule;    ///< Index into the table's schedules
+  uint8_t reserved;
+} accessCredential_t;
+
+/** @brief Compiled policy; storage is provided by the caller. */
+typedef struct {
+  accessCredential_t* creds;            ///< Sorted by key
+  uint16_t credCap;
+  uint16_t numCreds;
+  accessSchedule_t* schedules;
+  uint8_t schedCap;
+  uint8_t numSchedules;
+  uint16_t holidayBase;                 ///< Day number of bit 0 of `holidays`
+  uint8_t holidays[ACCESS_HOLIDAY_BYTES];
+} accessTable_t;
+
+/** @brief Point in time resolved against the table, see accessTimeFromCalendar(). */
+typedef struct {
+  uint16_t day;      ///< Days since 2000-01-01
+  uint8_t dayType;   ///< 0 = Sunday .. 6 = Saturday, 7 = holiday
+  uint8_t slot;      ///< 15-minute slot of the day (0-95)
+} accessTime_t;
+
+/** @brief Result of accessCheck(). */
+typedef enum {
+  ACCESS_OK = 0,         ///< Credential valid now
+  ACCESS_UNKNOWN,        ///< UID not in the table
+  ACCESS_EXPIRED,        ///< Past the credential's last valid day
+  ACCESS_OUT_OF_HOURS,   ///< Schedule closed in the current slot
+  ACCESS_NO_CLOCK        ///< Time unavailable and the credential is not unrestricted
+} accessResult_t;
+
+//======================= API =======================//
+void accessTableInit(accessTable_t* t, accessCredential_t* creds, uint16_t credCap,
+                     accessSchedule_t* schedules, uint8_t schedCap);
+bool accessCompile(accessTable_t* t, const accessPolicy_t* policy, char* err, size_t errLen);
+
+uint64_t accessKeyFromBytes(const uint8_t* uid, uint8_t len);
+bool accessKeyFromString(const char* uid, uint64_t* key);
+uint16_t accessDayNumber(uint16_t year, uint8_t month, uint8_t day);
+bool accessTimeFromCalendar(const accessTable_t* t, uint16_t year, uint8_t month, uint8_t day,
+                            uint8_t hour, uint8_t minute, accessTime_t* out);
+
+accessResult_t accessCheck(const accessTable_t* t, uint64_t key, const accessTime_t* now);
+const char* accessResultName(accessResult_t r);
+
+#endif
@@ -0,0 +1,203 @@
+/**
+ * @file anomaly.cpp
+ * @brief Implementation of the streaming time-of-day anomaly detector.
+ *
+ * @details
+ * See `anomaly.h` for the model. The per-sample path is a handful of float
+ * operations and compares; nothing here allocates, loops over history or
+ * touches a peripheral. Observations that were themselves flagged as anomalous
+ * are not folded into the baseline so a burst of unusual activity does not
+ * teach the detector that it is normal.
+ *
+ * Baselines are stored in the NVS namespace `"anomaly"` when built for the
+ * board (`ARDUINO` defined); host builds get no-op persistence.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <string.h>
+#include "anomaly.h"
+
+#ifdef ARDUINO
+#include <Preferences.h>
+#endif
+
+//========= HELPERS =========
+
+/**
+ * @brief Folds one observation into an EWMA mean/variance.
+ */
+static void ewmaUpdate(ewmaStat_t* s, float x) {
+  if (s->count == 0) {
+    s->mean = x;
+    s->var = 0.0f;
+  } else {
+    float diff = x - s->mean;
+    s->mean += ANOMALY_ALPHA * diff;
+    s->var = (1.0f - ANOMALY_ALPHA) * (s->var + ANOMALY_ALPHA * diff * diff);
+  }
+  if (s->count < UINT32_MAX) s->count++;
+}
+
+/**
+ * @brief True when `x` is more than K sigma above the mean of a warmed-up stat.
+ */
+static bool ewmaAbove(const ewmaStat_t* s, float x) {
+  if (s->count < ANOMALY_MIN_SAMPLES) return false;
+  float diff = x - s->mean;
+  return diff > 0.0f && diff * diff > ANOMALY_K_SIGMA * ANOMALY_K_SIGMA * s->var;
+}
+
+//========= API =========
+
+/**
+ * @brief Resets the detector, including learned baselines.
+ * @param det Detector state
+ */
+void anomalyInit(anomalyDetector_t* det) {
+  memset(det, 0, sizeof(*det));
+}
+
+/**
+ * @brief Maps an hour of the day (0-23) to a baseline bucket.
+ * @param hour Hour from the RTC
+ * @return Bucket index
+ */
+uint8_t anomalyBucketForHour(uint8_t hour) {
+  return (uint8_t)((hour % 24) * ANOMALY_BUCKETS / 24);
+}
+
+/**
+ * @brief Time since the current presence started.
+ * @return Dwell in ms, or 0 when nobody is present
+ */
+uint32_t anomalyPresenceMs(const anomalyDetector_t* det, uint32_t nowMs) {
+  return det->present ? nowMs - det->presenceStartMs : 0;
+}
+
+/**
+ * @brief Feeds one 50 Hz sensor sample into the detector.
+ *
+ * @param det        Detector state
+ * @param nowMs      Sample time (millis)
+ * @param hour       Current hour of day (0-23)
+ * @param distanceCm Ultrasonic distance, 0 if no echo
+ * @param pir        Raw PIR level
+ * @param present    Current presence decision (close_dist || motion_detected)
+ * @return Bitmask of `ANOMALY_*` events raised by this sample
+ */
+uint8_t anomalyOnSample(anomalyDetector_t* det, uint32_t nowMs, uint8_t hour,
+                        float distanceCm, bool pir, bool present) {
+  uint8_t events = ANOMALY_NONE;
+  anomalyBucket_t* b = &det->buckets[anomalyBucketForHour(hour)];
+
+  // — presence / dwell tracking —
+  if (present && !det->present) {
+    det->present = true;
+    det->scannedThisPresence = false;
+    det->loiterFlagged = false;
+    det->presenceStartMs = nowMs;
+    det->presenceBucket = anomalyBucketForHour(hour);
+  } else if (!present && det->present) {
+    det->present = false;
+    if (!det->loiterFlagged) {
+      ewmaUpdate(&det->buckets[det->presenceBucket].dwellMs, (float)(nowMs - det->presenceStartMs));
+    }
+  }
+
+  if (det->present) {
+    if (distanceCm > 0.0f) ewmaUpdate(&b->distCm, distanceCm);
+
+    uint32_t dwell = nowMs - det->presenceStartMs;
+    if (!det->scannedThisPresence && !det->loiterFlagged && dwell >= ANOMALY_MIN_LOITER_MS) {
+      const ewmaStat_t* d = &det->buckets[det->presenceBucket].dwellMs;
+      bool loiter = (d->count < ANOMALY_MIN_SAMPLES) ? dwell >= ANOMALY_COLD_LOITER_MS
+                                                     : ewmaAbove(d, (float)dwell);
+      if (loiter) {
+        det->loiterFlagged = true;
+        events |= ANOMALY_LOITERING;
+      }
+    }
+  }
+
+  // — PIR duty cycle window —
+  det->dutySamples++;
+  if (pir) det->dutyHigh++;
+  if (det->dutySamples >= ANOMALY_DUTY_WINDOW) {
+    float duty = (float)det->dutyHigh / (float)det->dutySamples;
+    if (ewmaAbove(&b->pirDuty, duty)) {
+      events |= ANOMALY_HIGH_ACTIVITY;
+    } else {
+      ewmaUpdate(&b->pirDuty, duty);
+    }
+    det->dutySamples = 0;
+    det->dutyHigh = 0;
+  }
+
+  return events;
+}
+
+/**
+ * @brief Feeds one RFID access decision into the detector.
+ *
+ * @param det     Detector state
+ * @param nowMs   Scan time (millis)
+ * @param granted true if the tag was authorized
+ * @return Bitmask of `ANOMALY_*` events raised by this scan
+ */
+uint8_t anomalyOnScan(anomalyDetector_t* det, uint32_t nowMs, bool granted) {
+  det->scannedThisPresence = true;
+  if (granted) return ANOMALY_NONE;
+
+  det->denials[det->denialIdx] = nowMs;
+  det->denialIdx = (det->denialIdx + 1) % ANOMALY_DENIAL_COUNT;
+  if (det->denialCount < ANOMALY_DENIAL_COUNT) det->denialCount++;
+
+  // the slot we will overwrite next is the oldest of the last N denials
+  uint32_t oldest = det->denials[det->denialIdx];
+  if (det->denialCount == ANOMALY_DENIAL_COUNT && nowMs - oldest <= ANOMALY_DENIAL_WINDOW_MS) {
+    det->denialCount = 0;  // report each burst once
+    return ANOMALY_DENIAL_BURST;
+  }
+  return ANOMALY_NONE;
+}
+
+//========= PERSISTENCE =========
+
+/**
+ * @brief Stores the learned baselines in NVS.
+ * @return true on success (always false on host builds)
+ */
+bool anomalySaveBaseline(const anomalyDetector_t* det) {
+#ifdef ARDUINO
+  Preferences prefs;
+  if (!prefs.begin("anomaly", false)) return false;
+  size_t n = prefs.putBytes("base", det->buckets, sizeof(det->buckets));
+  prefs.end();
+  return n == sizeof(det->buckets);
+#else
+  (void)det;
+  return false;
+#endif
+}
+
+/**
+ * @brief Restores baselines previously saved with anomalySaveBaseline().
+ * @return true if a baseline of the expected layout was found
+ */
+bool anomalyLoadBaseline(anomalyDetector_t* det) {
+#ifdef ARDUINO
+  Preferences prefs;
+  if (!prefs.begin("anomaly", true)) return false;
+  bool ok = prefs.getBytesLength("base") == sizeof(det->buckets) &&
+            prefs.getBytes("base", det->buckets, sizeof(det->buckets)) == sizeof(det->buckets);
+  prefs.end();
+  return ok;
+#else
+  (void)det;
+  return false;
+#endif
+}
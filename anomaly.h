@@ -0,0 +1,106 @@
+/**
+ * @file anomaly.h
+ * @brief Streaming statistical anomaly detector for the Smart Security Door system.
+ *
+ * @details
+ * Learns what "normal" activity at the door looks like for each time-of-day
+ * bucket and flags departures from it. For every bucket the detector keeps an
+ * exponentially weighted mean and variance (EWMA) of:
+ * - presence dwell time (seconds from presence start to presence end),
+ * - distance while someone is present (cm),
+ * - PIR duty cycle over a fixed window of samples.
+ *
+ * Flagged anomalies:
+ * - **Loitering**: presence lasting longer than `mean + K·sigma` of the bucket's
+ *   dwell time (and at least `ANOMALY_MIN_LOITER_MS`) without any RFID scan.
+ * - **Repeated denials**: `ANOMALY_DENIAL_COUNT` denied scans within
+ *   `ANOMALY_DENIAL_WINDOW_MS`.
+ * - **High activity**: a PIR duty-cycle window above `mean + K·sigma`.
+ *
+ * Every call is O(1) with fixed memory. The detector itself has no Arduino or
+ * FreeRTOS dependencies so it can be built and benchmarked on a host; only
+ * `anomalySaveBaseline()` / `anomalyLoadBaseline()` (NVS persistence) are
+ * compiled for the board.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef ANOMALY_H
+#define ANOMALY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//========= CONFIGURATION =========
+#define ANOMALY_BUCKETS 12                ///< Time-of-day buckets (2 h each)
+#define ANOMALY_ALPHA 0.05f               ///< EWMA smoothing factor
+#define ANOMALY_K_SIGMA 3.0f              ///< Threshold in standard deviations
+#define ANOMALY_MIN_SAMPLES 20            ///< Observations before a bucket can raise anomalies
+#define ANOMALY_MIN_LOITER_MS 30000UL     ///< Never flag loitering below this dwell time
+#define ANOMALY_COLD_LOITER_MS 120000UL   ///< Loitering threshold while a bucket is still learning
+#define ANOMALY_DENIAL_COUNT 3            ///< Denials that make a burst
+#define ANOMALY_DENIAL_WINDOW_MS 60000UL  ///< Window for a denial burst
+#define ANOMALY_DUTY_WINDOW 3000          ///< PIR duty-cycle window in samples (60 s at 50 Hz)
+
+//========= EVENT FLAGS =========
+#define ANOMALY_NONE 0x00
+#define ANOMALY_LOITERING 0x01      ///< Presence too long without a scan
+#define ANOMALY_DENIAL_BURST 0x02   ///< Repeated denied scans
+#define ANOMALY_HIGH_ACTIVITY 0x04  ///< PIR duty cycle unusually high
+
+/**
+ * @brief EWMA mean/variance accumulator.
+ */
+typedef struct {
+  float mean;      ///< Smoothed mean
+  float var;       ///< Smoothed variance
+  uint32_t count;  ///< Number of observations folded in
+} ewmaStat_t;
+
+/**
+ * @brief Learned baseline of one time-of-day bucket (persisted to NVS).
+ */
+typedef struct {
+  ewmaStat_t dwellMs;    ///< Presence dwell time
+  ewmaStat_t distCm;     ///< Distance while present
+  ewmaStat_t pirDuty;    ///< PIR duty cycle, 0..1
+} anomalyBucket_t;
+
+/**
+ * @brief Full detector state.
+ */
+typedef struct {
+  anomalyBucket_t buckets[ANOMALY_BUCKETS];  ///< Learned baselines
+
+  // — current presence —
+  bool present;              ///< Someone is currently detected
+  bool scannedThisPresence;  ///< An RFID scan happened during the current presence
+  bool loiterFlagged;        ///< Loitering already reported for the current presence
+  uint32_t presenceStartMs;  ///< millis() when the current presence started
+  uint8_t presenceBucket;    ///< Bucket the current presence started in
+
+  // — PIR duty window —
+  uint16_t dutySamples;  ///< Samples in the current window
+  uint16_t dutyHigh;     ///< Samples with PIR high in the current window
+
+  // — denied-scan ring —
+  uint32_t denials[ANOMALY_DENIAL_COUNT];  ///< Timestamps of the most recent denials
+  uint8_t denialIdx;                       ///< Next slot in `denials`
+  uint8_t denialCount;                     ///< Valid entries in `denials`
+} anomalyDetector_t;
+
+//======================= API =======================//
+void anomalyInit(anomalyDetector_t* det);
+uint8_t anomalyBucketForHour(uint8_t hour);
+uint8_t anomalyOnSample(anomalyDetector_t* det, uint32_t nowMs, uint8_t hour,
+                        float distanceCm, bool pir, bool present);
+uint8_t anomalyOnScan(anomalyDetector_t* det, uint32_t nowMs, bool granted);
+uint32_t anomalyPresenceMs(const anomalyDetector_t* det, uint32_t nowMs);
+
+bool anomalySaveBaseline(const anomalyDetector_t* det);
+bool anomalyLoadBaseline(anomalyDetector_t* det);
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * @file approach.cpp
+ * @brief Fixed-point alpha-beta approach tracker.
+ *
+ * @details
+ * One update per distance sample:
+ * - predict:  `xp = x + v·dt`
+ * - correct:  `x = xp + α·r`, `v = v + β·r / dt`, with residual `r = z − xp`
+ * followed by the time-to-arrival estimate and the wake / release hysteresis
+ * described in `approach.h`. Gains are Q8 so the products stay well inside
+ * 32 bits for every distance the sensor can report.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <string.h>
+#include "approach.h"
+
+#define Q4(mm) ((int32_t)(mm) * 16)      ///< mm (or mm/s) to the tracker's 1/16 units
+#define APPROACH_MAX_V Q4(8000)          ///< Velocity clamp, well above walking pace
+#define APPROACH_MAX_DT_MS 1000          ///< Longer gaps are predicted over at most this
+
+/**
+ * @brief Resets the tracker; nothing is tracked and no wake is active.
+ * @param t Tracker state
+ */
+void approachInit(approachTracker_t* t) {
+  memset(t, 0, sizeof(*t));
+  t->ttaMs = APPROACH_NO_ARRIVAL;
+}
+
+/**
+ * @brief Folds one distance sample into the track and evaluates the wake condition.
+ *
+ * @param t          Tracker state
+ * @param distanceMm Ultrasonic distance, 0 if no echo
+ * @param dtMs       Time since the previous sample
+ * @param leadMs     Wake this long before the predicted arrival; 0 wakes on arrival only
+ * @return Bitmask of `APPROACH_WAKE` / `APPROACH_RELEASED`
+ */
+uint8_t approachUpdate(approachTracker_t* t, uint16_t distanceMm, uint32_t dtMs, uint32_t leadMs) {
+  if (dtMs == 0) dtMs = 1;
+  if (dtMs > APPROACH_MAX_DT_MS) dtMs = APPROACH_MAX_DT_MS;
+  bool valid = distanceMm != 0 && distanceMm <= APPROACH_MAX_RANGE_MM;
+  int32_t z = Q4(distanceMm);
+
+  // 1) track update
+  if (!t->tracking) {
+    if (valid) {
+      t->x = z;
+      t->v = 0;
+      t->tracking = true;
+      t->age = 1;
+      t->misses = 0;
+    }
+  } else {
+    int32_t xp = t->x + t->v * (int32_t)dtMs / 1000;
+    int32_t r = z - xp;
+    if (valid && r <= Q4(APPROACH_GATE_MM) && r >= -Q4(APPROACH_GATE_MM)) {
+      t->x = xp + APPROACH_ALPHA_Q8 * r / 256;
+      t->v += APPROACH_BETA_Q8 * r * 1000 / (int32_t)dtMs / 256;
+      if (t->v > APPROACH_MAX_V) t->v = APPROACH_MAX_V;
+      if (t->v < -APPROACH_MAX_V) t->v = -APPROACH_MAX_V;
+      if (t->age < UINT16_MAX) t->age++;
+      t->misses = 0;
+    } else {
+      t->x = xp < 0 ? 0 : xp;  // coast on the prediction
+      if (++t->misses >= APPROACH_MAX_MISSES) {
+        t->tracking = false;
+        t->dropped++;
+      }
+    }
+  }
+
+  // 2) time to arrival
+  bool qualifies = false;
+  t->ttaMs = APPROACH_NO_ARRIVAL;
+  if (t->tracking && t->age >= APPROACH_MIN_AGE) {
+    if (t->x <= Q4(APPROACH_ARRIVE_MM)) {
+      t->ttaMs = 0;
+      qualifies = true;
+    } else if (-t->v >= Q4(APPROACH_MIN_SPEED_MMS)) {
+      t->ttaMs = (uint32_t)((t->x - Q4(APPROACH_ARRIVE_MM)) * 1000 / -t->v);
+      qualifies = t->ttaMs <= leadMs;
+    }
+  }
+
+  // 3) wake / release hysteresis
+  uint8_t events = APPROACH_NONE;
+  if (qualifies) {
+    t->release = 0;
+    if (t->confirm < UINT8_MAX) t->confirm++;
+    if (!t->awake && t->confirm >= APPROACH_CONFIRM) {
+      t->awake = true;
+      t->wakes++;
+      events |= APPROACH_WAKE;
+    }
+  } else {
+    t->confirm = 0;
+    if (t->awake && (!t->tracking || ++t->release >= APPROACH_RELEASE)) {
+      t->awake = false;
+      t->release = 0;
+      events |= APPROACH_RELEASED;
+    }
+  }
+  return events;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file approach.h
+ * @brief Approach tracker: distance, radial velocity and time-to-arrival from the ultrasonic stream.
+ *
+ * @details
+ * The proximity flag of `doorSensorUpdate()` only fires once someone is
+ * already at the reader. This tracker runs a fixed-point alpha-beta filter
+ * over the same 50 Hz distance samples, estimates how fast the target is
+ * closing in and predicts when it will reach `APPROACH_ARRIVE_MM`. Once the
+ * predicted time-to-arrival drops below the configured lead time (or the
+ * target is already within arrival distance) the tracker raises a wake
+ * event, which `sensorProcessTask` uses to switch the LCD backlight on and to
+ * put the RFID reader on its fast poll period before the person is there.
+ *
+ * Track handling:
+ * - No echo (0) or a reading outside the range coasts the track on its
+ *   prediction; after `APPROACH_MAX_MISSES` misses in a row the track is
+ *   dropped.
+ * - Readings further than `APPROACH_GATE_MM` from the prediction (spikes, a
+ *   different object stepping into the beam) count as misses, so a jump in
+ *   distance is never mistaken for velocity. A new target is picked up as a
+ *   fresh track once the old one is dropped.
+ * - Velocity is only trusted after `APPROACH_MIN_AGE` samples, and a wake
+ *   needs `APPROACH_CONFIRM` qualifying samples in a row; the wake is released
+ *   after `APPROACH_RELEASE` samples that neither approach nor stay near, or
+ *   when the track is dropped.
+ *
+ * Positions are held in 1/16 mm and velocities in 1/16 mm/s in 32-bit
+ * integers, gains are Q8; an update is a handful of integer operations and no
+ * divisions other than by the sample period. The tracker has no Arduino or
+ * FreeRTOS dependencies and is validated on a host against recorded and
+ * synthetic walk-up traces by `tools/approach_replay`.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef APPROACH_H
+#define APPROACH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//========= CONFIGURATION =========
+#define APPROACH_ALPHA_Q8 64          ///< Position gain, 0.25
+#define APPROACH_BETA_Q8 9            ///< Velocity gain, ~0.036 (Benedict-Bordner for alpha 0.25)
+#define APPROACH_MAX_RANGE_MM 4000    ///< Readings beyond this are treated as no echo
+#define APPROACH_GATE_MM 300          ///< Largest accepted distance from the prediction
+#define APPROACH_MAX_MISSES 10        ///< Consecutive misses before the track is dropped
+#define APPROACH_MIN_AGE 15           ///< Updates before the velocity estimate is used
+#define APPROACH_ARRIVE_MM 400        ///< Distance at which a person counts as at the reader
+#define APPROACH_MIN_SPEED_MMS 250    ///< Slower closing speeds are not an approach
+#define APPROACH_CONFIRM 3            ///< Qualifying samples in a row before waking
+#define APPROACH_RELEASE 25           ///< Non-qualifying samples in a row before releasing
+#define APPROACH_LEAD_MS 1500         ///< Default wake lead time before the predicted arrival
+
+//========= EVENT FLAGS =========
+#define APPROACH_NONE 0x00
+#define APPROACH_WAKE 0x01     ///< Someone is about to arrive (or has arrived)
+#define APPROACH_RELEASED 0x02 ///< The woken target left or was lost
+
+#define APPROACH_NO_ARRIVAL UINT32_MAX  ///< Time-to-arrival while nothing is approaching
+
+/**
+ * @brief Tracker state.
+ */
+typedef struct {
+  int32_t x;          ///< Distance estimate, 1/16 mm
+  int32_t v;          ///< Radial velocity estimate, 1/16 mm/s (negative = closing in)
+  bool tracking;      ///< x and v describe a target
+  bool awake;         ///< A wake has been raised and not yet released
+  uint16_t age;       ///< Measurements folded into the current track
+  uint8_t misses;     ///< Consecutive samples without an accepted measurement
+  uint8_t confirm;    ///< Consecutive samples qualifying for a wake
+  uint8_t release;    ///< Consecutive samples not qualifying while awake
+  uint32_t ttaMs;     ///< Latest time-to-arrival, ::APPROACH_NO_ARRIVAL if not approaching
+  uint32_t wakes;     ///< Wake events raised
+  uint32_t dropped;   ///< Tracks dropped
+} approachTracker_t;
+
+//======================= API =======================//
+void approachInit(approachTracker_t* t);
+uint8_t approachUpdate(approachTracker_t* t, uint16_t distanceMm, uint32_t dtMs, uint32_t leadMs);
+
+/** @brief Estimated distance in mm (meaningful while tracking). */
+static inline int32_t approachDistanceMm(const approachTracker_t* t) { return t->x / 16; }
+
+/** @brief Estimated radial velocity in mm/s, negative while closing in. */
+static inline int32_t approachVelocityMms(const approachTracker_t* t) { return t->v / 16; }
+
+#endif
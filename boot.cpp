@@ -0,0 +1,224 @@
+/**
+ * @file boot.cpp
+ * @brief Boot scheduler core and its FreeRTOS workers.
+ *
+ * @details
+ * `bootClaim()` and `bootFinish()` only touch the plan; on the device the
+ * workers call them under a spinlock and run the stage itself outside it.
+ * Times are microseconds since boot (`esp_timer_get_time()`), truncated to 32
+ * bits, which covers the first 71 minutes.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "boot.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "esp_timer.h"
+#endif
+
+//========= SCHEDULER =========
+
+/**
+ * @brief Validates a stage table and resets the plan.
+ *
+ * @param b      Plan
+ * @param stages Stage table, in priority order
+ * @param count  Number of stages
+ * @param err    Receives a reason on failure
+ * @param errLen Size of `err`
+ * @return false if the table is too large or a stage depends on itself or a later stage
+ */
+bool bootPlanInit(bootPlan_t* b, const bootStage_t* stages, uint8_t count, char* err, size_t errLen) {
+  memset(b, 0, sizeof(*b));
+  if (count > BOOT_MAX_STAGES) {
+    snprintf(err, errLen, "%u stages, at most %u", count, BOOT_MAX_STAGES);
+    return false;
+  }
+  for (uint8_t i = 0; i < count; i++) {
+    uint32_t earlier = BOOT_BIT(i) - 1;
+    if ((stages[i].needs | stages[i].after) & ~earlier) {
+      snprintf(err, errLen, "stage %s depends on itself or a later stage", stages[i].name);
+      return false;
+    }
+    if (stages[i].critical) b->criticalLeft++;
+  }
+  b->stages = stages;
+  b->count = count;
+  b->left = count;
+  return true;
+}
+
+/**
+ * @brief Marks a stage finished and updates the door-ready and done times.
+ */
+static void finish(bootPlan_t* b, int stage, uint8_t state, uint32_t nowUs) {
+  b->state[stage] = state;
+  b->readyUs[stage] = nowUs;
+  b->finished |= BOOT_BIT(stage);
+  if (state != BOOT_READY) b->broken |= BOOT_BIT(stage);
+  if (b->stages[stage].critical && --b->criticalLeft == 0) b->doorReadyUs = nowUs;
+  if (--b->left == 0) b->doneUs = nowUs;
+}
+
+/**
+ * @brief Takes the first stage that can start on a worker.
+ *
+ * @details Pending stages that need a failed or skipped stage are skipped on
+ * the way; since dependencies point backwards, one pass skips the whole chain.
+ *
+ * @param b     Plan
+ * @param core  Core the worker runs on, or `BOOT_ANY_CORE` to accept pinned stages too
+ * @param nowUs Current time
+ * @return Stage index to run, `BOOT_WAIT` or `BOOT_DONE`
+ */
+int bootClaim(bootPlan_t* b, uint8_t core, uint32_t nowUs) {
+  for (uint8_t i = 0; i < b->count && b->left; i++) {
+    if (b->state[i] != BOOT_PENDING) continue;
+    const bootStage_t* s = &b->stages[i];
+    if (s->needs & b->broken) {
+      b->core[i] = core;
+      b->startUs[i] = nowUs;
+      finish(b, i, BOOT_SKIPPED, nowUs);
+      continue;
+    }
+    uint32_t waitFor = s->needs | s->after;
+    if ((b->finished & waitFor) != waitFor) continue;
+    if (s->core != BOOT_ANY_CORE && core != BOOT_ANY_CORE && s->core != core) continue;
+
+    b->state[i] = BOOT_RUNNING;
+    b->core[i] = core;
+    b->startUs[i] = nowUs;
+    return i;
+  }
+  return b->left ? BOOT_WAIT : BOOT_DONE;
+}
+
+/**
+ * @brief Records the outcome of a claimed stage.
+ * @param b     Plan
+ * @param stage Index returned by bootClaim()
+ * @param ok    Return value of the stage's init function
+ * @param nowUs Current time
+ */
+void bootFinish(bootPlan_t* b, int stage, bool ok, uint32_t nowUs) {
+  finish(b, stage, ok ? BOOT_READY : BOOT_FAILED, nowUs);
+}
+
+/**
+ * @brief True if a critical stage failed or was skipped.
+ */
+bool bootDegraded(const bootPlan_t* b) {
+  for (uint8_t i = 0; i < b->count; i++)
+    if (b->stages[i].critical && (b->broken & BOOT_BIT(i))) return true;
+  return false;
+}
+
+/**
+ * @brief Readable state name for the report.
+ */
+const char* bootStateName(uint8_t state) {
+  switch (state) {
+    case BOOT_PENDING: return "pending";
+    case BOOT_RUNNING: return "running";
+    case BOOT_READY: return "ready";
+    case BOOT_FAILED: return "FAILED";
+    case BOOT_SKIPPED: return "skipped";
+    default: return "?";
+  }
+}
+
+#ifdef ARDUINO
+//========= WORKERS =========
+
+static portMUX_TYPE bootMux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t bootWorkers[2] = { NULL, NULL };  ///< setup() and the helper task
+
+/**
+ * @brief Claims and runs stages until every stage has finished.
+ * @param b    Plan
+ * @param core Core this worker may run pinned stages for, or `BOOT_ANY_CORE`
+ */
+static void bootWork(bootPlan_t* b, uint8_t core) {
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  while (1) {
+    portENTER_CRITICAL(&bootMux);
+    int stage = bootClaim(b, core, (uint32_t)esp_timer_get_time());
+    portEXIT_CRITICAL(&bootMux);
+    if (stage == BOOT_DONE) break;
+    if (stage == BOOT_WAIT) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(BOOT_POLL_MS));
+      continue;
+    }
+
+    bool ok = b->stages[stage].run();
+    portENTER_CRITICAL(&bootMux);
+    bootFinish(b, stage, ok, (uint32_t)esp_timer_get_time());
+    portEXIT_CRITICAL(&bootMux);
+
+    // a finished stage may unblock the other worker
+    for (int w = 0; w < 2; w++)
+      if (bootWorkers[w] && bootWorkers[w] != self) xTaskNotifyGive(bootWorkers[w]);
+  }
+}
+
+/** @brief Helper worker on the other core; deletes itself when the boot is done. */
+static void bootHelperTask(void* arg) {
+  bootWork((bootPlan_t*)arg, (uint8_t)xPortGetCoreID());
+  bootWorkers[1] = NULL;
+  vTaskDelete(NULL);
+}
+
+/**
+ * @brief Runs the plan on the calling task and a helper task on the other core.
+ *
+ * @details Returns once every stage has finished. setup() is raised above the
+ * tasks it creates for the duration, so they do not delay the remaining
+ * stages. If the helper cannot be created, the caller runs every stage,
+ * pinned ones included.
+ *
+ * @param b Plan from bootPlanInit()
+ */
+void bootRun(bootPlan_t* b) {
+  UBaseType_t prio = uxTaskPriorityGet(NULL);
+  vTaskPrioritySet(NULL, BOOT_PRIORITY);
+  uint8_t core = (uint8_t)xPortGetCoreID();
+  bootWorkers[0] = xTaskGetCurrentTaskHandle();
+  if (xTaskCreatePinnedToCore(bootHelperTask, "Boot", BOOT_HELPER_STACK, b, BOOT_HELPER_PRIORITY, &bootWorkers[1],
+                              1 - core) != pdPASS) {
+    Serial.println("ERROR: failed to create boot helper, booting on one core");
+    core = BOOT_ANY_CORE;
+  }
+  bootWork(b, core);
+  bootWorkers[0] = NULL;
+  vTaskPrioritySet(NULL, prio);
+}
+
+/**
+ * @brief Prints time-to-ready of every stage and the outcome of the boot to Serial.
+ */
+void bootPrintReport(const bootPlan_t* b) {
+  uint32_t serialUs = 0;
+  for (uint8_t i = 0; i < b->count; i++)
+    if (b->state[i] == BOOT_READY || b->state[i] == BOOT_FAILED) serialUs += b->readyUs[i] - b->startUs[i];
+
+  Serial.printf("Boot: door ready at %.1f ms, complete at %.1f ms (stages take %.1f ms back to back)\n",
+                b->doorReadyUs / 1000.0, b->doneUs / 1000.0, serialUs / 1000.0);
+  Serial.printf("  %-14s %4s %9s %9s %9s  %s\n", "stage", "core", "start ms", "ready ms", "took ms", "result");
+  for (uint8_t i = 0; i < b->count; i++) {
+    const char* core = b->core[i] == BOOT_ANY_CORE ? "-" : b->core[i] ? "1" : "0";
+    Serial.printf("  %-14s %4s %9.1f %9.1f %9.1f  %s%s\n", b->stages[i].name, core, b->startUs[i] / 1000.0,
+                  b->readyUs[i] / 1000.0, (b->readyUs[i] - b->startUs[i]) / 1000.0, bootStateName(b->state[i]),
+                  b->stages[i].critical ? " *" : "");
+  }
+  if (bootDegraded(b)) Serial.println("Boot DEGRADED: a critical stage (*) did not come up");
+}
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file boot.h
+ * @brief Dependency-aware boot scheduler with per-stage startup timing.
+ *
+ * @details
+ * `setup()` describes the bring-up as a table of stages. Each stage has an
+ * init function, the stages it **needs** (they must have come up), the stages
+ * it must run **after** (they must have finished, whatever the outcome), an
+ * optional core and a **critical** flag for the path that makes the door
+ * usable: servo locked, credentials compiled, RFID reader and access tasks
+ * running, and the clock that time-restricted credentials are checked against.
+ *
+ * Two workers, `setup()` itself and a helper task on the other core, claim
+ * stages as their dependencies finish, so independent peripherals come up
+ * concurrently. Table order is priority order: a worker always takes the
+ * first claimable stage, which puts the critical path ahead of the display
+ * and logging, which finish in the background.
+ *
+ * A stage whose init function returns false is marked failed. The stages
+ * that need it are skipped rather than started on a missing peripheral, and
+ * everything else still comes up. Nothing in the boot sequence spins: the
+ * worst case is a degraded door, which the report names.
+ *
+ * Every stage records when it was claimed and when it finished, in
+ * microseconds since boot. The plan also records when the last critical
+ * stage finished ("door ready"). `bootPrintReport()` prints them once at boot
+ * and from the console's `boot` command.
+ *
+ * The scheduler core (`bootClaim()`, `bootFinish()`) has no Arduino or
+ * FreeRTOS dependencies. `tools/boot_sim` drives it with modelled stage
+ * durations to measure time-to-ready and to inject failures on a host.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//========= CONFIGURATION =========
+#define BOOT_MAX_STAGES 32   ///< Stages per plan (one bit each in the dependency masks)
+#define BOOT_ANY_CORE 0xFF   ///< Stage may run on either core / worker accepts any stage
+#define BOOT_POLL_MS 5       ///< Longest a worker sleeps waiting for a dependency
+#define BOOT_HELPER_STACK 6144
+#define BOOT_HELPER_PRIORITY 2
+#define BOOT_PRIORITY 2      ///< Priority of setup() while it works, above the tasks it creates
+
+#define BOOT_BIT(stage) (1UL << (stage))  ///< Dependency mask bit of a stage
+
+//========= CLAIM RESULTS =========
+#define BOOT_WAIT -1  ///< Stages remain, but none can start on this worker yet
+#define BOOT_DONE -2  ///< Every stage has finished
+
+/** @brief Stage states. */
+typedef enum {
+  BOOT_PENDING = 0,  ///< Waiting for its dependencies
+  BOOT_RUNNING,      ///< Claimed by a worker
+  BOOT_READY,        ///< Init succeeded
+  BOOT_FAILED,       ///< Init returned false
+  BOOT_SKIPPED       ///< A stage it needs failed or was skipped
+} bootState_t;
+
+/** @brief Stage init function; returns false if the peripheral did not come up. */
+typedef bool (*bootFn_t)(void);
+
+/**
+ * @brief One boot stage. Dependencies may only name earlier stages, so the
+ * table is its own topological order and cannot contain a cycle.
+ */
+typedef struct {
+  const char* name;
+  bootFn_t run;
+  uint32_t needs;  ///< Stages that must be ready (`BOOT_BIT()` mask)
+  uint32_t after;  ///< Stages that must have finished, any outcome
+  uint8_t core;    ///< Core that must run it, or `BOOT_ANY_CORE`
+  bool critical;   ///< Part of the door-usable path
+} bootStage_t;
+
+/**
+ * @brief Progress and timing of one boot.
+ */
+typedef struct {
+  const bootStage_t* stages;
+  uint8_t count;
+  uint8_t left;                          ///< Stages not finished
+  uint8_t criticalLeft;                  ///< Critical stages not finished
+  uint32_t finished;                     ///< Mask of finished stages
+  uint32_t broken;                       ///< Mask of failed or skipped stages
+  uint8_t state[BOOT_MAX_STAGES];        ///< ::bootState_t
+  uint8_t core[BOOT_MAX_STAGES];         ///< Worker that ran the stage
+  uint32_t startUs[BOOT_MAX_STAGES];     ///< Claimed
+  uint32_t readyUs[BOOT_MAX_STAGES];     ///< Finished (or skipped)
+  uint32_t doorReadyUs;                  ///< Last critical stage finished
+  uint32_t doneUs;                       ///< Last stage finished
+} bootPlan_t;
+
+//======================= API =======================//
+bool bootPlanInit(bootPlan_t* b, const bootStage_t* stages, uint8_t count, char* err, size_t errLen);
+int bootClaim(bootPlan_t* b, uint8_t core, uint32_t nowUs);
+void bootFinish(bootPlan_t* b, int stage, bool ok, uint32_t nowUs);
+bool bootDegraded(const bootPlan_t* b);
+const char* bootStateName(uint8_t state);
+
+#ifdef ARDUINO
+void bootRun(bootPlan_t* b);
+void bootPrintReport(const bootPlan_t* b);
+#endif
+
+#endif
@@ -0,0 +1,229 @@
+/**
+ * @file console.cpp
+ * @brief Serial command console implementation.
+ *
+ * @details
+ * Input is polled every `CONSOLE_POLL_MS`; `\r`, `\n` or `\r\n` end a line and
+ * overlong lines are discarded. Handlers run on the console task, so they may
+ * print and block without affecting the sensor or RFID paths. The console is
+ * the only writer of the runtime configuration.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+#include "console.h"
+#include "global_defs.h"
+#include "profiler.h"
+#include "i2c_bus.h"
+#include "runtime_config.h"
+#include "rfid_power.h"
+#include "boot.h"
+
+//========= COMMAND HANDLERS =========
+static void cmdHelp(const char* args);
+
+/**
+ * @brief `stats [ms]`: prints a profiler report, or sets the report period.
+ */
+static void cmdStats(const char* args) {
+  if (*args) {
+    profilerPeriodMs = strtoul(args, NULL, 10);
+    Serial.printf("Profiler period: %lu ms\n", (unsigned long)profilerPeriodMs);
+  }
+  profilerRequestReport();
+}
+
+/**
+ * @brief `i2c`: prints I2C bus manager statistics.
+ */
+static void cmdI2c(const char* args) {
+  i2cBusPrintStats();
+}
+
+/**
+ * @brief `rfid`: prints RFID reader power state, SPI load and wake latency.
+ */
+static void cmdRfid(const char* args) {
+  rfidPower_t snapshot;
+  portENTER_CRITICAL(&rfidPowerMux);
+  snapshot = rfidPower;
+  portEXIT_CRITICAL(&rfidPowerMux);
+  rfidPowerPrintStats(&snapshot);
+}
+
+/**
+ * @brief `boot`: prints the time-to-ready of every boot stage.
+ */
+static void cmdBoot(const char* args) {
+  bootPrintReport(&bootPlan);
+}
+
+/**
+ * @brief Copies the current runtime configuration (the console is not a hot path).
+ */
+static uint32_t configSnapshot(doorConfig_t* out) {
+  return cfgRead(&runtimeConfig, [&](const doorConfig_t& c) { *out = c; });
+}
+
+/**
+ * @brief Prints one configuration field.
+ */
+static void printField(const doorConfig_t* cfg, const cfgField_t* f) {
+  Serial.printf("  %-18s %g %s\n", f->name, cfgGetField(cfg, f), f->unit);
+}
+
+/**
+ * @brief `get [name]`: prints the runtime configuration or one field of it.
+ */
+static void cmdGet(const char* args) {
+  doorConfig_t cfg;
+  uint32_t version = configSnapshot(&cfg);
+  if (*args) {
+    const cfgField_t* f = cfgFindField(args);
+    if (!f) {
+      Serial.printf("Unknown field: %s\n", args);
+      return;
+    }
+    printField(&cfg, f);
+    return;
+  }
+  Serial.printf("Config version %lu:\n", (unsigned long)version);
+  for (int i = 0; i < cfgNumFields; i++) printField(&cfg, &cfgFields[i]);
+}
+
+/**
+ * @brief `set <name> <value>`: validates and publishes one field.
+ */
+static void cmdSet(const char* args) {
+  char name[24];
+  const char* value = strchr(args, ' ');
+  size_t len = value ? (size_t)(value - args) : 0;
+  if (!value || len >= sizeof(name)) {
+    Serial.println("Usage: set <name> <value>");
+    return;
+  }
+  memcpy(name, args, len);
+  name[len] = '\0';
+  while (*value == ' ') value++;
+
+  const cfgField_t* f = cfgFindField(name);
+  if (!f) {
+    Serial.printf("Unknown field: %s\n", name);
+    return;
+  }
+  doorConfig_t cfg;
+  configSnapshot(&cfg);
+  char err[64];
+  if (!cfgSetField(&cfg, f, value, err, sizeof(err)) || !cfgValidate(&cfg, err, sizeof(err))) {
+    Serial.printf("Rejected: %s\n", err);
+    return;
+  }
+  cfgPublish(&runtimeConfig, &cfg);
+  Serial.printf("%s = %g %s (version %lu, not saved)\n", f->name, cfgGetField(&cfg, f), f->unit,
+                (unsigned long)cfgVersion(&runtimeConfig));
+}
+
+/**
+ * @brief `save`: persists the current configuration to NVS.
+ */
+static void cmdSave(const char* args) {
+  doorConfig_t cfg;
+  configSnapshot(&cfg);
+  Serial.println(cfgSave(&cfg) ? "Config saved" : "ERROR: failed to save config");
+}
+
+/**
+ * @brief `defaults`: publishes the compiled-in defaults without saving them.
+ */
+static void cmdDefaults(const char* args) {
+  doorConfig_t cfg;
+  cfgDefaults(&cfg);
+  cfgPublish(&runtimeConfig, &cfg);
+  Serial.println("Defaults restored (not saved)");
+}
+
+static const consoleCommand_t commands[] = {
+  { "help", cmdHelp, "list commands" },
+  { "stats", cmdStats, "stats [period_ms] - CPU profiler report / report period" },
+  { "i2c", cmdI2c, "I2C bus occupancy and queue waits" },
+  { "rfid", cmdRfid, "RFID reader power state, SPI commands and wake latency" },
+  { "boot", cmdBoot, "boot stages, time-to-ready and failures" },
+  { "get", cmdGet, "get [name] - show runtime config" },
+  { "set", cmdSet, "set <name> <value> - change a runtime config field" },
+  { "save", cmdSave, "persist runtime config to NVS" },
+  { "defaults", cmdDefaults, "restore compiled-in config defaults" },
+};
+static const int numCommands = sizeof(commands) / sizeof(commands[0]);
+
+/**
+ * @brief `help`: lists all commands.
+ */
+static void cmdHelp(const char* args) {
+  for (int i = 0; i < numCommands; i++) {
+    Serial.printf("  %-8s %s\n", commands[i].name, commands[i].help);
+  }
+}
+
+//========= HELPERS =========
+
+/**
+ * @brief Splits a line into command word and arguments and runs the handler.
+ */
+static void dispatch(char* line) {
+  while (*line == ' ') line++;
+  if (!*line) return;
+
+  char* args = strchr(line, ' ');
+  if (args) {
+    *args++ = '\0';
+    while (*args == ' ') args++;
+  } else {
+    args = line + strlen(line);
+  }
+
+  for (int i = 0; i < numCommands; i++) {
+    if (strcmp(line, commands[i].name) == 0) {
+      commands[i].handler(args);
+      return;
+    }
+  }
+  Serial.printf("Unknown command: %s (try 'help')\n", line);
+}
+
+//========= TASK =========
+
+/**
+ * @brief Reads command lines from Serial and dispatches them.
+ * @param pvParameters Unused
+ */
+void consoleTask(void* pvParameters) {
+  char line[CONSOLE_LINE_MAX];
+  size_t len = 0;
+  bool overflow = false;
+
+  while (1) {
+    profTaskWake();
+    while (Serial.available() > 0) {
+      char c = (char)Serial.read();
+      if (c == '\r' || c == '\n') {
+        if (!overflow && len > 0) {
+          line[len] = '\0';
+          dispatch(line);
+        }
+        len = 0;
+        overflow = false;
+      } else if (len < sizeof(line) - 1) {
+        line[len++] = c;
+      } else {
+        overflow = true;
+      }
+    }
+    vTaskDelay(pdMS_TO_TICKS(CONSOLE_POLL_MS));
+  }
+}
@@ -0,0 +1,51 @@
+/**
+ * @file console.h
+ * @brief Line-based serial command console.
+ *
+ * @details
+ * `consoleTask` collects characters from `Serial` into lines and dispatches
+ * the first word to a handler from a static command table. Commands:
+ * - `help`            list commands
+ * - `stats`           print a profiler report now
+ * - `stats <ms>`      set the profiler report period (0 = on command only)
+ * - `i2c`             print I2C bus manager statistics
+ * - `rfid`            print RFID reader power and SPI statistics
+ * - `get [name]`      print the runtime configuration (or one field)
+ * - `set <name> <v>`  validate and publish one configuration field
+ * - `save`            persist the current configuration to NVS
+ * - `defaults`        publish the compiled-in defaults (not saved)
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <Arduino.h>
+
+//========= CONFIGURATION =========
+#define CONSOLE_LINE_MAX 64      ///< Longest accepted command line
+#define CONSOLE_POLL_MS 50       ///< Serial polling period
+
+/**
+ * @brief Command handler.
+ * @param args Text after the command word (never NULL, may be empty)
+ */
+typedef void (*consoleHandler_t)(const char* args);
+
+/**
+ * @brief Entry of the command table.
+ */
+typedef struct {
+  const char* name;          ///< Command word
+  consoleHandler_t handler;  ///< Called with the remaining arguments
+  const char* help;          ///< One-line description
+} consoleCommand_t;
+
+//======================= TASK PROTOTYPES =======================//
+void consoleTask(void* pvParameters);
+
+#endif
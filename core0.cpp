@@ -8,9 +8,9 @@
  * mechanical control (servo motor for locking), user interface (LCD display), and 
  * motion-based interactions (PIR motion sensor).
  * 
- * Key system features such as synchronized access to shared I2C devices, servo locking 
- * behavior, and timed backlight control are managed in this file using semaphores, 
- * software timers, and critical sections. 
+ * Key system features such as servo locking behavior and timed backlight control are
+ * managed in this file using task notifications, software timers, and critical sections.
+ * Shared I2C devices are accessed through the I2C bus manager task. 
  * 
  * The design allows responsive, concurrent behavior on a real-time operating system 
  * while reducing blocking and minimizing unnecessary I2C conflicts.
@@ -22,7 +22,7 @@
  * - **updateButtonTask**: (debug) Provides manual override using a push button.
  *
  * @section concurrency Concurrency & Resources
- * - Uses semaphores (`i2c_semaphore`) to manage access to RTC and LCD on the I2C bus.
+ * - Reaches the RTC and LCD only through the I2C bus manager (`i2c_bus.h`).
  * - Uses `esp_timer` to control servo locking delay and LCD backlight timeout.
  * - Employs critical sections with `portMUX_TYPE` for ISR-safe timer flag updates.
  *
@@ -45,6 +45,11 @@
 #include <LiquidCrystal_I2C.h>
 #include "driver/timer.h"
 #include "global_defs.h"
+#include "telemetry.h"
+#include "i2c_bus.h"
+#include "profiler.h"
+#include "correlator.h"
+#include "runtime_config.h"
 
 //========= GLOBAL VARIABLES =========
 portMUX_TYPE timerMux = portMUX_INITIALIZER_UNLOCKED;
@@ -64,10 +69,12 @@ void LCDTask(void* arg);
  * @note Name: onLockTimer
  */
 void IRAM_ATTR onLockTimer(void* arg) {
+  PROF_ISR_BEGIN();
   portENTER_CRITICAL_ISR(&timerMux);
   isLock = true;
   xTaskNotifyGive(TaskServoRun_Handle);
   portEXIT_CRITICAL_ISR(&timerMux);
+  PROF_ISR_END(PROF_ISR_LOCK_TIMER);
 }
 
 /**
@@ -76,42 +83,37 @@ void IRAM_ATTR onLockTimer(void* arg) {
  * @note Name: onBacklightTimer
  */
 void IRAM_ATTR onBacklightTimer(void* arg) {
+  PROF_ISR_BEGIN();
   portENTER_CRITICAL_ISR(&timerMux);
   backlightOn = false;
   portEXIT_CRITICAL_ISR(&timerMux);
+  PROF_ISR_END(PROF_ISR_BACKLIGHT_TIMER);
 }
 
 //========= TASK DEFINITIONS =========
 /**
  * @brief Servo motor controller for lock mechanism
  * @details Waits on notification to engage/disengage lock and logs timestamp.
- *          Uses I2C to read RTC and control PWM via ESP32Servo.
+ *          Reads the RTC through the I2C bus manager and controls PWM via ESP32Servo.
  * @note Name: ServoRunTask
  */
 void ServoRunTask(void* arg) {
   while (1) {
     // Wait for a notification to update servo position
     ulTaskNotifyTake(pdTRUE, portMAX_DELAY);  // clears notification
+    profTaskWake();
 
     if (isLock) {
       myservo.write(180);
-      if (xSemaphoreTake(i2c_semaphore, pdMS_TO_TICKS(50)) == pdTRUE) {
-        DateTime now = rtc.now();
-        Serial.printf("Time: %02d:%02d:%02d\n", now.hour(), now.minute(), now.second());
-        xSemaphoreGive(i2c_semaphore);
-      } else {
-        Serial.println("RTC I2C timeout");
-      }
+      telemetryLockState(true, 180);
+      corrPost(CORR_LOCKED);
+      logTimestamp();
       Serial.println("Servo locked");
     } else {
       myservo.write(0);
-      if (xSemaphoreTake(i2c_semaphore, pdMS_TO_TICKS(50)) == pdTRUE) {
-        DateTime now = rtc.now();
-        Serial.printf("Time: %02d:%02d:%02d\n", now.hour(), now.minute(), now.second());
-        xSemaphoreGive(i2c_semaphore);
-      } else {
-        Serial.println("RTC I2C timeout");
-      }
+      telemetryLockState(false, 0);
+      corrPost(CORR_UNLOCKED);
+      logTimestamp();
       Serial.println("Servo unlocked");
     }
   }
@@ -119,42 +121,29 @@ void ServoRunTask(void* arg) {
 
 /**
  * @brief LCD display manager for lock and detection state
- * @details Updates LCD lines if state changes. Manages backlight state.
- *          Synchronizes I2C access using semaphore.
+ * @details Queues LCD field and backlight updates to the I2C bus manager when
+ *          the state changes. Never blocks on the bus; an update that cannot be
+ *          queued is retried on the next cycle.
  * @note Name: LCDTask
  */
 void LCDTask(void* arg) {
-  TickType_t xLastWakeTime = xTaskGetTickCount();
   String prevLine0 = "", prevLine1 = "";
+  int prevBacklight = -1;
 
   while (1) {
+    profTaskWake();
     String line0 = (close_dist || motion_detected) ? "Detected" : "None";
     String line1 = isLock ? "Locked" : "Unlocked";
 
-    if (xSemaphoreTake(i2c_semaphore, pdMS_TO_TICKS(50)) == pdTRUE) {
-      if (line0 != prevLine0) {
-        lcd.setCursor(8, 0);
-        lcd.print("        ");
-        lcd.setCursor(8, 0);
-        lcd.print(line0);
-        prevLine0 = line0;
-      }
-
-      if (line1 != prevLine1) {
-        lcd.setCursor(8, 1);
-        lcd.print("        ");
-        lcd.setCursor(8, 1);
-        lcd.print(line1);
-        prevLine1 = line1;
-      }
-      // Backlight control
-      if (backlightOn) {
-        lcd.backlight();
-      } else {
-        lcd.noBacklight();
-      }
-
-      xSemaphoreGive(i2c_semaphore);
+    if (line0 != prevLine0 && i2cBusLcdText(0, 8, 8, line0.c_str())) {
+      prevLine0 = line0;
+    }
+    if (line1 != prevLine1 && i2cBusLcdText(1, 8, 8, line1.c_str())) {
+      prevLine1 = line1;
+    }
+    // Backlight control
+    if ((int)backlightOn != prevBacklight && i2cBusLcdBacklight(backlightOn)) {
+      prevBacklight = backlightOn;
     }
 
     vTaskDelay(pdMS_TO_TICKS(31.25));
@@ -174,7 +163,9 @@ void updateButtonTask(void* arg) {
     lastDebounceTime = millis();
   }
 
-  if ((millis() - lastDebounceTime) > debounceDelay) {
+  uint32_t debounceMs = 0;
+  cfgRead(&runtimeConfig, [&](const doorConfig_t& c) { debounceMs = c.debounceMs; });
+  if ((millis() - lastDebounceTime) > debounceMs) {
     if (currentReading != buttonState) {
       if (buttonState == LOW && currentReading == HIGH) {
         isLock = !isLock;
@@ -226,13 +217,7 @@ void motionTask(void* pvParameters) {
 
     if (sum > 2) {
       motion_detected = true;
-      if (xSemaphoreTake(i2c_semaphore, pdMS_TO_TICKS(50)) == pdTRUE) {
-        DateTime now = rtc.now();
-        Serial.printf("Time: %02d:%02d:%02d\n", now.hour(), now.minute(), now.second());
-        xSemaphoreGive(i2c_semaphore);
-      } else {
-        Serial.println("RTC I2C timeout");
-      }
+      logTimestamp();
       if (!backlightOn) {
         backlightOn = true;
         Serial.println("Backlight ON (motion)");
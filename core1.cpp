@@ -9,16 +9,24 @@
  *
  * Core responsibilities:
  * - **sensorReadTask**: Collects ultrasonic and PIR sensor data at 50Hz and sends it via queue.
- * - **sensorProcessTask**: Aggregates sensor readings into buffers, determines detection events, and handles the backlight.
- * - **taskRFIDReader**: Reads RFID tag UIDs and passes them into a queue for validation.
- * - **taskPrinter**: Validates UID access, logs attempts, controls lock state, and manages LCD backlight timers.
+ * - **sensorProcessTask**: Aggregates sensor readings into buffers, determines detection events, tracks approaches, and handles the backlight.
+ * - **taskRFIDReader**: Inventories every RFID tag in the field and passes the UIDs into a queue as one batch.
+ * - **taskPrinter**: Validates UID access with one decision per inventory pass, logs attempts, controls lock state,
+ *   and manages LCD backlight timers.
  * - **distanceTask**: (Debug) Continuously samples Ultrasonic sensor data and triggers UI updates and timers.
  * 
  * @section Features
  * - Real-time sensor polling with timing guarantees using `vTaskDelayUntil`.
  * - Queue-based communication between reader and processor tasks.
  * - Uses ESP32's `esp_timer` library for one-shot timers to control lock duration and backlight timeout.
- * - Incorporates I²C semaphore protection for safe RTC access.
+ * - Reads the RTC through the I²C bus manager (`i2c_bus.h`) instead of locking the bus.
+ * - Publishes presence edges (with hysteresis, `presence.h`), presence summaries and access decisions
+ *   on the binary telemetry stream.
+ * - Runs the streaming time-of-day anomaly detector (`anomaly.h`) on every sample and scan.
+ * - Authorizes scans against per-credential access schedules compiled at boot (`access_schedule.h`).
+ * - Posts presence edges and access decisions to the event correlator (`correlator.h`).
+ * - Tracks approaching people (`approach.h`) to wake the backlight and speed up RFID polling ahead of arrival.
+ * - Powers the RFID reader down while nobody is around (`rfid_power.h`).
  *
  * @section Authors
  * Created by Sanjay Varghese, 2025  
@@ -33,6 +41,62 @@
 #include <string>
 #include "core1.h"
 #include "global_defs.h"
+#include "telemetry.h"
+#include "anomaly.h"
+#include "i2c_bus.h"
+#include "rfid_inventory.h"
+#include "profiler.h"
+#include "door_logic.h"
+#include "access_schedule.h"
+#include "correlator.h"
+#include "runtime_config.h"
+#include "approach.h"
+#include "rfid_power.h"
+#include "presence.h"
+
+//========= ANOMALY DETECTOR =========
+static anomalyDetector_t anomalyDet;                            ///< Shared by sensorProcessTask and taskPrinter
+static portMUX_TYPE anomalyMux = portMUX_INITIALIZER_UNLOCKED;  ///< Guards anomalyDet
+
+/**
+ * @brief Logs and publishes anomalies raised by the detector.
+ * @param events Bitmask of `ANOMALY_*` flags
+ * @param bucket Time-of-day bucket
+ * @param dwellMs Current presence dwell
+ */
+static void reportAnomaly(uint8_t events, uint8_t bucket, uint32_t dwellMs) {
+  if (events & ANOMALY_LOITERING) {
+    Serial.printf("Anomaly: loitering (%lu s without a scan)\n", (unsigned long)(dwellMs / 1000));
+  }
+  if (events & ANOMALY_DENIAL_BURST) {
+    Serial.println("Anomaly: repeated denied scans");
+  }
+  if (events & ANOMALY_HIGH_ACTIVITY) {
+    Serial.println("Anomaly: unusually high motion activity");
+  }
+  telemetryAnomaly(events, bucket, dwellMs);
+}
+
+/**
+ * @brief Saves the anomaly baselines to NVS when `sensorProcessTask` asks for it.
+ *
+ * @details Runs below every other task: the flash write takes tens of
+ * milliseconds, longer than a sample period. The baselines are copied under
+ * the detector lock and written from the copy.
+ *
+ * @param pvParameters Unused
+ */
+void anomalySaveTask(void* pvParameters) {
+  static anomalyDetector_t snapshot;
+  while (1) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    profTaskWake();
+    portENTER_CRITICAL(&anomalyMux);
+    memcpy(snapshot.buckets, anomalyDet.buckets, sizeof(snapshot.buckets));
+    portEXIT_CRITICAL(&anomalyMux);
+    if (!anomalySaveBaseline(&snapshot)) Serial.println("Anomaly: failed to save baselines");
+  }
+}
 
 //========= TASKS =========
 
@@ -43,9 +107,12 @@
  * On rising edge, resets the timer counter to begin measuring the echo.
  * On falling edge, captures the time from the hardware timer and notifies
  * the sensor reading task using FreeRTOS ISR-safe notification API.
+ * Time spent in the ISR is accounted by the profiler.
  */
 void IRAM_ATTR echoISR() {
+  PROF_ISR_BEGIN();
   uint64_t t;
+  BaseType_t woken = pdFALSE;
   if (digitalRead(ECHO_PIN)) {
     // rising edge → start timing
     echo_start_us = 0;
@@ -55,17 +122,17 @@ void IRAM_ATTR echoISR() {
     timer_get_counter_value(TIMER_GROUP_0, TIMER_0, &t);
     echo_end_us = t;
 
-    BaseType_t woken = pdFALSE;
     vTaskNotifyGiveFromISR(taskSensorRead_Handle, &woken);
-    portYIELD_FROM_ISR();
   }
+  PROF_ISR_END(PROF_ISR_ECHO);
+  if (woken) portYIELD_FROM_ISR();
 }
 
 /**
  * @brief Periodically triggers ultrasonic distance measurements and reads PIR sensor state.
  *
  * @details 
- * - Triggered every 20ms (50Hz).
+ * - Triggered every `sample_ms` (runtime config, 20 ms / 50 Hz by default).
  * - Sends sensor readings (`sensorData_t`) to `sensorQueue`.
  * - Uses task notifications for echo pulse timing instead of `pulseIn()`.
  *
@@ -75,7 +142,14 @@ void sensorReadTask(void* pvParameters) {
   sensorData_t data;
   TickType_t xLastWakeTime;
   xLastWakeTime = xTaskGetTickCount();
+  uint32_t cfgSeen = UINT32_MAX;
+  TickType_t period = pdMS_TO_TICKS(DOOR_SAMPLE_MS);
   while (1) {
+    profTaskWake();
+    if (cfgVersion(&runtimeConfig) != cfgSeen) {
+      cfgSeen = cfgRead(&runtimeConfig, [&](const doorConfig_t& c) { period = pdMS_TO_TICKS(c.samplePeriodMs); });
+    }
+
     // — Ultrasonic trigger pulse —
     digitalWrite(TRIG_PIN, LOW);
     delayMicroseconds(2);
@@ -103,8 +177,8 @@ void sensorReadTask(void* pvParameters) {
     // — Send both readings to processing task —
     xQueueSend(sensorQueue, &data, portMAX_DELAY);
 
-    // — pace readings at 20 ms intervals — 50Hz
-    vTaskDelayUntil(&xLastWakeTime, pdMS_TO_TICKS(20));
+    // — pace readings at the configured interval (20 ms / 50Hz by default) —
+    vTaskDelayUntil(&xLastWakeTime, period);
   }
 }
 
@@ -112,189 +186,366 @@ void sensorReadTask(void* pvParameters) {
  * @brief Processes buffered sensor readings and triggers appropriate system behavior.
  *
  * @details
- * - Computes rolling average of distance and motion buffer.
+ * - Computes rolling sums of the distance and motion window (`doorSensorUpdate`),
+ *   with thresholds re-derived from the runtime config only when its version changes.
  * - Determines `close_dist` and `motion_detected` flags.
- * - Turns on LCD backlight on detection and logs event using RTC with semaphore.
+ * - Debounces them into presence start / end events (`presence.h`); only the
+ *   edges log (the start with an RTC timestamp via the I2C bus manager) and
+ *   publish telemetry, the end with a summary of the whole presence.
+ * - Turns on LCD backlight on detection.
+ * - Runs the approach tracker; on a predicted arrival it turns the backlight on
+ *   early and wakes `taskRFIDReader` onto its fast poll period.
+ * - Feeds every sample to the anomaly detector once the RTC hour used for its
+ *   time-of-day buckets is known; the hour is refreshed once per PIR duty
+ *   window, and `anomalySaveTask` is woken to save the baselines whenever the
+ *   bucket changes.
  *
  * @param pvParameters Unused
  */
 void sensorProcessTask(void* pvParameters) {
   sensorData_t d;
+  doorSensorState_t sensorWindow;
+  presenceTracker_t presence;
+  uint8_t hour = 0;
+  bool hourValid = false;
+  uint16_t hourRefresh = 0;
+  uint32_t cfgSeen = UINT32_MAX;
+  float closeSumCm = DOOR_CLOSE_SUM_CM;
+  uint32_t motionVotes = DOOR_MOTION_VOTES;
+  uint64_t backlightUs = DOOR_BACKLIGHT_US;
+  uint32_t sampleMs = DOOR_SAMPLE_MS;
+  uint32_t leadMs = APPROACH_LEAD_MS;
+  approachTracker_t tracker;
+
+  doorSensorInit(&sensorWindow);
+  presenceInit(&presence);
+  approachInit(&tracker);
+  anomalyInit(&anomalyDet);
+  if (anomalyLoadBaseline(&anomalyDet)) {
+    Serial.println("Anomaly baselines restored");
+  }
+
   while (1) {
     if (xQueueReceive(sensorQueue, &d, portMAX_DELAY) == pdTRUE) {
-      // 1) update circular buffers
-      distanceBuffer[idx_dist] = d.distanceCm;
-      idx_dist = (idx_dist + 1) % 5;
-
-      motionBuffer[idx_motion] = (d.motionState == HIGH);
-      idx_motion = (idx_motion + 1) % 5;
-
-      // 2) compute sums
-      float sumDist = 0;
-      int sumMotion = 0;
-      // Serial.print("Distances: [");
-      for (int i = 0; i < 5; i++) {
-        // Serial.print(distanceBuffer[i], 2);
-        // if (i < 4) Serial.print(", ");
-        sumDist += distanceBuffer[i];
-      }
-      // Serial.print("]  Motion: [");
-      for (int i = 0; i < 5; i++) {
-        // Serial.print(motionBuffer[i]);
-        // if (i < 4) Serial.print(", ");
-        sumMotion += motionBuffer[i];
+      profTaskWake();
+      if (cfgVersion(&runtimeConfig) != cfgSeen) {
+        cfgSeen = cfgRead(&runtimeConfig, [&](const doorConfig_t& c) {
+          closeSumCm = c.closeSumCm;
+          motionVotes = c.motionVotes;
+          backlightUs = (uint64_t)c.backlightMs * 1000ULL;
+          sampleMs = c.samplePeriodMs;
+          leadMs = c.approachLeadMs;
+        });
       }
-      // Serial.println("]");
 
-      // 3) proximity logic
-      if (sumDist < 90.0f && sumDist > 0.0f) {
-        close_dist = true;
-      } else {
-        close_dist = false;
+      // 0) keep the time-of-day bucket current without touching I2C every sample;
+      //    until the RTC has answered once, retry every second
+      if (hourRefresh == 0) {
+        rtcTime_t now;
+        if (i2cBusRtcNow(&now)) {
+          uint8_t newHour = now.hour;
+          if (hourValid && anomalyBucketForHour(newHour) != anomalyBucketForHour(hour) && TaskAnomalySave_Handle) {
+            xTaskNotifyGive(TaskAnomalySave_Handle);  // NVS write, off this task
+          }
+          hour = newHour;
+          hourValid = true;
+        } else if (!hourValid) {
+          hourRefresh = ANOMALY_DUTY_WINDOW - 1000 / sampleMs;
+        }
       }
-
-      // 4) motion logic
-      if (sumMotion > 2) {
-        motion_detected = true;
-      } else {
-        motion_detected = false;
+      hourRefresh = (hourRefresh + 1) % ANOMALY_DUTY_WINDOW;
+
+      // 1-4) rolling window, proximity and motion decisions
+      bool closeNow, motionNow;
+      doorSensorUpdate(&sensorWindow, d.distanceCm, d.motionState == HIGH, closeSumCm, motionVotes,
+                       &closeNow, &motionNow);
+      close_dist = closeNow;
+      motion_detected = motionNow;
+
+      // 5) telemetry: raw sample (if streaming); presence edges and, when it ends, its summary.
+      //    Samples in between do no I/O.
+      uint32_t nowMs = millis();
+      uint16_t distanceMm = (uint16_t)(d.distanceCm * 10.0f + 0.5f);
+      telemetrySensorSample(d.distanceCm, d.motionState, close_dist, motion_detected);
+      presenceSummary_t summary;
+      uint8_t edges = presenceUpdate(&presence, nowMs, distanceMm, close_dist, motion_detected, &summary);
+      if (edges & PRESENCE_STARTED) {
+        telemetryDetectionEdge(true, close_dist, motion_detected);
+        corrPost(CORR_PRESENCE_START);
+        if (taskRFIDReader_Handle) xTaskNotifyGive(taskRFIDReader_Handle);  // wake the reader if it is asleep
+        logTimestamp();
+        Serial.println(close_dist ? "Distance" : "Motion");
+      } else if (edges & PRESENCE_ENDED) {
+        telemetryDetectionEdge(false, close_dist, motion_detected);
+        telemetryPresence(summary.startMs, summary.durationMs, summary.samples, summary.minMm, summary.meanMm);
+        corrPost(CORR_PRESENCE_END);
+        Serial.printf("Presence ended: %lu ms, %lu samples, min %u.%u cm, mean %u.%u cm\n",
+                      (unsigned long)summary.durationMs, (unsigned long)summary.samples,
+                      summary.minMm / 10, summary.minMm % 10, summary.meanMm / 10, summary.meanMm % 10);
       }
-
-      // 5) backlight handling
-      if (close_dist || motion_detected) {
-        
-        if (xSemaphoreTake(i2c_semaphore, pdMS_TO_TICKS(50)) == pdTRUE) {
-          DateTime now = rtc.now();
-          Serial.printf("Time: %02d:%02d:%02d\n",
-                        now.hour(), now.minute(), now.second());
-          Serial.println(close_dist ? "Distance" : "Motion");
-          xSemaphoreGive(i2c_semaphore);
-        }
+      bool present = presenceActive(&presence);
+
+      // 5b) approach tracking: wake the display and the RFID reader ahead of arrival
+      uint8_t approach = approachUpdate(&tracker, distanceMm, sampleMs, leadMs);
+      if (approach & APPROACH_WAKE) {
+        approach_wake = true;
+        Serial.printf("Approach: %ld cm at %ld cm/s, arriving in %lu ms\n",
+                      (long)(approachDistanceMm(&tracker) / 10), (long)(-approachVelocityMms(&tracker) / 10),
+                      (unsigned long)tracker.ttaMs);
+        if (taskRFIDReader_Handle) xTaskNotifyGive(taskRFIDReader_Handle);
         if (!backlightOn) {
           backlightOn = true;
-          Serial.println("Backlight ON (sensor process )");
+          Serial.println("Backlight ON (approach)");
           esp_timer_stop(backlightTimer);
-          esp_timer_start_once(backlightTimer, 10 * 1000 * 1000);  // 10 s
+          esp_timer_start_once(backlightTimer, backlightUs);
         }
+      } else if (approach & APPROACH_RELEASED) {
+        approach_wake = false;
+      }
+
+      // 6) anomaly detection; without a valid hour the sample would be learned into the wrong bucket
+      if (hourValid) {
+        portENTER_CRITICAL(&anomalyMux);
+        uint8_t events = anomalyOnSample(&anomalyDet, nowMs, hour, d.distanceCm,
+                                         d.motionState == HIGH, present);
+        uint32_t dwellMs = anomalyPresenceMs(&anomalyDet, nowMs);
+        portEXIT_CRITICAL(&anomalyMux);
+        if (events) reportAnomaly(events, anomalyBucketForHour(hour), dwellMs);
+      }
+
+      // 7) backlight handling
+      if ((close_dist || motion_detected) && !backlightOn) {
+        backlightOn = true;
+        Serial.println("Backlight ON (sensor process )");
+        esp_timer_stop(backlightTimer);
+        esp_timer_start_once(backlightTimer, backlightUs);
       }
     }
   }
 }
 
 /**
- * @brief Polls the RFID reader for new tag UIDs and sends them to `rfidQueue`.
+ * @brief Runs an inventory pass on the RFID reader and sends all UIDs found to `rfidQueue`.
  *
  * @details
- * - Checks for new cards using MFRC522 interface.
- * - Extracts and formats UID into a string and sends to queue.
- * - Ensures card halting and crypto session termination.
+ * - Enumerates every card in the field with the ISO 14443A anticollision loop
+ *   (`rfidInventory`), halting each card as it is read.
+ * - Sends all UIDs of the pass as one `rfidBatch_t`, together with the pass duration.
+ * - Ensures crypto session termination.
+ * - Polls every `rfid_fast_poll_ms` while someone approaches or is present and
+ *   every `rfid_poll_ms` during the `rfid_holdoff_ms` after they left; after
+ *   that the antenna is switched off, the reader put into soft power-down and
+ *   no SPI traffic is generated (`rfid_power.h`).
+ * - Presence edges and approach wakes notify the task, which powers the reader
+ *   up and polls at once; the power-up time is recorded as wake-to-ready latency.
  *
  * @param pvParameters Unused
  */
 void taskRFIDReader(void* pvParameters) {
+  rfidBatch_t batch;
+  uint32_t cfgSeen = UINT32_MAX;
+  TickType_t pollTicks = pdMS_TO_TICKS(DOOR_RFID_POLL_MS);
+  TickType_t fastPollTicks = pdMS_TO_TICKS(DOOR_RFID_FAST_POLL_MS);
+  uint32_t holdoffMs = RFID_HOLDOFF_MS;
+  portENTER_CRITICAL(&rfidPowerMux);
+  rfidPowerInit(&rfidPower, millis());
+  portEXIT_CRITICAL(&rfidPowerMux);
   while (1) {
-    if (rfid.PICC_IsNewCardPresent() && rfid.PICC_ReadCardSerial()) {
-      char uidStr[20];
-      snprintf(uidStr, sizeof(uidStr), "%02X %02X %02X %02X",
-               rfid.uid.uidByte[0], rfid.uid.uidByte[1],
-               rfid.uid.uidByte[2], rfid.uid.uidByte[3]);
-
-      // Always send UID to queue, regardless of change
-      if (xQueueSend(rfidQueue, &uidStr, pdMS_TO_TICKS(100)) != pdPASS) {
-        Serial.println("Queue full! Dropping tag.");
+    profTaskWake();
+    if (cfgVersion(&runtimeConfig) != cfgSeen) {
+      cfgSeen = cfgRead(&runtimeConfig, [&](const doorConfig_t& c) {
+        pollTicks = pdMS_TO_TICKS(c.rfidPollMs);
+        fastPollTicks = pdMS_TO_TICKS(c.rfidFastPollMs);
+        holdoffMs = c.rfidHoldoffMs;
+      });
+    }
+
+    bool someoneThere = approach_wake || close_dist || motion_detected;
+    portENTER_CRITICAL(&rfidPowerMux);
+    rfidPowerAction_t action = rfidPowerUpdate(&rfidPower, someoneThere, millis(), holdoffMs);
+    portEXIT_CRITICAL(&rfidPowerMux);
+    switch (action) {
+      case RFID_PWR_SLEEP:
+        rfid.PCD_AntennaOff();
+        rfid.PCD_SoftPowerDown();
+        break;
+      case RFID_PWR_WAKE: {
+        int64_t wakeStart = esp_timer_get_time();
+        rfid.PCD_SoftPowerUp();  // returns once the oscillator is running again
+        rfid.PCD_AntennaOn();
+        uint32_t wakeUs = (uint32_t)(esp_timer_get_time() - wakeStart);
+        portENTER_CRITICAL(&rfidPowerMux);
+        rfidPowerWoke(&rfidPower, wakeUs);
+        portEXIT_CRITICAL(&rfidPowerMux);
+        break;
       }
+      default:
+        break;
+    }
 
-      rfid.PICC_HaltA();
-      rfid.PCD_StopCrypto1();
+    if (rfidPowerPolling(&rfidPower)) {
+      int64_t start = esp_timer_get_time();
+      uint8_t found = rfidInventory(rfid, &batch);
+      portENTER_CRITICAL(&rfidPowerMux);
+      rfidPowerPolled(&rfidPower, batch.commands);
+      portEXIT_CRITICAL(&rfidPowerMux);
+      if (found > 0) {
+        batch.cycleUs = (uint32_t)(esp_timer_get_time() - start);
+
+        // Always send UIDs to queue, regardless of change
+        if (xQueueSend(rfidQueue, &batch, pdMS_TO_TICKS(100)) != pdPASS) {
+          Serial.println("Queue full! Dropping tag.");
+        }
+      }
     }
 
-    vTaskDelay(pdMS_TO_TICKS(500));
+    // asleep: no SPI, just re-check the flags at the idle period in case a notification was missed
+    ulTaskNotifyTake(pdTRUE, someoneThere ? fastPollTicks : pollTicks);
   }
 }
 
 /**
- * @brief Processes UIDs from `rfidQueue` and manages access control.
+ * @brief Reads the RTC through the bus manager as an access schedule time.
+ * @return false if the RTC did not answer or its date is out of range
+ */
+static bool accessTimeNow(accessTime_t* out) {
+  rtcTime_t rtcNow;
+  return i2cBusRtcNow(&rtcNow) &&
+         accessTimeFromCalendar(&accessTable, rtcNow.year, rtcNow.month, rtcNow.day, rtcNow.hour, rtcNow.minute, out);
+}
+
+/**
+ * @brief Checks one card against the compiled access schedules.
+ * @details Without a clock (`now` NULL) only unrestricted badges pass.
+ */
+static accessResult_t checkTag(const rfidTag_t* tag, const accessTime_t* now) {
+  return accessCheck(&accessTable, accessKeyFromBytes(tag->bytes, tag->size), now);
+}
+
+/**
+ * @brief Applies one access decision for all cards of an inventory pass.
  *
  * @details
- * - Compares received UID to allowed list.
+ * - Checks every UID against the compiled access schedules (`accessCheck`)
+ *   and decides once for the pass via `doorBatchDecide`: a pass with any
+ *   admitted card acts for that card; only a pass with none is denied. The
+ *   other cards in the field are logged without acting on them.
  * - If authorized:
  *   - Unlocks system.
  *   - Notifies `ServoRunTask`.
  *   - Starts/reset lock and backlight timers.
- * - If unauthorized:
- *   - Logs timestamp and denies access.
+ * - If unauthorized (unknown, expired or outside its schedule):
+ *   - Logs timestamp and reason and denies access.
  * - Avoids redundant unlocks from repeated scans.
+ * - Reports the decision to the anomaly detector as one scan (repeated denials, scans ending loitering).
+ *
+ * @param batch   Cards read by one pass, at least one
+ * @param lastUID Last granted UID, updated in place (`RFID_UID_STR_LEN` bytes)
+ * @param now     Time of the pass, read once for all its cards; NULL if the RTC is unavailable
+ */
+static void processBatch(const rfidBatch_t* batch, char* lastUID, const accessTime_t* now) {
+  accessResult_t access[RFID_MAX_CARDS];
+  bool allowed[RFID_MAX_CARDS];
+  const char* uids[RFID_MAX_CARDS];
+  for (int i = 0; i < batch->count; i++) {
+    access[i] = checkTag(&batch->tags[i], now);
+    allowed[i] = access[i] == ACCESS_OK;
+    uids[i] = batch->tags[i].str;
+  }
+
+  uint8_t pick;
+  doorDecision_t decision = doorBatchDecide(lastUID, RFID_UID_STR_LEN, uids, allowed, batch->count, isLock, &pick);
+  const char* receivedUID = uids[pick];
+  bool isAllowed = allowed[pick];
+
+  uint64_t lockUs, backlightUs;
+  cfgRead(&runtimeConfig, [&](const doorConfig_t& c) {
+    lockUs = (uint64_t)c.lockMs * 1000ULL;
+    backlightUs = (uint64_t)c.backlightMs * 1000ULL;
+  });
+
+  // Feed the decision to the anomaly detector
+  uint32_t nowMs = millis();
+  portENTER_CRITICAL(&anomalyMux);
+  uint8_t events = anomalyOnScan(&anomalyDet, nowMs, isAllowed);
+  uint32_t dwellMs = anomalyPresenceMs(&anomalyDet, nowMs);
+  uint8_t bucket = anomalyDet.presenceBucket;
+  portEXIT_CRITICAL(&anomalyMux);
+  if (events) reportAnomaly(events, bucket, dwellMs);
+
+  switch (decision) {
+    case DOOR_GRANTED:
+      Serial.print("Access Granted. UID: ");
+      Serial.println(receivedUID);
+      isLock = false;
+      xTaskNotifyGive(TaskServoRun_Handle);
+      // Reset timer when RFID grants access
+      esp_timer_stop(lockTimer);
+      esp_timer_start_once(lockTimer, lockUs);
+
+      // Reset inactivity timer
+      if (!backlightOn) {
+        backlightOn = true;
+        Serial.println("Backlight ON (RFID update)");
+        esp_timer_stop(backlightTimer);
+        esp_timer_start_once(backlightTimer, backlightUs);
+      }
+      break;
+
+    case DOOR_REGRANT:
+      isLock = false;
+      xTaskNotifyGive(TaskServoRun_Handle);
+      // Reset timer when RFID grants access
+      esp_timer_stop(lockTimer);
+      esp_timer_start_once(lockTimer, lockUs);
+      break;
+
+    case DOOR_IGNORED:
+      logTimestamp();
+      Serial.println("Same tag re-scanned, and already unlocked. Ignoring...");
+      break;
+
+    case DOOR_DENIED:
+      isLock = true;
+
+      // log in time
+      logTimestamp();
+      Serial.printf("Access Denied (%s). UID: %s\n", accessResultName(access[pick]), receivedUID);
+      break;
+  }
+  for (int i = 0; i < batch->count; i++) {
+    if (i == pick) continue;
+    Serial.printf("  also in field: %s (%s)\n", uids[i], allowed[i] ? "authorized" : accessResultName(access[i]));
+  }
+  telemetryAccessDecision((uint8_t)decision, receivedUID);
+  if (decision == DOOR_GRANTED || decision == DOOR_REGRANT) corrPost(CORR_GRANT);
+  else if (decision == DOOR_DENIED) corrPost(CORR_DENY);
+}
+
+/**
+ * @brief Processes UID batches from `rfidQueue` and manages access control.
+ *
+ * @details
+ * - Applies `processBatch` to every inventory pass: one decision per pass,
+ *   against one RTC read (a blocking round trip through the bus task).
+ * - Logs the pass duration when more than one card was in the field.
  *
  * @param pvParameters Unused
  */
 void taskPrinter(void* pvParameters) {
-  char receivedUID[20];
-  char lastUID[20] = "";
+  rfidBatch_t batch;
+  char lastUID[RFID_UID_STR_LEN] = "";
 
   while (1) {
-    if (xQueueReceive(rfidQueue, &receivedUID, portMAX_DELAY) == pdPASS) {
-      // Check if UID is allowed
-      bool isAllowed = false;
-      for (int i = 0; i < numAllowedUIDs; ++i) {
-        if (strcmp(receivedUID, allowedUIDs[i]) == 0) {
-          isAllowed = true;
-          break;
-        }
+    if (xQueueReceive(rfidQueue, &batch, portMAX_DELAY) == pdPASS) {
+      profTaskWake();
+      if (batch.count > 1) {
+        Serial.printf("Inventory: %u cards in %lu us\n", batch.count, (unsigned long)batch.cycleUs);
       }
-
-      if (isAllowed) {
-        // Avoid printing duplicates
-        int sameIDscanned = strcmp(receivedUID, lastUID);
-        if ((sameIDscanned != 0) && isLock) {
-          Serial.print("Access Granted. UID: ");
-          Serial.println(receivedUID);
-          isLock = false;
-          xTaskNotifyGive(TaskServoRun_Handle);
-          // Reset timer when RFID grants access
-          esp_timer_stop(lockTimer);
-          esp_timer_start_once(lockTimer, 10000000);  // 10 sec = 10,000,000 us
-
-          // Reset inactivity timer
-          if (!backlightOn) {
-            backlightOn = true;
-            Serial.println("Backlight ON (RFID update)");
-            esp_timer_stop(backlightTimer);
-            esp_timer_start_once(backlightTimer, 10000000);  // 10 sec = 10,000,000 us
-          }
-          strncpy(lastUID, receivedUID, sizeof(lastUID));
-        } else {
-          if (isLock) {
-            isLock = false;
-            xTaskNotifyGive(TaskServoRun_Handle);
-            // Reset timer when RFID grants access
-            esp_timer_stop(lockTimer);
-            esp_timer_start_once(lockTimer, 10000000);  // 10 sec = 10,000,000 us
-
-            strncpy(lastUID, receivedUID, sizeof(lastUID));
-          } else {
-            if (xSemaphoreTake(i2c_semaphore, pdMS_TO_TICKS(50)) == pdTRUE) {
-              DateTime now = rtc.now();
-              Serial.printf("Time: %02d:%02d:%02d\n", now.hour(), now.minute(), now.second());
-              xSemaphoreGive(i2c_semaphore);
-            } else {
-              Serial.println("RTC I2C timeout");
-            }
-            Serial.println("Same tag re-scanned, and already unlocked. Ignoring...");
-          }
-        }
-      } else {
-        isLock = true;
-
-        //take semaphore and log in time
-        if (xSemaphoreTake(i2c_semaphore, pdMS_TO_TICKS(50)) == pdTRUE) {
-          DateTime now = rtc.now();
-          Serial.printf("Time: %02d:%02d:%02d\n", now.hour(), now.minute(), now.second());
-          xSemaphoreGive(i2c_semaphore);
-        } else {
-          Serial.println("RTC I2C timeout");
-        }
-        Serial.print("Access Denied. Unknown UID: ");
-        Serial.println(receivedUID);
+      if (batch.count > 0) {
+        accessTime_t now;
+        bool haveTime = accessTimeNow(&now);
+        processBatch(&batch, lastUID, haveTime ? &now : NULL);
       }
     }
   }
@@ -354,13 +605,7 @@ void distanceTask(void* pvParameters) {
     if (sum < 90 && sum != 0) {
       close_dist = true;
        // Serial.println(sum);
-      if (xSemaphoreTake(i2c_semaphore, pdMS_TO_TICKS(50)) == pdTRUE) {
-        DateTime now = rtc.now();
-        Serial.printf("Time: %02d:%02d:%02d\n", now.hour(), now.minute(), now.second());
-        xSemaphoreGive(i2c_semaphore);
-      } else {
-        Serial.println("RTC I2C timeout");
-      }
+      logTimestamp();
       // Reset inactivity timer
       if (!backlightOn) {
         backlightOn = true;
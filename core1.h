@@ -10,8 +10,9 @@
  * Task Overview:
  * - `sensorReadTask` reads PIR and ultrasonic sensor values periodically.
  * - `sensorProcessTask` aggregates data from sensors and determines if backlight or unlock actions should be triggered.
- * - `taskRFIDReader` continuously checks for new RFID cards and sends UIDs.
+ * - `taskRFIDReader` inventories all RFID cards in the field and sends their UIDs as one batch.
  * - `taskPrinter` validates RFID UIDs, manages lock state, and provides user feedback.
+ * - `anomalySaveTask` writes the anomaly baselines to NVS at idle priority.
  * - `distanceTask` and `rtcTask` are deprecated debug routines.
  *
  * @section Authors
@@ -37,6 +38,7 @@ void taskRFIDReader(void *pvParameters);
 void taskPrinter(void *pvParameters);
 void sensorReadTask(void *pvParameters);
 void sensorProcessTask(void *pvParameters);
+void anomalySaveTask(void *pvParameters);
 
 extern void IRAM_ATTR echoISR();
 
@@ -0,0 +1,224 @@
+/**
+ * @file correlator.cpp
+ * @brief Implementation of the presence / access / lock event correlator.
+ *
+ * @details
+ * See `correlator.h` for the alert rules. Each rule keeps only the state it
+ * needs to decide on the next event: the current presence interval, the last
+ * grant, a ring of recent denials and at most one unlock awaiting presence.
+ * Deadlines (an unlock nobody showed up for, a denial burst nobody followed)
+ * are resolved by `corrAdvance()`, which runs on every event and on the
+ * task's idle tick.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <string.h>
+#include "correlator.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include "global_defs.h"
+#include "telemetry.h"
+#include "i2c_bus.h"
+#include "profiler.h"
+#endif
+
+//========= HELPERS =========
+
+/** @brief Wrap-safe `a - b` in milliseconds. */
+static int32_t elapsed(uint32_t a, uint32_t b) {
+  return (int32_t)(a - b);
+}
+
+/** @brief Counts raised alerts and passes the flags through. */
+static uint8_t countAlerts(correlator_t* c, uint8_t alerts) {
+  for (int b = 0; b < 3; b++)
+    if (alerts & (1 << b)) c->alerts[b]++;
+  return alerts;
+}
+
+/** @brief True if a grant falls in `[fromMs, toMs]`. */
+static bool grantBetween(const correlator_t* c, uint32_t fromMs, uint32_t toMs) {
+  return c->anyGrant && elapsed(c->lastGrantMs, fromMs) >= 0 && elapsed(toMs, c->lastGrantMs) >= 0;
+}
+
+//========= CORRELATION =========
+
+/**
+ * @brief Resets the correlator.
+ * @param c State
+ */
+void corrInit(correlator_t* c) {
+  memset(c, 0, sizeof(*c));
+}
+
+/**
+ * @brief Resolves expired windows.
+ *
+ * @details Raises ::CORR_ALERT_UNLOCK_NO_PRESENCE once an unlock has gone
+ * `CORR_UNLOCK_PRESENCE_MS` without presence, and disarms a denial burst
+ * nobody followed. Time never moves backwards: an older `nowMs` is ignored.
+ *
+ * @param c     State
+ * @param nowMs Current time
+ * @return Bitmask of `CORR_ALERT_*` flags raised
+ */
+uint8_t corrAdvance(correlator_t* c, uint32_t nowMs) {
+  if (!c->clockValid || elapsed(nowMs, c->nowMs) > 0) c->nowMs = nowMs;
+  c->clockValid = true;
+
+  uint8_t alerts = CORR_ALERT_NONE;
+  if (c->unlockPending && elapsed(c->nowMs, c->unlockMs) >= (int32_t)CORR_UNLOCK_PRESENCE_MS) {
+    c->unlockPending = false;
+    alerts |= CORR_ALERT_UNLOCK_NO_PRESENCE;
+  }
+  if (c->burstArmed && elapsed(c->nowMs, c->burstMs) > (int32_t)CORR_DENIAL_FOLLOW_MS) {
+    c->burstArmed = false;
+  }
+  return countAlerts(c, alerts);
+}
+
+/**
+ * @brief Folds one event into the correlator.
+ *
+ * @param c  State
+ * @param ev Event; may be slightly older than events already seen
+ * @return Bitmask of `CORR_ALERT_*` flags raised
+ */
+uint8_t corrOnEvent(correlator_t* c, const corrEvent_t* ev) {
+  uint32_t t = ev->timestampMs;
+  c->events++;
+
+  // Deadlines that expired before this event are decided first
+  uint8_t alerts = corrAdvance(c, t);
+  uint8_t raised = CORR_ALERT_NONE;
+
+  switch (ev->type) {
+    case CORR_PRESENCE_START:
+      if (c->present) break;
+      c->present = true;
+      c->anyPresence = true;
+      c->presenceStartMs = t;
+      c->unlockPending = false;
+      if (c->burstArmed) {
+        c->burstArmed = false;
+        raised |= CORR_ALERT_DENIALS_THEN_PRESENCE;
+      }
+      break;
+
+    case CORR_PRESENCE_END:
+      if (!c->present) break;
+      c->present = false;
+      c->presenceEndMs = t;
+      if (elapsed(t, c->presenceStartMs) >= (int32_t)CORR_MIN_PRESENCE_MS &&
+          !grantBetween(c, c->presenceStartMs - CORR_GRANT_BEFORE_MS, t)) {
+        raised |= CORR_ALERT_PRESENCE_NO_GRANT;
+      }
+      break;
+
+    case CORR_GRANT:
+      if (!c->anyGrant || elapsed(t, c->lastGrantMs) > 0) c->lastGrantMs = t;
+      c->anyGrant = true;
+      c->burstArmed = false;
+      c->denialCount = 0;
+      break;
+
+    case CORR_DENY: {
+      c->denials[c->denialIdx] = t;
+      c->denialIdx = (c->denialIdx + 1) % CORR_DENIAL_COUNT;
+      if (c->denialCount < CORR_DENIAL_COUNT) c->denialCount++;
+      // When full, the next write position holds the oldest denial
+      if (c->denialCount == CORR_DENIAL_COUNT &&
+          elapsed(t, c->denials[c->denialIdx]) <= (int32_t)CORR_DENIAL_WINDOW_MS) {
+        c->burstArmed = true;
+        c->burstMs = t;
+      }
+      break;
+    }
+
+    case CORR_UNLOCKED: {
+      if (c->unlocked) break;
+      c->unlocked = true;
+      bool recentPresence = c->present ||
+                            (c->anyPresence && elapsed(t, c->presenceEndMs) <= (int32_t)CORR_UNLOCK_PRESENCE_MS);
+      if (!recentPresence) {
+        c->unlockPending = true;
+        c->unlockMs = t;
+      }
+      break;
+    }
+
+    case CORR_LOCKED:
+      c->unlocked = false;
+      break;
+  }
+  return alerts | countAlerts(c, raised);
+}
+
+/**
+ * @brief Short name of a single alert flag for logs.
+ */
+const char* corrAlertName(uint8_t flag) {
+  switch (flag) {
+    case CORR_ALERT_PRESENCE_NO_GRANT: return "presence without grant";
+    case CORR_ALERT_UNLOCK_NO_PRESENCE: return "unlocked without presence";
+    case CORR_ALERT_DENIALS_THEN_PRESENCE: return "presence after repeated denials";
+  }
+  return "?";
+}
+
+#ifdef ARDUINO
+//========= TASK =========
+
+static correlator_t correlator;  ///< Owned by correlatorTask
+static volatile uint32_t corrDropped = 0;  ///< Events lost because corrQueue was full
+
+/**
+ * @brief Posts an event from a producer task; never blocks.
+ * @param type ::corrEventType_t
+ */
+void corrPost(uint8_t type) {
+  if (corrQueue == NULL) return;
+  corrEvent_t ev;
+  ev.timestampMs = millis();
+  ev.type = type;
+  if (xQueueSend(corrQueue, &ev, 0) != pdPASS) corrDropped++;
+}
+
+/**
+ * @brief Consumes correlation events and reports alerts.
+ *
+ * @details
+ * - Waits up to `CORR_TICK_MS` for the next event, so deadlines still fire
+ *   while the door is quiet.
+ * - Logs each alert with an RTC timestamp and publishes it on the telemetry stream.
+ * - Reports events dropped by producers, since a lost edge can cause a false alert.
+ *
+ * @param pvParameters Unused
+ */
+void correlatorTask(void* pvParameters) {
+  corrInit(&correlator);
+  corrEvent_t ev;
+
+  while (1) {
+    bool got = xQueueReceive(corrQueue, &ev, pdMS_TO_TICKS(CORR_TICK_MS)) == pdPASS;
+    profTaskWake();
+    uint8_t alerts = got ? corrOnEvent(&correlator, &ev) : corrAdvance(&correlator, millis());
+
+    for (uint8_t flag = 1; flag <= CORR_ALERT_DENIALS_THEN_PRESENCE; flag <<= 1) {
+      if (!(alerts & flag)) continue;
+      logTimestamp();
+      Serial.printf("Alert: %s\n", corrAlertName(flag));
+      telemetryAlert(flag);
+    }
+    if (corrDropped) {
+      Serial.printf("Correlator: %lu events dropped\n", (unsigned long)corrDropped);
+      corrDropped = 0;
+    }
+  }
+}
+#endif
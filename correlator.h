@@ -0,0 +1,107 @@
+/**
+ * @file correlator.h
+ * @brief Streaming correlation of presence, access decisions and lock state.
+ *
+ * @details
+ * The sensor pipeline (`sensorProcessTask`) and the RFID pipeline
+ * (`taskPrinter`, `ServoRunTask`) post timestamped events to `corrQueue`;
+ * `correlatorTask` joins them over sliding time windows and raises alerts:
+ * - **Presence without a grant**: presence lasting at least
+ *   `CORR_MIN_PRESENCE_MS` with no grant from `CORR_GRANT_BEFORE_MS` before it
+ *   started until it ended.
+ * - **Unlocked without presence**: the servo unlocked and nobody was present
+ *   within `CORR_UNLOCK_PRESENCE_MS` on either side of it.
+ * - **Denials then presence**: `CORR_DENIAL_COUNT` denied scans within
+ *   `CORR_DENIAL_WINDOW_MS`, followed within `CORR_DENIAL_FOLLOW_MS` by a new
+ *   presence with no grant in between.
+ *
+ * State is a fixed-size struct (the denial window is a ring of
+ * `CORR_DENIAL_COUNT` timestamps); every event and every deadline check is
+ * O(1). Timestamps are `millis()` taken by the producer, so queueing delay
+ * does not skew the windows, and comparisons are wrap-safe.
+ *
+ * The correlation core has no Arduino or FreeRTOS dependencies and is replayed
+ * on a host by `tools/correlate_replay`; the queue, task and logging are only
+ * compiled for the board.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef CORRELATOR_H
+#define CORRELATOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//========= CONFIGURATION =========
+#define CORR_QUEUE_LEN 16                ///< Events buffered between producers and correlatorTask
+#define CORR_TICK_MS 1000                ///< Deadline check period while no events arrive
+#define CORR_MIN_PRESENCE_MS 5000UL      ///< Shorter presence is a passer-by, never alerted
+#define CORR_GRANT_BEFORE_MS 10000UL     ///< A grant this long before presence starts still covers it
+#define CORR_UNLOCK_PRESENCE_MS 5000UL   ///< Presence must be seen this close to an unlock
+#define CORR_DENIAL_COUNT 3              ///< Denials that make a burst
+#define CORR_DENIAL_WINDOW_MS 60000UL    ///< Window for a denial burst
+#define CORR_DENIAL_FOLLOW_MS 300000UL   ///< Presence this soon after a burst is alerted
+
+//========= EVENTS =========
+typedef enum {
+  CORR_PRESENCE_START = 0,  ///< Close or motion detected
+  CORR_PRESENCE_END,        ///< Neither close nor motion
+  CORR_GRANT,               ///< Authorized scan (granted or re-granted)
+  CORR_DENY,                ///< Denied scan
+  CORR_UNLOCKED,            ///< Servo moved to unlocked
+  CORR_LOCKED,              ///< Servo moved to locked
+  CORR_EVENT_COUNT
+} corrEventType_t;
+
+/** @brief One timestamped input event. */
+typedef struct {
+  uint32_t timestampMs;  ///< `millis()` when the producer saw it
+  uint8_t type;          ///< ::corrEventType_t
+} corrEvent_t;
+
+//========= ALERT FLAGS =========
+#define CORR_ALERT_NONE 0x00
+#define CORR_ALERT_PRESENCE_NO_GRANT 0x01     ///< Someone at the door, nobody admitted
+#define CORR_ALERT_UNLOCK_NO_PRESENCE 0x02    ///< Door opened with nobody there
+#define CORR_ALERT_DENIALS_THEN_PRESENCE 0x04 ///< Presence right after a denial burst
+
+/**
+ * @brief Correlator state.
+ */
+typedef struct {
+  uint32_t nowMs;                             ///< Latest time seen (events or ticks)
+  bool clockValid;                            ///< nowMs has been set
+  bool present;                               ///< Inside a presence interval
+  uint32_t presenceStartMs;                   ///< Start of the current / last presence
+  uint32_t presenceEndMs;                     ///< End of the last presence
+  bool anyPresence;                           ///< presenceStartMs/EndMs are valid
+  bool anyGrant;                              ///< lastGrantMs is valid
+  uint32_t lastGrantMs;                       ///< Latest authorized scan
+  uint32_t denials[CORR_DENIAL_COUNT];        ///< Ring of the latest denial times
+  uint8_t denialIdx;                          ///< Next ring write position (= oldest when full)
+  uint8_t denialCount;                        ///< Valid ring entries
+  bool burstArmed;                            ///< A denial burst awaits a following presence
+  uint32_t burstMs;                           ///< Time of the denial completing the burst
+  bool unlocked;                              ///< Last lock state reported
+  bool unlockPending;                         ///< Unlock still waiting for a presence
+  uint32_t unlockMs;                          ///< Time of that unlock
+  uint32_t events;                            ///< Events processed
+  uint32_t alerts[3];                         ///< Alerts raised, by flag bit
+} correlator_t;
+
+//======================= API =======================//
+void corrInit(correlator_t* c);
+uint8_t corrOnEvent(correlator_t* c, const corrEvent_t* ev);
+uint8_t corrAdvance(correlator_t* c, uint32_t nowMs);
+const char* corrAlertName(uint8_t flag);
+
+#ifdef ARDUINO
+void corrPost(uint8_t type);
+void correlatorTask(void* pvParameters);
+#endif
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ * @file door_logic.cpp
+ * @brief Implementation of the pure door detection and access decision logic.
+ *
+ * @details
+ * Behaviour is kept identical to the original inline code of
+ * `sensorProcessTask` and `taskPrinter`, including its quirks (for example a
+ * denied scan sets the lock flag without moving the servo); the simulator is
+ * there to surface those, not this file to hide them.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <string.h>
+#include "door_logic.h"
+
+//========= SENSOR DETECTION =========
+
+/**
+ * @brief Clears the detection window.
+ * @param s Window state
+ */
+void doorSensorInit(doorSensorState_t* s) {
+  memset(s, 0, sizeof(*s));
+}
+
+/**
+ * @brief Adds one sample to the window and evaluates proximity and motion.
+ *
+ * @details
+ * - Close: the window's distance sum is positive and below `closeSumCm`.
+ * - Motion: more than `motionVotes` samples in the window had PIR high.
+ *
+ * @param s           Window state
+ * @param distanceCm  Ultrasonic distance, 0 if no echo
+ * @param pir         Raw PIR level
+ * @param closeSumCm  Proximity threshold on the window sum (default `DOOR_CLOSE_SUM_CM`)
+ * @param motionVotes Motion threshold on PIR-high samples (default `DOOR_MOTION_VOTES`)
+ * @param closeDist   Receives the proximity decision
+ * @param motion      Receives the motion decision
+ */
+void doorSensorUpdate(doorSensorState_t* s, float distanceCm, bool pir,
+                      float closeSumCm, uint32_t motionVotes, bool* closeDist, bool* motion) {
+  s->dist[s->idx] = distanceCm;
+  s->motion[s->idx] = pir ? 1 : 0;
+  s->idx = (s->idx + 1) % DOOR_WINDOW;
+
+  float sumDist = 0;
+  int sumMotion = 0;
+  for (int i = 0; i < DOOR_WINDOW; i++) {
+    sumDist += s->dist[i];
+    sumMotion += s->motion[i];
+  }
+
+  *closeDist = (sumDist < closeSumCm && sumDist > 0.0f);
+  *motion = (sumMotion > (int)motionVotes);
+}
+
+//========= ACCESS DECISION =========
+
+/**
+ * @brief Decides what an RFID scan does.
+ *
+ * @param lastUID Last granted UID, updated on ::DOOR_GRANTED / ::DOOR_REGRANT
+ * @param lastLen Size of the `lastUID` buffer
+ * @param uid     Scanned UID
+ * @param allowed Whether the access schedules admit the UID now (see access_schedule.h)
+ * @param locked  Current lock flag
+ * @return Decision; the caller applies the side effects documented on ::doorDecision_t
+ */
+doorDecision_t doorAccessDecide(char* lastUID, size_t lastLen, const char* uid,
+                                bool allowed, bool locked) {
+  if (!allowed) return DOOR_DENIED;
+
+  // Avoid printing duplicates
+  bool sameIDscanned = strcmp(uid, lastUID) == 0;
+  doorDecision_t d;
+  if (!sameIDscanned && locked) {
+    d = DOOR_GRANTED;
+  } else if (locked) {
+    d = DOOR_REGRANT;
+  } else {
+    return DOOR_IGNORED;
+  }
+
+  strncpy(lastUID, uid, lastLen);
+  lastUID[lastLen - 1] = '\0';
+  return d;
+}
+
+/**
+ * @brief Decides what one inventory pass does, however many cards were in the field.
+ *
+ * @details The pass acts once. If any card is admitted, the door opens for
+ * it and the other cards are only logged by the caller; the last granted
+ * card is preferred when it is among them, so two authorized cards held
+ * together do not alternate as new grants. The pass is denied only when no
+ * card in it is admitted.
+ *
+ * @param lastUID Last granted UID, updated as by doorAccessDecide()
+ * @param lastLen Size of the `lastUID` buffer
+ * @param uids    Scanned UIDs, in the order read
+ * @param allowed Whether the access schedules admit each UID now
+ * @param count   Cards in the pass, at least 1
+ * @param locked  Current lock flag
+ * @param pick    Receives the index of the card the decision is about
+ * @return Decision for card `*pick`
+ */
+doorDecision_t doorBatchDecide(char* lastUID, size_t lastLen, const char* const* uids, const bool* allowed,
+                               uint8_t count, bool locked, uint8_t* pick) {
+  int first = -1;
+  for (uint8_t i = 0; i < count; i++) {
+    if (!allowed[i]) continue;
+    if (strcmp(uids[i], lastUID) == 0) {
+      first = i;
+      break;
+    }
+    if (first < 0) first = i;
+  }
+  *pick = first < 0 ? 0 : (uint8_t)first;
+  return doorAccessDecide(lastUID, lastLen, uids[*pick], first >= 0, locked);
+}
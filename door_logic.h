@@ -0,0 +1,66 @@
+/**
+ * @file door_logic.h
+ * @brief Hardware-independent detection and access decision logic of the door.
+ *
+ * @details
+ * The decisions made by `sensorProcessTask` (is someone close / moving?) and
+ * by `taskPrinter` (what does this RFID scan do?) live here as plain
+ * functions over plain state, with no FreeRTOS, Arduino or peripheral calls.
+ * The tasks apply the resulting side effects (servo notification, timers,
+ * logging); the discrete-event simulator in `tools/door_sim` drives the very
+ * same functions against a virtual clock.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef DOOR_LOGIC_H
+#define DOOR_LOGIC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//========= DEFAULTS =========
+// Compiled-in defaults of the runtime configuration (runtime_config.h)
+#define DOOR_WINDOW 5                  ///< Samples in the rolling detection window
+#define DOOR_CLOSE_SUM_CM 90.0f        ///< Window distance sum below which someone is "close"
+#define DOOR_MOTION_VOTES 2            ///< PIR-high samples in the window must exceed this
+#define DOOR_LOCK_US 10000000ULL       ///< Unlock duration after a grant (10 s)
+#define DOOR_BACKLIGHT_US 10000000ULL  ///< Backlight timeout (10 s)
+#define DOOR_SAMPLE_MS 20              ///< Sensor sample period (50 Hz)
+#define DOOR_RFID_POLL_MS 500          ///< RFID reader poll period while nobody is around
+#define DOOR_RFID_FAST_POLL_MS 100     ///< RFID reader poll period while someone approaches or is present
+
+/**
+ * @brief Rolling window of the most recent sensor samples.
+ */
+typedef struct {
+  float dist[DOOR_WINDOW];      ///< Distance samples (cm), 0 = no echo
+  uint8_t motion[DOOR_WINDOW];  ///< PIR samples (1 = high)
+  uint8_t idx;                  ///< Next write position
+} doorSensorState_t;
+
+/**
+ * @brief Outcome of an RFID scan. Values match ::TelemetryDecision.
+ */
+typedef enum {
+  DOOR_GRANTED = 0,  ///< New authorized tag while locked: unlock, arm lock timer, backlight on
+  DOOR_REGRANT = 1,  ///< Last authorized tag again while locked: unlock, arm lock timer
+  DOOR_IGNORED = 2,  ///< Authorized tag while already unlocked: no action
+  DOOR_DENIED = 3    ///< Unknown tag: lock flag set (servo is not notified)
+} doorDecision_t;
+
+//======================= API =======================//
+void doorSensorInit(doorSensorState_t* s);
+void doorSensorUpdate(doorSensorState_t* s, float distanceCm, bool pir,
+                      float closeSumCm, uint32_t motionVotes, bool* closeDist, bool* motion);
+
+doorDecision_t doorAccessDecide(char* lastUID, size_t lastLen, const char* uid,
+                                bool allowed, bool locked);
+doorDecision_t doorBatchDecide(char* lastUID, size_t lastLen, const char* const* uids, const bool* allowed,
+                               uint8_t count, bool locked, uint8_t* pick);
+
+#endif
@@ -18,7 +18,7 @@
  * System Synchronization:
  * - FreeRTOS tasks and task handles
  * - Queues for sensor data and RFID UIDs
- * - Semaphores for I2C access
+ * - I2C bus manager request queues
  * - Timers for backlight and lock control
  *
  * @authors Authors
@@ -62,26 +62,69 @@ TaskHandle_t taskPrinter_Handle = NULL;        ///< RFID tag validation and acce
 TaskHandle_t taskRTC_Handle = NULL;            ///< RTC timestamping task (deprecated)
 TaskHandle_t taskSensorRead_Handle = NULL;     ///< Unified sensor reading task
 TaskHandle_t taskSensorProcess_Handle = NULL;  ///< Sensor data processing task
+TaskHandle_t TaskTelemetry_Handle = NULL;      ///< Binary telemetry batching task
+TaskHandle_t TaskI2CBus_Handle = NULL;         ///< I2C bus owner task
+TaskHandle_t TaskProfiler_Handle = NULL;       ///< CPU profiler report task
+TaskHandle_t TaskConsole_Handle = NULL;        ///< Serial command console task
+TaskHandle_t TaskCorrelator_Handle = NULL;     ///< Presence / access event correlator task
+TaskHandle_t TaskAnomalySave_Handle = NULL;    ///< Anomaly baseline NVS writer
 
 // ========== RFID Access Control ==========
-const char* allowedUIDs[] = {
-  "DE AD BE EF",
-  "CA FE BA BE",
-  "BF 6D CB 1F",
-  "79 49 4D B2"
-};                                                                        ///< List of authorized RFID UIDs
-const int numAllowedUIDs = sizeof(allowedUIDs) / sizeof(allowedUIDs[0]);  ///< Count of allowed UIDs
+#define ACCESS_COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static const accessWindow_t alwaysWindows[] = {
+  { ACCESS_ALL_DAYS, ACCESS_HM(0, 0), ACCESS_HM(0, 0) }
+};
+/*
+ * Example site policy, not enabled: add the windows and schedules below, give
+ * a badge schedule 1 or 2 and an expiry date, and list the holidays.
+ *
+ * static const accessWindow_t officeWindows[] = {
+ *   { ACCESS_WEEKDAYS, ACCESS_HM(7, 0), ACCESS_HM(19, 0) },
+ *   { ACCESS_SAT, ACCESS_HM(9, 0), ACCESS_HM(13, 0) }
+ * };
+ * static const accessWindow_t cleaningWindows[] = {
+ *   { ACCESS_WEEKDAYS, ACCESS_HM(22, 0), ACCESS_HM(2, 0) }  // runs past midnight
+ * };
+ *   { "office", officeWindows, ACCESS_COUNT(officeWindows) },
+ *   { "cleaning", cleaningWindows, ACCESS_COUNT(cleaningWindows) }
+ *
+ *   { "BF 6D CB 1F", 1, NULL },
+ *   { "79 49 4D B2", 2, "2026-12-31" }
+ *
+ * static const char* const accessHolidays[] = { "2025-12-25", "2026-01-01" };
+ */
+static const accessScheduleDef_t accessSchedules[] = {
+  { "always", alwaysWindows, ACCESS_COUNT(alwaysWindows) }
+};                                                                              ///< Weekly schedules, indexed by credentials
+static const accessCredentialDef_t accessCredentials[] = {
+  { "DE AD BE EF", 0, NULL },
+  { "CA FE BA BE", 0, NULL },
+  { "BF 6D CB 1F", 0, NULL },
+  { "79 49 4D B2", 0, NULL }
+};                                                                              ///< Authorized RFID UIDs: UID, schedule, last valid day
+const accessPolicy_t accessPolicy = {
+  accessSchedules, ACCESS_COUNT(accessSchedules),
+  accessCredentials, ACCESS_COUNT(accessCredentials),
+  NULL, 0
+};                                                                              ///< Access rules, compiled at boot
+static accessCredential_t accessCredStorage[ACCESS_COUNT(accessCredentials)];
+static accessSchedule_t accessSchedStorage[ACCESS_COUNT(accessSchedules)];
+accessTable_t accessTable = {
+  accessCredStorage, ACCESS_COUNT(accessCredentials), 0,
+  accessSchedStorage, ACCESS_COUNT(accessSchedules), 0
+};                                                                              ///< Compiled form of accessPolicy used by taskPrinter
+rfidPower_t rfidPower;                                                          ///< Reader power state and SPI statistics, owned by taskRFIDReader
+portMUX_TYPE rfidPowerMux = portMUX_INITIALIZER_UNLOCKED;                       ///< Guards rfidPower updates against stats snapshots
 
 // ========== FreeRTOS Queues ==========
-QueueHandle_t rfidQueue;           ///< Queue for RFID UID strings
-QueueHandle_t sensorQueue = NULL;  ///< Queue for sensorData_t structs
+QueueHandle_t rfidQueue;              ///< Queue for rfidBatch_t inventory results
+QueueHandle_t sensorQueue = NULL;     ///< Queue for sensorData_t structs
+QueueHandle_t telemetryQueue = NULL;  ///< Queue for tlmRecord_t telemetry records
+QueueHandle_t corrQueue = NULL;       ///< Queue for corrEvent_t correlation events
 
 // ========== Constants ==========
 const float SOUND_SPEED_CM_PER_US = 0.0343f;  ///< Speed of sound in cm/μs
-const unsigned long debounceDelay = 50;       ///< Debounce duration in milliseconds
-
-// ========== Semaphore ==========
-SemaphoreHandle_t i2c_semaphore;  ///< Semaphore to manage I2C bus access
 
 // ========== Peripheral Objects ==========
 LiquidCrystal_I2C lcd(0x27, 16, 2);  ///< I2C 16x2 LCD display instance
@@ -89,10 +132,17 @@ Servo myservo;                       ///< Servo motor instance
 MFRC522 rfid(SS_PIN, RST_PIN);       ///< RFID reader instance
 RTC_DS3231 rtc;                      ///< Real-time clock instance
 
+// ========== Runtime Configuration ==========
+cfgStore_t runtimeConfig;  ///< Tunables published by the console, read lock-free by the tasks
+
+// ========== Boot ==========
+bootPlan_t bootPlan;  ///< Boot stages and their time-to-ready, reported by the console's `boot` command
+
 // ========== State Flags ==========
 volatile bool motion_detected = false;  ///< Motion state flag (true if detected)
 volatile bool sound = false;            ///< Sound state flag (not really used)
 volatile bool close_dist = false;       ///< Proximity state flag (true if close)
+volatile bool approach_wake = false;    ///< Someone is approaching or at the reader (approach tracker)
 volatile bool isLock = true;            ///< Lock state flag (true if locked)
 
 // ========== Buffers and Indices ==========
@@ -4,7 +4,7 @@
  *
  * @details
  * This header provides external declarations for all globally used hardware pin definitions, 
- * task handles, semaphores, peripheral objects, sensor state variables, buffers, and RTOS resources.
+ * task handles, queues, peripheral objects, sensor state variables, buffers, and RTOS resources.
  * It is shared across all components of the system such as RFID access control, distance sensing, 
  * LCD display, and real-time clock functionalities.
  *
@@ -26,6 +26,10 @@
 #include <MFRC522.h>
 #include <RTClib.h>
 #include "driver/timer.h"
+#include "access_schedule.h"
+#include "runtime_config.h"
+#include "rfid_power.h"
+#include "boot.h"
 
 // ========== Pin Definitions ==========
 extern const int LED;
@@ -57,12 +61,24 @@ extern TaskHandle_t taskPrinter_Handle;
 extern TaskHandle_t taskRTC_Handle;
 extern TaskHandle_t taskSensorRead_Handle;
 extern TaskHandle_t taskSensorProcess_Handle;
-extern const char* allowedUIDs[];
-extern const int numAllowedUIDs;
+extern TaskHandle_t TaskTelemetry_Handle;
+extern TaskHandle_t TaskI2CBus_Handle;
+extern TaskHandle_t TaskProfiler_Handle;
+extern TaskHandle_t TaskConsole_Handle;
+extern TaskHandle_t TaskCorrelator_Handle;
+extern TaskHandle_t TaskAnomalySave_Handle;
+
+// ========== RFID Access Control ==========
+extern const accessPolicy_t accessPolicy;
+extern accessTable_t accessTable;
+extern rfidPower_t rfidPower;
+extern portMUX_TYPE rfidPowerMux;
+
+// ========== Boot ==========
+extern bootPlan_t bootPlan;
 
 // ========== Constants ==========
 extern const float SOUND_SPEED_CM_PER_US;
-extern const unsigned long debounceDelay;
 
 typedef struct {
   float distanceCm;
@@ -75,15 +91,18 @@ extern Servo myservo;
 extern MFRC522 rfid; // RFID instance
 extern QueueHandle_t rfidQueue;
 extern QueueHandle_t sensorQueue;
+extern QueueHandle_t telemetryQueue;
+extern QueueHandle_t corrQueue;
 
 extern RTC_DS3231 rtc;            // RTC object
 
-// ========== Semaphore ==========
-extern SemaphoreHandle_t i2c_semaphore;
+// ========== Runtime Configuration ==========
+extern cfgStore_t runtimeConfig;
 
 // ========== State Flags ==========
 extern volatile bool motion_detected;
 extern volatile bool close_dist;
+extern volatile bool approach_wake;
 extern volatile bool isLock;
 
 // ========== Buffers and Indices ==========
@@ -0,0 +1,429 @@
+/**
+ * @file i2c_bus.cpp
+ * @brief Bus-owner task, request queues and statistics for the shared I2C bus.
+ *
+ * @details
+ * `i2cBusTask` is the only code that talks to the LCD and the RTC once the
+ * scheduler is running. Producers post an `i2cRequest_t` to the high (RTC) or
+ * low (LCD) queue of the arbiter and notify the task; they never block on the
+ * bus. The task drains the high queue first, then collects up to
+ * `I2C_LCD_BATCH` LCD requests, drops the ones superseded by a later request
+ * for the same field, and issues the remainder, checking the high queue again
+ * before each write so an RTC read waits for at most one LCD field.
+ *
+ * The arbiter is plain data guarded by a spinlock on the board (nothing on a
+ * host); a request is taken off a queue under the lock and served outside it.
+ *
+ * Blocking RTC reads (`i2cBusRtcNow`) wait on a binary semaphore that lives on
+ * the caller's stack. This is safe because every request is completed by the
+ * bus task: backend operations are bounded by the Wire timeout.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "i2c_bus.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <Wire.h>
+#include "esp_timer.h"
+#include "global_defs.h"
+#include "profiler.h"
+
+static portMUX_TYPE busMux = portMUX_INITIALIZER_UNLOCKED;  ///< Guards the arbiter
+#define BUS_LOCK() portENTER_CRITICAL(&busMux)
+#define BUS_UNLOCK() portEXIT_CRITICAL(&busMux)
+#else
+#define BUS_LOCK()
+#define BUS_UNLOCK()
+#endif
+
+//========= ARBITER =========
+
+/**
+ * @brief True if `b` writes the same LCD target as `a`, so `b` supersedes `a`.
+ */
+static bool sameTarget(const i2cRequest_t* a, const i2cRequest_t* b) {
+  if (a->op != b->op) return false;
+  if (a->op == I2C_OP_LCD_BACKLIGHT) return true;
+  return a->row == b->row && a->col == b->col && a->width == b->width;
+}
+
+/**
+ * @brief Takes the oldest request off a ring.
+ */
+static void ringPop(i2cRequest_t* ring, uint8_t cap, uint8_t* head, uint8_t* count, i2cRequest_t* out) {
+  *out = ring[*head];
+  *head = (uint8_t)((*head + 1) % cap);
+  (*count)--;
+}
+
+/**
+ * @brief Refills the LCD batch from the low queue, merging writes to the same target.
+ */
+static void collectBatch(i2cArbiter_t* a) {
+  a->batchLen = 0;
+  a->batchNext = 0;
+  i2cRequest_t req;
+  while (a->batchLen < I2C_LCD_BATCH && a->lowCount) {
+    ringPop(a->low, I2C_LOW_QUEUE_LEN, &a->lowHead, &a->lowCount, &req);
+    int i;
+    for (i = 0; i < a->batchLen; i++) {
+      if (sameTarget(&a->batch[i], &req)) break;
+    }
+    if (i < a->batchLen) {
+      a->batch[i] = req;  // later write to the same field wins
+      a->stats.coalesced++;
+    } else {
+      a->batch[a->batchLen++] = req;
+    }
+  }
+}
+
+/**
+ * @brief Picks the next request to serve: any RTC read, else the next LCD write of the batch.
+ * @return false if nothing is pending
+ */
+static bool takeNext(i2cArbiter_t* a, i2cRequest_t* out, i2cPriority_t* prio) {
+  if (a->highCount) {
+    ringPop(a->high, I2C_HIGH_QUEUE_LEN, &a->highHead, &a->highCount, out);
+    *prio = I2C_PRIO_HIGH;
+    return true;
+  }
+  if (a->batchNext == a->batchLen) collectBatch(a);
+  if (a->batchNext == a->batchLen) return false;
+  *out = a->batch[a->batchNext++];
+  *prio = I2C_PRIO_LOW;
+  return true;
+}
+
+/**
+ * @brief Resets the queues, the batch and the statistics.
+ */
+void i2cArbInit(i2cArbiter_t* a) {
+  memset(a, 0, sizeof(*a));
+}
+
+/**
+ * @brief Queues a request; never blocks.
+ * @param a     Arbiter
+ * @param prio  Queue to post to
+ * @param req   Request, copied
+ * @param nowUs Clock for the queue-wait statistics
+ * @return false (and counted as dropped) if the queue is full
+ */
+bool i2cArbSubmit(i2cArbiter_t* a, i2cPriority_t prio, const i2cRequest_t* req, i2cClock_t nowUs) {
+  int64_t now = nowUs();
+  bool ok = true;
+  BUS_LOCK();
+  if (prio == I2C_PRIO_HIGH && a->highCount < I2C_HIGH_QUEUE_LEN) {
+    i2cRequest_t* slot = &a->high[(a->highHead + a->highCount++) % I2C_HIGH_QUEUE_LEN];
+    *slot = *req;
+    slot->enqueuedUs = now;
+  } else if (prio == I2C_PRIO_LOW && a->lowCount < I2C_LOW_QUEUE_LEN) {
+    i2cRequest_t* slot = &a->low[(a->lowHead + a->lowCount++) % I2C_LOW_QUEUE_LEN];
+    *slot = *req;
+    slot->enqueuedUs = now;
+  } else {
+    a->stats.dropped++;
+    ok = false;
+  }
+  BUS_UNLOCK();
+  return ok;
+}
+
+/**
+ * @brief Serves one request on the bus, records its statistics and runs its callback.
+ *
+ * @details Called by the single bus owner only. The request is taken under
+ * the lock and issued outside it, so producers can keep submitting meanwhile.
+ *
+ * @param a     Arbiter
+ * @param be    Device backend
+ * @param nowUs Clock for the statistics
+ * @return false if no request was pending
+ */
+bool i2cArbServeNext(i2cArbiter_t* a, const i2cBackend_t* be, i2cClock_t nowUs) {
+  i2cRequest_t req;
+  i2cPriority_t prio;
+  BUS_LOCK();
+  bool got = takeNext(a, &req, &prio);
+  BUS_UNLOCK();
+  if (!got) return false;
+
+  int64_t start = nowUs();
+  rtcTime_t t;
+  bool ok;
+  i2cDevice_t dev;
+  switch (req.op) {
+    case I2C_OP_RTC_READ:
+      dev = I2C_DEV_RTC;
+      ok = be->rtcRead(&t);
+      break;
+    case I2C_OP_LCD_TEXT:
+      dev = I2C_DEV_LCD;
+      ok = be->lcdText(req.row, req.col, req.width, req.text);
+      break;
+    default:
+      dev = I2C_DEV_LCD;
+      ok = be->lcdBacklight(req.on);
+      break;
+  }
+  int64_t end = nowUs();
+  uint32_t wait = (uint32_t)(start - req.enqueuedUs);
+
+  BUS_LOCK();
+  i2cBusStats_t* s = &a->stats;
+  s->dev[dev].transactions++;
+  if (!ok) s->dev[dev].nacks++;
+  s->dev[dev].busyUs += end - start;
+  s->served[prio]++;
+  s->waitUs[prio] += wait;
+  if (wait > s->maxWaitUs[prio]) s->maxWaitUs[prio] = wait;
+  BUS_UNLOCK();
+
+  if (req.done) req.done(ok, req.op == I2C_OP_RTC_READ && ok ? &t : NULL, req.ctx);
+  return true;
+}
+
+#ifdef ARDUINO
+//========= GLOBAL VARIABLES =========
+static const i2cBackend_t* backend = NULL;  ///< Active device backend
+static i2cArbiter_t bus;                    ///< Request queues and statistics
+
+static const uint8_t DS3231_ADDR = 0x68;  ///< RTC I2C address
+
+//========= HARDWARE BACKEND =========
+
+/**
+ * @brief Reads the DS3231. Probes the address first so a missing RTC is reported as a NACK.
+ */
+static bool hwRtcRead(rtcTime_t* out) {
+  Wire.beginTransmission(DS3231_ADDR);
+  if (Wire.endTransmission() != 0) return false;
+
+  DateTime now = rtc.now();
+  out->year = now.year();
+  out->month = now.month();
+  out->day = now.day();
+  out->hour = now.hour();
+  out->minute = now.minute();
+  out->second = now.second();
+  out->dayOfWeek = now.dayOfTheWeek();
+  return true;
+}
+
+/**
+ * @brief Writes one space-padded LCD field with a single cursor move.
+ */
+static bool hwLcdText(uint8_t row, uint8_t col, uint8_t width, const char* text) {
+  char field[I2C_LCD_TEXT_MAX + 1];
+  snprintf(field, sizeof(field), "%-*.*s", width, width, text);
+  lcd.setCursor(col, row);
+  lcd.print(field);
+  return true;
+}
+
+/**
+ * @brief Switches the LCD backlight.
+ */
+static bool hwLcdBacklight(bool on) {
+  if (on) {
+    lcd.backlight();
+  } else {
+    lcd.noBacklight();
+  }
+  return true;
+}
+
+static const i2cBackend_t hwBackend = { hwRtcRead, hwLcdText, hwLcdBacklight };
+
+//========= HELPERS =========
+
+/** @brief Microseconds since boot, for the arbiter statistics. */
+static int64_t busClock() {
+  return esp_timer_get_time();
+}
+
+/**
+ * @brief Posts a request to the arbiter and wakes the bus task.
+ */
+static bool submit(i2cPriority_t prio, const i2cRequest_t* req) {
+  if (TaskI2CBus_Handle == NULL) return false;
+  if (!i2cArbSubmit(&bus, prio, req, busClock)) return false;
+  xTaskNotifyGive(TaskI2CBus_Handle);
+  return true;
+}
+
+/** @brief Context of a blocking RTC read. */
+typedef struct {
+  SemaphoreHandle_t done;  ///< Given by the bus task on completion
+  rtcTime_t* out;          ///< Where to store the time
+  bool ok;                 ///< Result
+} syncRead_t;
+
+/** @brief Completion callback for i2cBusRtcNow(). */
+static void syncReadDone(bool ok, const rtcTime_t* time, void* ctx) {
+  syncRead_t* s = (syncRead_t*)ctx;
+  s->ok = ok;
+  if (ok) *s->out = *time;
+  xSemaphoreGive(s->done);
+}
+
+//========= API =========
+
+/**
+ * @brief Resets the request queues and selects the device backend.
+ * @param be Backend to use, or NULL for the real LCD and RTC
+ * @return true on success
+ */
+bool i2cBusInit(const i2cBackend_t* be) {
+  backend = be ? be : &hwBackend;
+  i2cArbInit(&bus);
+  return true;
+}
+
+/**
+ * @brief Submits an asynchronous RTC read (high priority).
+ * @param done Callback run on the bus task with the result
+ * @param ctx  Passed through to `done`
+ * @return false if the request could not be queued
+ */
+bool i2cBusRtcRead(i2cDoneCb_t done, void* ctx) {
+  i2cRequest_t req;
+  memset(&req, 0, sizeof(req));
+  req.op = I2C_OP_RTC_READ;
+  req.done = done;
+  req.ctx = ctx;
+  return submit(I2C_PRIO_HIGH, &req);
+}
+
+/**
+ * @brief Reads the RTC and waits for the result.
+ * @param out Receives the current time
+ * @return false if the request could not be queued or the RTC NACKed
+ */
+bool i2cBusRtcNow(rtcTime_t* out) {
+  StaticSemaphore_t semBuf;
+  syncRead_t s;
+  s.done = xSemaphoreCreateBinaryStatic(&semBuf);
+  s.out = out;
+  s.ok = false;
+
+  if (!i2cBusRtcRead(syncReadDone, &s)) return false;
+  xSemaphoreTake(s.done, portMAX_DELAY);
+  return s.ok;
+}
+
+/**
+ * @brief Queues an LCD field update (low priority, fire and forget).
+ * @param row   LCD row
+ * @param col   First column of the field
+ * @param width Field width, the text is space padded / truncated to it
+ * @param text  Text to show
+ * @return false if the request could not be queued
+ */
+bool i2cBusLcdText(uint8_t row, uint8_t col, uint8_t width, const char* text) {
+  i2cRequest_t req;
+  memset(&req, 0, sizeof(req));
+  req.op = I2C_OP_LCD_TEXT;
+  req.row = row;
+  req.col = col;
+  req.width = width > I2C_LCD_TEXT_MAX ? I2C_LCD_TEXT_MAX : width;
+  strncpy(req.text, text, I2C_LCD_TEXT_MAX);
+  return submit(I2C_PRIO_LOW, &req);
+}
+
+/**
+ * @brief Queues a backlight change (low priority, fire and forget).
+ * @param on Desired backlight state
+ * @return false if the request could not be queued
+ */
+bool i2cBusLcdBacklight(bool on) {
+  i2cRequest_t req;
+  memset(&req, 0, sizeof(req));
+  req.op = I2C_OP_LCD_BACKLIGHT;
+  req.on = on;
+  return submit(I2C_PRIO_LOW, &req);
+}
+
+/**
+ * @brief Copies the current statistics.
+ */
+void i2cBusGetStats(i2cBusStats_t* out) {
+  BUS_LOCK();
+  *out = bus.stats;
+  BUS_UNLOCK();
+}
+
+/**
+ * @brief Prints bus occupancy and queue waits to Serial.
+ */
+void i2cBusPrintStats() {
+  i2cBusStats_t s;
+  i2cBusGetStats(&s);
+  static const char* devNames[I2C_DEV_COUNT] = { "RTC", "LCD" };
+  static const char* prioNames[I2C_PRIO_COUNT] = { "high", "low" };
+
+  for (int d = 0; d < I2C_DEV_COUNT; d++) {
+    Serial.printf("I2C %s: %lu ops, %lu nacks, busy %llu us\n", devNames[d],
+                  (unsigned long)s.dev[d].transactions, (unsigned long)s.dev[d].nacks,
+                  (unsigned long long)s.dev[d].busyUs);
+  }
+  for (int p = 0; p < I2C_PRIO_COUNT; p++) {
+    Serial.printf("I2C %s queue: %lu served, avg wait %lu us, max wait %lu us\n", prioNames[p],
+                  (unsigned long)s.served[p],
+                  (unsigned long)(s.served[p] ? s.waitUs[p] / s.served[p] : 0),
+                  (unsigned long)s.maxWaitUs[p]);
+  }
+  Serial.printf("I2C coalesced %lu, dropped %lu\n", (unsigned long)s.coalesced, (unsigned long)s.dropped);
+}
+
+/**
+ * @brief Prints the current RTC time in the system's usual "Time: hh:mm:ss" form.
+ */
+void logTimestamp() {
+  rtcTime_t now;
+  if (i2cBusRtcNow(&now)) {
+    Serial.printf("Time: %02d:%02d:%02d\n", now.hour, now.minute, now.second);
+  } else {
+    Serial.println("RTC I2C timeout");
+  }
+}
+
+//========= TASK =========
+
+/**
+ * @brief Owns the I2C bus and serves queued requests by priority.
+ *
+ * @details
+ * - Sleeps until a producer notifies it (or the stats period elapses).
+ * - Serves requests until none is pending: all RTC reads, then one
+ *   coalesced batch of LCD writes, re-checking for RTC reads before each
+ *   LCD write.
+ *
+ * @param pvParameters Unused
+ */
+void i2cBusTask(void* pvParameters) {
+  TickType_t lastStats = xTaskGetTickCount();
+
+  while (1) {
+    TickType_t wait = I2C_STATS_PERIOD_MS ? pdMS_TO_TICKS(I2C_STATS_PERIOD_MS) : portMAX_DELAY;
+    ulTaskNotifyTake(pdTRUE, wait);
+    profTaskWake();
+
+    while (i2cArbServeNext(&bus, backend, busClock)) {
+    }
+
+    if (I2C_STATS_PERIOD_MS && xTaskGetTickCount() - lastStats >= pdMS_TO_TICKS(I2C_STATS_PERIOD_MS)) {
+      i2cBusPrintStats();
+      lastStats = xTaskGetTickCount();
+    }
+  }
+}
+#endif
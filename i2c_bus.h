@@ -0,0 +1,154 @@
+/**
+ * @file i2c_bus.h
+ * @brief Single-owner I2C bus manager for the LCD and DS3231 RTC.
+ *
+ * @details
+ * All I2C traffic goes through `i2cBusTask`, which owns the bus. Other tasks
+ * submit transaction requests through two queues instead of taking a mutex:
+ * - **High priority**: RTC reads. Always served before any pending LCD work,
+ *   including between the individual writes of an LCD batch.
+ * - **Low priority**: LCD text and backlight writes. Consecutive requests are
+ *   coalesced (the latest text for a field and the latest backlight state win)
+ *   and the surviving writes are issued back to back.
+ *
+ * Requests complete asynchronously through a callback run on the bus task;
+ * `i2cBusRtcNow()` wraps this into a blocking call for code that just needs
+ * the time. Per-device bus occupancy and per-priority queue waits are
+ * accumulated and printed by `i2cBusPrintStats()`.
+ *
+ * The queues and the arbitration (`i2cArbSubmit()`, `i2cArbServeNext()`)
+ * have no Arduino or FreeRTOS dependencies and reach the devices through an
+ * `i2cBackend_t`. On the board the bus task drives them with the Wire / LCD
+ * backend; `tools/i2c_bus_sim` drives them on a host with a simulated bus that
+ * injects latency and NACKs.
+ *
+ * Coalescing removes superseded field writes; the surviving fields are still
+ * written one `LiquidCrystal_I2C` call each, which the library splits into
+ * several short Wire transmissions per character.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//========= CONFIGURATION =========
+#define I2C_HIGH_QUEUE_LEN 8          ///< Pending RTC reads
+#define I2C_LOW_QUEUE_LEN 16          ///< Pending LCD writes (coalescing happens when they are served)
+#define I2C_LCD_BATCH 8               ///< LCD requests coalesced per batch
+#define I2C_LCD_TEXT_MAX 16           ///< Longest LCD field (one 16x2 row)
+#define I2C_STATS_PERIOD_MS 60000UL   ///< Period of the automatic stats report, 0 = off
+
+/**
+ * @brief Calendar time as read from the RTC.
+ */
+typedef struct {
+  uint16_t year;      ///< Full year, e.g. 2025
+  uint8_t month;      ///< 1-12
+  uint8_t day;        ///< 1-31
+  uint8_t hour;       ///< 0-23
+  uint8_t minute;     ///< 0-59
+  uint8_t second;     ///< 0-59
+  uint8_t dayOfWeek;  ///< 0 = Sunday
+} rtcTime_t;
+
+/** @brief Devices sharing the bus, used to index statistics. */
+typedef enum { I2C_DEV_RTC = 0, I2C_DEV_LCD, I2C_DEV_COUNT } i2cDevice_t;
+
+/** @brief Queue priorities, used to index statistics. */
+typedef enum { I2C_PRIO_HIGH = 0, I2C_PRIO_LOW, I2C_PRIO_COUNT } i2cPriority_t;
+
+/** @brief Transaction kinds. */
+typedef enum { I2C_OP_RTC_READ = 0, I2C_OP_LCD_TEXT, I2C_OP_LCD_BACKLIGHT } i2cOp_t;
+
+/**
+ * @brief Completion callback, run on the bus task.
+ * @param ok   false if the device NACKed
+ * @param time RTC time for ::I2C_OP_RTC_READ, NULL otherwise
+ * @param ctx  Caller context passed at submission
+ */
+typedef void (*i2cDoneCb_t)(bool ok, const rtcTime_t* time, void* ctx);
+
+/**
+ * @brief One queued bus transaction.
+ */
+typedef struct {
+  uint8_t op;                        ///< ::i2cOp_t
+  uint8_t row;                       ///< LCD row
+  uint8_t col;                       ///< LCD column
+  uint8_t width;                     ///< LCD field width, text is space padded to it
+  bool on;                           ///< Backlight state
+  char text[I2C_LCD_TEXT_MAX + 1];   ///< LCD text
+  i2cDoneCb_t done;                  ///< Optional completion callback
+  void* ctx;                         ///< Callback context
+  int64_t enqueuedUs;                ///< Submission time, for queue-wait stats
+} i2cRequest_t;
+
+/**
+ * @brief Device operations used by the bus task.
+ */
+typedef struct {
+  bool (*rtcRead)(rtcTime_t* out);                                             ///< Read the RTC
+  bool (*lcdText)(uint8_t row, uint8_t col, uint8_t width, const char* text);  ///< Write one LCD field
+  bool (*lcdBacklight)(bool on);                                               ///< Switch the backlight
+} i2cBackend_t;
+
+/** @brief Per-device bus occupancy. */
+typedef struct {
+  uint32_t transactions;  ///< Operations issued
+  uint32_t nacks;         ///< Operations that failed
+  uint64_t busyUs;        ///< Time the bus was held for this device
+} i2cDevStats_t;
+
+/** @brief Bus manager statistics. */
+typedef struct {
+  i2cDevStats_t dev[I2C_DEV_COUNT];  ///< Indexed by ::i2cDevice_t
+  uint32_t served[I2C_PRIO_COUNT];   ///< Requests served per priority
+  uint64_t waitUs[I2C_PRIO_COUNT];   ///< Total queue wait per priority
+  uint32_t maxWaitUs[I2C_PRIO_COUNT];///< Worst queue wait per priority
+  uint32_t coalesced;                ///< LCD requests merged into a later one
+  uint32_t dropped;                  ///< Requests rejected because a queue was full
+} i2cBusStats_t;
+
+/**
+ * @brief Request queues, the LCD batch being written and the statistics.
+ */
+typedef struct {
+  i2cRequest_t high[I2C_HIGH_QUEUE_LEN];  ///< RTC reads, FIFO ring
+  i2cRequest_t low[I2C_LOW_QUEUE_LEN];    ///< LCD writes, FIFO ring
+  uint8_t highHead, highCount;
+  uint8_t lowHead, lowCount;
+  i2cRequest_t batch[I2C_LCD_BATCH];      ///< Coalesced LCD writes not yet issued
+  uint8_t batchLen, batchNext;
+  i2cBusStats_t stats;
+} i2cArbiter_t;
+
+/** @brief Clock used for queue-wait and occupancy statistics. */
+typedef int64_t (*i2cClock_t)(void);
+
+//======================= API =======================//
+void i2cArbInit(i2cArbiter_t* a);
+bool i2cArbSubmit(i2cArbiter_t* a, i2cPriority_t prio, const i2cRequest_t* req, i2cClock_t nowUs);
+bool i2cArbServeNext(i2cArbiter_t* a, const i2cBackend_t* be, i2cClock_t nowUs);
+
+#ifdef ARDUINO
+bool i2cBusInit(const i2cBackend_t* backend);
+void i2cBusTask(void* pvParameters);
+
+bool i2cBusRtcRead(i2cDoneCb_t done, void* ctx);
+bool i2cBusRtcNow(rtcTime_t* out);
+bool i2cBusLcdText(uint8_t row, uint8_t col, uint8_t width, const char* text);
+bool i2cBusLcdBacklight(bool on);
+
+void i2cBusGetStats(i2cBusStats_t* out);
+void i2cBusPrintStats();
+void logTimestamp();
+#endif
+
+#endif
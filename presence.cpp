@@ -0,0 +1,77 @@
+/**
+ * @file presence.cpp
+ * @brief Presence hysteresis and incremental run-length summaries.
+ *
+ * @details
+ * Times are `millis()` values and only ever subtracted, so a presence that
+ * spans the counter wrapping is summarised correctly.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <string.h>
+#include "presence.h"
+
+/**
+ * @brief Resets the tracker to "nobody there".
+ * @param p Tracker state
+ */
+void presenceInit(presenceTracker_t* p) {
+  memset(p, 0, sizeof(*p));
+}
+
+/**
+ * @brief Folds one sample into the tracker.
+ *
+ * @param p          Tracker state
+ * @param nowMs      Sample time
+ * @param distanceMm Ultrasonic distance, 0 if no echo
+ * @param close      Proximity decision for this sample
+ * @param motion     Motion decision for this sample
+ * @param ended      Receives the summary when `PRESENCE_ENDED` is returned
+ * @return Bitmask of `PRESENCE_STARTED` / `PRESENCE_ENDED`
+ */
+uint8_t presenceUpdate(presenceTracker_t* p, uint32_t nowMs, uint16_t distanceMm, bool close, bool motion,
+                       presenceSummary_t* ended) {
+  if (!(close || motion)) {
+    if (!p->present) {
+      p->onRun = 0;  // candidate too short, dropped
+      return PRESENCE_NONE;
+    }
+    if (nowMs - p->lastMs < PRESENCE_OFF_MS) return PRESENCE_NONE;
+
+    p->present = false;
+    p->run.durationMs = p->lastMs - p->run.startMs;
+    p->run.minMm = p->echoes ? p->run.minMm : 0;
+    p->run.meanMm = p->echoes ? (uint16_t)(p->sumMm / p->echoes) : 0;
+    *ended = p->run;
+    return PRESENCE_ENDED;
+  }
+
+  // a new candidate starts a fresh summary
+  if (!p->present && p->onRun == 0) {
+    memset(&p->run, 0, sizeof(p->run));
+    p->run.startMs = nowMs;
+    p->run.minMm = UINT16_MAX;
+    p->echoes = 0;
+    p->sumMm = 0;
+  }
+
+  p->run.samples++;
+  if (distanceMm > 0) {
+    p->echoes++;
+    p->sumMm += distanceMm;
+    if (distanceMm < p->run.minMm) p->run.minMm = distanceMm;
+  }
+  p->run.close |= close;
+  p->run.motion |= motion;
+  p->lastMs = nowMs;
+
+  if (p->present || ++p->onRun < PRESENCE_ON_SAMPLES) return PRESENCE_NONE;
+  p->present = true;
+  p->onRun = 0;
+  return PRESENCE_STARTED;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file presence.h
+ * @brief Debounced presence events with run-length summaries.
+ *
+ * @details
+ * `sensorProcessTask` evaluates proximity and motion on every 50 Hz sample.
+ * This module turns that per-sample flag into two events per visit:
+ * - **Started** once the flag has been set for `PRESENCE_ON_SAMPLES`
+ *   consecutive samples (a single spurious echo does not start a presence);
+ *   the start time is the first of those samples.
+ * - **Ended** once the flag has been clear for `PRESENCE_OFF_MS`; shorter
+ *   gaps (someone briefly out of the beam and below the PIR votes) are
+ *   bridged and belong to the same presence.
+ *
+ * While a presence lasts the tracker accumulates, one addition and one
+ * comparison per sample, how many samples detected someone and the minimum
+ * and sum of the distances that had an echo. The ended event returns them as
+ * a `presenceSummary_t`: start time, duration (first to last detecting
+ * sample), sample count and min / mean distance. Samples in between the two
+ * events produce no output, so the task does no I/O for them.
+ *
+ * The tracker has no Arduino or FreeRTOS dependencies and is checked on a
+ * host against scripted traces by `tools/presence_replay`.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef PRESENCE_H
+#define PRESENCE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//========= CONFIGURATION =========
+#define PRESENCE_ON_SAMPLES 2     ///< Consecutive detecting samples that start a presence
+#define PRESENCE_OFF_MS 500UL     ///< Time without detection that ends a presence
+
+//========= EVENT FLAGS =========
+#define PRESENCE_NONE 0x00
+#define PRESENCE_STARTED 0x01  ///< A presence was confirmed
+#define PRESENCE_ENDED 0x02    ///< A presence ended; the summary is filled in
+
+/**
+ * @brief Run-length summary of one presence.
+ */
+typedef struct {
+  uint32_t startMs;     ///< First detecting sample
+  uint32_t durationMs;  ///< First to last detecting sample
+  uint32_t samples;     ///< Detecting samples
+  uint16_t minMm;       ///< Closest echo, 0 if no sample had one
+  uint16_t meanMm;      ///< Mean of the samples with an echo, 0 if none
+  bool close;           ///< Proximity was part of the detection at some point
+  bool motion;          ///< Motion was part of the detection at some point
+} presenceSummary_t;
+
+/**
+ * @brief Tracker state.
+ */
+typedef struct {
+  bool present;        ///< Inside a confirmed presence
+  uint8_t onRun;       ///< Consecutive detecting samples while not present
+  uint32_t lastMs;     ///< Last detecting sample
+  uint32_t echoes;     ///< Detecting samples with an echo
+  uint64_t sumMm;      ///< Sum of their distances
+  presenceSummary_t run;  ///< Summary being accumulated
+} presenceTracker_t;
+
+//======================= API =======================//
+void presenceInit(presenceTracker_t* p);
+uint8_t presenceUpdate(presenceTracker_t* p, uint32_t nowMs, uint16_t distanceMm, bool close, bool motion,
+                       presenceSummary_t* ended);
+
+/** @brief True while a confirmed presence lasts. */
+static inline bool presenceActive(const presenceTracker_t* p) { return p->present; }
+
+#endif
@@ -0,0 +1,253 @@
+/**
+ * @file profiler.cpp
+ * @brief Run-time accounting and serial report for the CPU profiler.
+ *
+ * @details
+ * Each report takes a snapshot of `uxTaskGetSystemState()` and hands it to
+ * `profAccount()`, which subtracts the previous snapshot, so task run times,
+ * wakeups and ISR time are all reported per window and wrap-safe. Per-core
+ * busy time is derived from the run time of that core's idle task over the
+ * same window.
+ *
+ * Wakeups are counted by `profTaskWake()`, called once per loop iteration of
+ * each task. The first call from a task gives it a slot through the FreeRTOS
+ * task number, so later calls are a single increment.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <string.h>
+#include "profiler.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include "global_defs.h"
+#else
+#include <time.h>
+#endif
+
+//========= GLOBAL VARIABLES =========
+profIsrStats_t profIsrStats[PROF_ISR_COUNT];
+volatile uint32_t profilerPeriodMs = PROFILER_DEFAULT_PERIOD_MS;
+
+static const char* isrNames[PROF_ISR_COUNT] = { "echoISR", "onLockTimer", "onBacklightTimer" };
+
+//========= HELPERS =========
+
+#ifndef ARDUINO
+/**
+ * @brief Host stand-in for the cycle counter: a nanosecond monotonic clock.
+ */
+uint32_t profHostCycles() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+#endif
+
+/** @brief Finds the previous sample of a task, or NULL for a new task. */
+static const profPrevTask_t* findPrev(const profAccount_t* acc, const void* h) {
+  for (int i = 0; i < acc->numTasks; i++) {
+    if (acc->tasks[i].handle == h) return &acc->tasks[i];
+  }
+  return NULL;
+}
+
+//========= ACCOUNTING =========
+
+/**
+ * @brief Turns the counters at the end of a window into a report.
+ *
+ * @details
+ * Every delta is taken against the previous call, so the first report covers
+ * the time since boot. A task without a previous sample started during the
+ * window and is charged its whole counter. Run time is per core: a task
+ * pinned to one core can use at most one window. The ISR maximums are reset
+ * for the next window. Nothing is advanced when the window is empty.
+ *
+ * @param acc          Counters at the end of the previous window, updated
+ * @param tasks        Task samples
+ * @param numTasks     Entries in `tasks`, at most PROFILER_MAX_TASKS
+ * @param totalRunTime Run-time counter total, microseconds (wraps)
+ * @param idle         Idle task handle of each core
+ * @param numCores     Entries in `idle`, at most PROFILER_MAX_CORES
+ * @param isr          ISR accumulators
+ * @param cyclesPerUs  ISR cycle counter ticks per microsecond
+ * @param out          Receives the report
+ * @return false if there was nothing to report
+ */
+bool profAccount(profAccount_t* acc, const profTaskSample_t* tasks, uint8_t numTasks, uint32_t totalRunTime,
+                 const void* const* idle, uint8_t numCores, profIsrStats_t* isr, uint32_t cyclesPerUs,
+                 profReport_t* out) {
+  uint32_t window = totalRunTime - acc->totalRunTime;
+  if (numTasks == 0 || window == 0) return false;
+  if (numTasks > PROFILER_MAX_TASKS) numTasks = PROFILER_MAX_TASKS;
+  if (numCores > PROFILER_MAX_CORES) numCores = PROFILER_MAX_CORES;
+  out->windowUs = window;
+
+  // — per core: busy = 1 - idle share —
+  out->numCores = numCores;
+  for (int core = 0; core < numCores; core++) {
+    out->coreBusy[core] = -1.0f;
+    for (int i = 0; i < numTasks; i++) {
+      if (tasks[i].handle != idle[core]) continue;
+      uint32_t idleDelta = tasks[i].runTime - acc->idle[core];
+      acc->idle[core] = tasks[i].runTime;
+      float busy = 100.0f - 100.0f * idleDelta / window;
+      out->coreBusy[core] = busy < 0.0f ? 0.0f : busy;
+    }
+  }
+
+  // — per task —
+  profPrevTask_t next[PROFILER_MAX_TASKS];
+  for (int i = 0; i < numTasks; i++) {
+    const profTaskSample_t* t = &tasks[i];
+    const profPrevTask_t* prev = findPrev(acc, t->handle);
+    uint32_t runDelta = t->runTime - (prev ? prev->runTime : 0);
+    uint32_t wakeDelta = t->wakes - (prev ? prev->wakes : 0);
+
+    out->tasks[i].name = t->name;
+    out->tasks[i].cpuPct = 100.0f * runDelta / window;
+    out->tasks[i].wakesPerSec = wakeDelta * 1000000.0f / window;
+    out->tasks[i].stackFree = t->stackFree;
+
+    next[i].handle = t->handle;
+    next[i].runTime = t->runTime;
+    next[i].wakes = t->wakes;
+  }
+  out->numTasks = numTasks;
+  memcpy(acc->tasks, next, numTasks * sizeof(profPrevTask_t));
+  acc->numTasks = numTasks;
+  acc->totalRunTime = totalRunTime;
+
+  // — ISRs and timer callbacks —
+  for (int i = 0; i < PROF_ISR_COUNT; i++) {
+    uint32_t count = isr[i].count;
+    uint32_t cycles = isr[i].cycles;
+    uint32_t maxCycles = isr[i].maxCycles;
+    isr[i].maxCycles = 0;
+
+    uint32_t dc = count - acc->isrCount[i];
+    uint32_t dcy = cycles - acc->isrCycles[i];
+    acc->isrCount[i] = count;
+    acc->isrCycles[i] = cycles;
+
+    out->isrs[i].name = isrNames[i];
+    out->isrs[i].perSec = dc * 1000000.0f / window;
+    out->isrs[i].avgUs = dc ? (float)dcy / dc / cyclesPerUs : 0.0f;
+    out->isrs[i].maxUs = (float)maxCycles / cyclesPerUs;
+    out->isrs[i].totalPct = 100.0f * dcy / cyclesPerUs / window;
+  }
+  return true;
+}
+
+#ifdef ARDUINO
+//========= DEVICE =========
+
+static volatile uint32_t taskWakes[PROFILER_MAX_TASKS + 1];  ///< Indexed by task number, 0 = unassigned
+static UBaseType_t nextTaskNumber = 1;                       ///< Next free wake slot
+static portMUX_TYPE profMux = portMUX_INITIALIZER_UNLOCKED;  ///< Guards slot assignment
+
+static profAccount_t account;                        ///< Counters at the last report
+static TaskStatus_t taskStatus[PROFILER_MAX_TASKS];  ///< Scratch for uxTaskGetSystemState
+static profTaskSample_t samples[PROFILER_MAX_TASKS];
+static profReport_t report;
+
+//========= API =========
+
+/**
+ * @brief Counts one wakeup of the calling task. Call once per task loop iteration.
+ */
+void profTaskWake() {
+#if configUSE_TRACE_FACILITY
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  UBaseType_t n = uxTaskGetTaskNumber(self);
+  if (n == 0) {
+    portENTER_CRITICAL(&profMux);
+    if (nextTaskNumber <= PROFILER_MAX_TASKS) {
+      n = nextTaskNumber++;
+      vTaskSetTaskNumber(self, n);
+    }
+    portEXIT_CRITICAL(&profMux);
+  }
+  if (n > 0 && n <= PROFILER_MAX_TASKS) taskWakes[n]++;
+#endif
+}
+
+/**
+ * @brief Asks profilerTask to print a report now.
+ */
+void profilerRequestReport() {
+  if (TaskProfiler_Handle) xTaskNotifyGive(TaskProfiler_Handle);
+}
+
+/**
+ * @brief Prints per-core, per-task and per-ISR utilization since the previous report.
+ */
+void profilerReport() {
+#if configGENERATE_RUN_TIME_STATS && configUSE_TRACE_FACILITY
+  uint32_t totalRunTime = 0;
+  UBaseType_t n = uxTaskGetSystemState(taskStatus, PROFILER_MAX_TASKS, &totalRunTime);
+  for (UBaseType_t i = 0; i < n; i++) {
+    UBaseType_t slot = uxTaskGetTaskNumber(taskStatus[i].xHandle);
+    samples[i].handle = taskStatus[i].xHandle;
+    samples[i].name = taskStatus[i].pcTaskName;
+    samples[i].runTime = taskStatus[i].ulRunTimeCounter;
+    samples[i].wakes = (slot > 0 && slot <= PROFILER_MAX_TASKS) ? taskWakes[slot] : 0;
+    samples[i].stackFree = taskStatus[i].usStackHighWaterMark;
+  }
+  const void* idle[portNUM_PROCESSORS];
+  for (int core = 0; core < portNUM_PROCESSORS; core++) idle[core] = xTaskGetIdleTaskHandleForCore(core);
+
+  if (!profAccount(&account, samples, n, totalRunTime, idle, portNUM_PROCESSORS, profIsrStats,
+                   getCpuFrequencyMhz(), &report)) {
+    Serial.println("PROF no data");
+    return;
+  }
+
+  Serial.printf("PROF window %lu ms |", (unsigned long)(report.windowUs / 1000));
+  for (int core = 0; core < report.numCores; core++) {
+    if (report.coreBusy[core] >= 0.0f) Serial.printf(" core%d busy %.1f%%", core, report.coreBusy[core]);
+  }
+  Serial.println();
+
+  Serial.println("PROF task              cpu%  wakes/s  stack_free");
+  for (int i = 0; i < report.numTasks; i++) {
+    const profTaskLine_t* t = &report.tasks[i];
+    Serial.printf("PROF %-16.16s %5.1f %8.1f %11lu\n", t->name, t->cpuPct, t->wakesPerSec,
+                  (unsigned long)t->stackFree);
+  }
+
+  for (int i = 0; i < PROF_ISR_COUNT; i++) {
+    const profIsrLine_t* r = &report.isrs[i];
+    Serial.printf("PROF isr %-16s %7.1f/s avg %.2f us max %.2f us total %.3f%%\n", r->name, r->perSec, r->avgUs,
+                  r->maxUs, r->totalPct);
+  }
+#else
+  Serial.println("PROF run-time stats disabled in FreeRTOS config");
+#endif
+}
+
+//========= TASK =========
+
+/**
+ * @brief Prints a profiler report periodically and on request.
+ *
+ * @details
+ * Sleeps for `profilerPeriodMs` (forever when 0) or until
+ * profilerRequestReport() notifies it, then prints a report. The first
+ * report covers the time since boot.
+ *
+ * @param pvParameters Unused
+ */
+void profilerTask(void* pvParameters) {
+  while (1) {
+    uint32_t period = profilerPeriodMs;
+    ulTaskNotifyTake(pdTRUE, period ? pdMS_TO_TICKS(period) : portMAX_DELAY);
+    profilerReport();
+  }
+}
+#endif
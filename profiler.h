@@ -0,0 +1,151 @@
+/**
+ * @file profiler.h
+ * @brief Per-task and per-core CPU utilization profiler.
+ *
+ * @details
+ * Collects, over a reporting window:
+ * - run time of every task and of each core's idle task (FreeRTOS run-time stats),
+ *   giving per-task CPU share and per-core busy percentage,
+ * - task wakeups (context switches into each instrumented task loop),
+ * - time spent in `echoISR` and the lock / backlight timer callbacks,
+ * - stack high-water marks.
+ *
+ * `profilerTask` prints a compact report every `profilerPeriodMs` (0 = only on
+ * request) or when `profilerRequestReport()` is called, e.g. by the serial
+ * `stats` command.
+ *
+ * The window arithmetic (`profAccount()`) works on plain task samples and has
+ * no Arduino or FreeRTOS dependencies; the board feeds it from
+ * `uxTaskGetSystemState()`, `tools/profiler_sim` feeds it synthetic windows.
+ * ISR timing uses the CPU cycle counter on the board and a monotonic
+ * nanosecond clock in host builds (`ARDUINO` undefined).
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include "esp_cpu.h"
+#define PROF_CYCLES() esp_cpu_get_cycle_count()  ///< Free-running cycle counter
+#else
+uint32_t profHostCycles();
+#define PROF_CYCLES() profHostCycles()
+#endif
+
+//========= CONFIGURATION =========
+#define PROFILER_MAX_TASKS 24            ///< Tasks tracked per report
+#define PROFILER_DEFAULT_PERIOD_MS 10000 ///< Default report period
+#define PROFILER_MAX_CORES 2             ///< Cores with an idle task to account
+
+/**
+ * @brief Instrumented interrupt / timer callbacks.
+ */
+typedef enum {
+  PROF_ISR_ECHO = 0,          ///< echoISR
+  PROF_ISR_LOCK_TIMER,        ///< onLockTimer
+  PROF_ISR_BACKLIGHT_TIMER,   ///< onBacklightTimer
+  PROF_ISR_COUNT
+} profIsr_t;
+
+/**
+ * @brief Accumulated timing of one ISR (single writer: the ISR itself).
+ */
+typedef struct {
+  volatile uint32_t count;      ///< Invocations
+  volatile uint32_t cycles;     ///< Total cycles spent (wraps, reports use deltas)
+  volatile uint32_t maxCycles;  ///< Longest invocation since the last report
+} profIsrStats_t;
+
+/**
+ * @brief One task as sampled at the end of a window.
+ */
+typedef struct {
+  const void* handle;   ///< Task identity (the FreeRTOS task handle on the board)
+  const char* name;     ///< Task name
+  uint32_t runTime;     ///< Run-time counter, microseconds (wraps)
+  uint32_t wakes;       ///< profTaskWake() calls so far (wraps)
+  uint32_t stackFree;   ///< Stack high-water mark
+} profTaskSample_t;
+
+/** @brief One task line of a report. */
+typedef struct {
+  const char* name;
+  float cpuPct;        ///< Share of the window on its core
+  float wakesPerSec;
+  uint32_t stackFree;
+} profTaskLine_t;
+
+/** @brief One ISR line of a report. */
+typedef struct {
+  const char* name;
+  float perSec;        ///< Invocations per second
+  float avgUs;         ///< Mean duration
+  float maxUs;         ///< Longest invocation in the window
+  float totalPct;      ///< Share of the window spent in the ISR
+} profIsrLine_t;
+
+/**
+ * @brief Utilization over one reporting window.
+ */
+typedef struct {
+  uint32_t windowUs;                        ///< Window length
+  uint8_t numCores;
+  float coreBusy[PROFILER_MAX_CORES];       ///< Busy percentage, < 0 if the idle task was not sampled
+  uint8_t numTasks;
+  profTaskLine_t tasks[PROFILER_MAX_TASKS];
+  profIsrLine_t isrs[PROF_ISR_COUNT];
+} profReport_t;
+
+/** @brief Previous sample of one task, for deltas. */
+typedef struct {
+  const void* handle;
+  uint32_t runTime;
+  uint32_t wakes;
+} profPrevTask_t;
+
+/**
+ * @brief Counters at the end of the previous window.
+ */
+typedef struct {
+  profPrevTask_t tasks[PROFILER_MAX_TASKS];
+  uint8_t numTasks;
+  uint32_t totalRunTime;
+  uint32_t idle[PROFILER_MAX_CORES];
+  uint32_t isrCount[PROF_ISR_COUNT];
+  uint32_t isrCycles[PROF_ISR_COUNT];
+} profAccount_t;
+
+extern profIsrStats_t profIsrStats[PROF_ISR_COUNT];
+extern volatile uint32_t profilerPeriodMs;
+
+/** @brief Marks the start of an instrumented ISR. */
+#define PROF_ISR_BEGIN() uint32_t _profStart = PROF_CYCLES()
+
+/** @brief Marks the end of an instrumented ISR and folds its duration in. */
+#define PROF_ISR_END(id)                                           \
+  do {                                                             \
+    uint32_t _profDt = PROF_CYCLES() - _profStart;                 \
+    profIsrStats[id].count++;                                      \
+    profIsrStats[id].cycles += _profDt;                            \
+    if (_profDt > profIsrStats[id].maxCycles) profIsrStats[id].maxCycles = _profDt; \
+  } while (0)
+
+//======================= API =======================//
+bool profAccount(profAccount_t* acc, const profTaskSample_t* tasks, uint8_t numTasks, uint32_t totalRunTime,
+                 const void* const* idle, uint8_t numCores, profIsrStats_t* isr, uint32_t cyclesPerUs,
+                 profReport_t* out);
+
+void profTaskWake();
+void profilerRequestReport();
+void profilerReport();
+void profilerTask(void* pvParameters);
+
+#endif
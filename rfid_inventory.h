@@ -0,0 +1,99 @@
+/**
+ * @file rfid_inventory.h
+ * @brief ISO 14443A multi-card inventory for the MFRC522 reader.
+ *
+ * @details
+ * A single inventory pass enumerates every card in the field instead of just
+ * one. Each round sends REQA (`PICC_IsNewCardPresent`), runs the cascaded
+ * anticollision/select loop (`PICC_ReadCardSerial`), records the UID and halts
+ * the card with HLTA. Halted cards stay silent to REQA, so the next round
+ * selects another card; the pass ends when REQA gets no answer.
+ *
+ * `rfidInventory()` is a template over the reader type so the same loop can be
+ * run against a host-side simulated PICC field that exposes the MFRC522 calls
+ * used here (`PICC_IsNewCardPresent`, `PICC_ReadCardSerial`, `PICC_HaltA`,
+ * `PCD_StopCrypto1` and a `uid` member).
+ *
+ * Every reader call made by a pass is counted in `rfidBatch_t::commands`,
+ * which `taskRFIDReader` feeds into the reader's SPI statistics
+ * (`rfid_power.h`).
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef RFID_INVENTORY_H
+#define RFID_INVENTORY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+//========= CONFIGURATION =========
+#define RFID_MAX_CARDS 4        ///< Cards reported per inventory pass
+#define RFID_SELECT_RETRIES 2   ///< Failed selects tolerated before the pass gives up
+#define RFID_UID_STR_LEN 30     ///< Formatted UID buffer size (10 bytes as "XX " plus the terminator)
+
+/**
+ * @brief One card found during an inventory pass.
+ */
+typedef struct {
+  uint8_t size;                  ///< UID length in bytes (4, 7 or 10)
+  uint8_t bytes[10];             ///< Raw UID
+  char str[RFID_UID_STR_LEN];    ///< Every UID byte in "DE AD BE EF" form, as used by the access list
+} rfidTag_t;
+
+/**
+ * @brief All cards found in one reader cycle, sent to taskPrinter as one queue item.
+ */
+typedef struct {
+  uint8_t count;                      ///< Valid entries in `tags`
+  uint32_t cycleUs;                   ///< Duration of the inventory pass
+  uint16_t commands;                  ///< Reader commands (SPI exchange sequences) issued by the pass
+  rfidTag_t tags[RFID_MAX_CARDS];     ///< Cards in the order they were selected
+} rfidBatch_t;
+
+/**
+ * @brief Enumerates every card in the field, halting each one as it is read.
+ *
+ * @param reader MFRC522 (or compatible simulated reader)
+ * @param batch  Receives the UIDs and the command count; `cycleUs` is left for the caller to fill
+ * @return Number of cards found
+ */
+template <class Reader>
+uint8_t rfidInventory(Reader& reader, rfidBatch_t* batch) {
+  uint8_t failures = 0;
+  batch->count = 0;
+  batch->commands = 0;
+
+  while (batch->count < RFID_MAX_CARDS) {
+    batch->commands++;
+    if (!reader.PICC_IsNewCardPresent()) break;
+    batch->commands++;
+    if (!reader.PICC_ReadCardSerial()) {
+      // collision could not be resolved this round, the card stays idle and answers the next REQA
+      if (++failures > RFID_SELECT_RETRIES) break;
+      continue;
+    }
+
+    rfidTag_t* tag = &batch->tags[batch->count++];
+    tag->size = reader.uid.size > sizeof(tag->bytes) ? sizeof(tag->bytes) : reader.uid.size;
+    memcpy(tag->bytes, reader.uid.uidByte, tag->size);
+    tag->str[0] = '\0';
+    for (uint8_t i = 0; i < tag->size; i++) {
+      size_t len = strlen(tag->str);
+      snprintf(tag->str + len, sizeof(tag->str) - len, i ? " %02X" : "%02X", tag->bytes[i]);
+    }
+
+    reader.PICC_HaltA();
+    batch->commands++;
+  }
+
+  reader.PCD_StopCrypto1();
+  batch->commands++;
+  return batch->count;
+}
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file rfid_power.cpp
+ * @brief RFID reader power state machine and its statistics.
+ *
+ * @details
+ * Times are `millis()` values; all comparisons are differences, so they
+ * survive the counter wrapping.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <string.h>
+#include "rfid_power.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+/**
+ * @brief Starts in hold-off, so the reader is polled for one hold-off after boot.
+ * @param p     State
+ * @param nowMs Current time
+ */
+void rfidPowerInit(rfidPower_t* p, uint32_t nowMs) {
+  memset(p, 0, sizeof(*p));
+  p->state = RFID_PWR_HOLDOFF;
+  p->sinceMs = nowMs;
+  p->startMs = nowMs;
+  p->wakeUsMin = UINT32_MAX;
+}
+
+/**
+ * @brief Advances the state machine.
+ *
+ * @param p         State
+ * @param present   Someone is at or approaching the door
+ * @param nowMs     Current time
+ * @param holdoffMs Time to keep polling after presence ends
+ * @return Power action the caller must apply to the reader
+ */
+rfidPowerAction_t rfidPowerUpdate(rfidPower_t* p, bool present, uint32_t nowMs, uint32_t holdoffMs) {
+  switch (p->state) {
+    case RFID_PWR_ACTIVE:
+      if (present) return RFID_PWR_NONE;
+      p->state = RFID_PWR_HOLDOFF;
+      p->sinceMs = nowMs;
+      // fall through - a zero hold-off sleeps right away
+    case RFID_PWR_HOLDOFF:
+      if (present) {
+        p->state = RFID_PWR_ACTIVE;
+        return RFID_PWR_NONE;
+      }
+      if (nowMs - p->sinceMs < holdoffMs) return RFID_PWR_NONE;
+      p->state = RFID_PWR_ASLEEP;
+      p->sinceMs = nowMs;
+      p->sleeps++;
+      p->commands += RFID_POWER_COMMANDS;
+      return RFID_PWR_SLEEP;
+    default:
+      if (!present) return RFID_PWR_NONE;
+      p->state = RFID_PWR_ACTIVE;
+      p->asleepMs += nowMs - p->sinceMs;
+      p->wakes++;
+      p->commands += RFID_POWER_COMMANDS;
+      return RFID_PWR_WAKE;
+  }
+}
+
+/**
+ * @brief Records how long the reader took from the wake decision to being ready.
+ */
+void rfidPowerWoke(rfidPower_t* p, uint32_t latencyUs) {
+  if (latencyUs < p->wakeUsMin) p->wakeUsMin = latencyUs;
+  if (latencyUs > p->wakeUsMax) p->wakeUsMax = latencyUs;
+  p->wakeUsTotal += latencyUs;
+}
+
+/**
+ * @brief Records one inventory pass and the reader commands it took.
+ */
+void rfidPowerPolled(rfidPower_t* p, uint16_t commands) {
+  p->polls++;
+  p->commands += commands;
+}
+
+/**
+ * @brief Total time asleep, including the current sleep.
+ */
+uint64_t rfidPowerAsleepMs(const rfidPower_t* p, uint32_t nowMs) {
+  return p->asleepMs + (p->state == RFID_PWR_ASLEEP ? nowMs - p->sinceMs : 0);
+}
+
+/**
+ * @brief Readable state name for the console.
+ */
+const char* rfidPowerStateName(uint8_t state) {
+  switch (state) {
+    case RFID_PWR_ACTIVE: return "active";
+    case RFID_PWR_HOLDOFF: return "hold-off";
+    case RFID_PWR_ASLEEP: return "asleep";
+    default: return "?";
+  }
+}
+
+#ifdef ARDUINO
+/**
+ * @brief Prints reader power state, SPI load and wake latency to Serial.
+ *
+ * @details Pass a copy taken under `rfidPowerMux`: taskRFIDReader updates
+ * the state and counters together under that lock, and `asleepMs` is 64
+ * bits, which the 32-bit core cannot read in one access.
+ *
+ * @param p Snapshot of the reader power state
+ */
+void rfidPowerPrintStats(const rfidPower_t* p) {
+  uint32_t nowMs = millis();
+  uint32_t upMs = nowMs - p->startMs;
+  uint64_t asleepMs = rfidPowerAsleepMs(p, nowMs);
+  double hours = upMs / 3600000.0;
+  Serial.printf("RFID reader %s, asleep %lu%% of %lu s\n", rfidPowerStateName(p->state),
+                (unsigned long)(upMs ? asleepMs * 100 / upMs : 0), (unsigned long)(upMs / 1000));
+  Serial.printf("RFID %lu commands (%lu/h), %lu polls\n", (unsigned long)p->commands,
+                (unsigned long)(hours > 0 ? p->commands / hours : 0), (unsigned long)p->polls);
+  Serial.printf("RFID %lu sleeps, %lu wakes, wake-to-ready min/avg/max %lu/%lu/%lu us\n",
+                (unsigned long)p->sleeps, (unsigned long)p->wakes,
+                (unsigned long)(p->wakes ? p->wakeUsMin : 0),
+                (unsigned long)(p->wakes ? p->wakeUsTotal / p->wakes : 0), (unsigned long)p->wakeUsMax);
+}
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file rfid_power.h
+ * @brief Presence-gated power management of the RFID reader.
+ *
+ * @details
+ * Nobody can present a badge while the ultrasonic sensor, the PIR and the
+ * approach tracker all report an empty doorway, so the reader does not need
+ * to be polled then. `taskRFIDReader` runs this state machine on every wake-up:
+ * - **Active**: someone is there (`close_dist`, `motion_detected` or
+ *   `approach_wake`); the reader is polled every `rfid_fast_poll_ms`.
+ * - **Hold-off**: presence ended less than `rfid_holdoff_ms` ago; the reader
+ *   is still polled, at `rfid_poll_ms`.
+ * - **Asleep**: the hold-off ran out; the antenna is switched off and the
+ *   PCD put into soft power-down (`PCD_AntennaOff`, `PCD_SoftPowerDown`), and
+ *   the task stops talking to the reader altogether.
+ *
+ * A presence edge in `sensorProcessTask` notifies the task, which powers the
+ * reader up (`PCD_SoftPowerUp`, `PCD_AntennaOn`) and polls immediately; the
+ * registers survive soft power-down, so no re-initialisation is needed. The
+ * MFRC522 cannot detect a card on its own with the field off, so "IRQ mode"
+ * here means the presence sensors take the place of the card-detect
+ * interrupt.
+ *
+ * The module also keeps the numbers the console's `rfid` command reports:
+ * reader commands issued (each one SPI exchange sequence, see
+ * `rfidBatch_t::commands`), time asleep, sleep/wake counts and the
+ * wake-to-ready latency. The state machine has no Arduino or FreeRTOS
+ * dependencies; `tools/door_sim` drives it against a mock reader.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef RFID_POWER_H
+#define RFID_POWER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//========= CONFIGURATION =========
+#define RFID_HOLDOFF_MS 5000        ///< Default hold-off after presence ends
+#define RFID_POWER_COMMANDS 2       ///< Reader commands per sleep or wake (power + antenna)
+
+/** @brief Reader power states. */
+typedef enum {
+  RFID_PWR_ACTIVE = 0,  ///< Someone is there, polling fast
+  RFID_PWR_HOLDOFF,     ///< Presence just ended, still polling
+  RFID_PWR_ASLEEP       ///< Powered down, not polled
+} rfidPowerState_t;
+
+/** @brief What the caller must do to the reader after an update. */
+typedef enum {
+  RFID_PWR_NONE = 0,  ///< Nothing
+  RFID_PWR_SLEEP,     ///< Antenna off, soft power-down
+  RFID_PWR_WAKE       ///< Soft power-up, antenna on, then report the latency via rfidPowerWoke()
+} rfidPowerAction_t;
+
+/**
+ * @brief State and statistics.
+ */
+typedef struct {
+  uint8_t state;          ///< ::rfidPowerState_t
+  uint32_t sinceMs;       ///< Hold-off start, or sleep start while asleep
+  uint32_t startMs;       ///< Start of the statistics
+  uint32_t commands;      ///< Reader commands issued (polling and power)
+  uint32_t polls;         ///< Inventory passes
+  uint32_t sleeps;        ///< Transitions to asleep
+  uint32_t wakes;         ///< Transitions out of asleep
+  uint64_t asleepMs;      ///< Completed time asleep
+  uint32_t wakeUsMin;     ///< Fastest wake-to-ready
+  uint32_t wakeUsMax;     ///< Slowest wake-to-ready
+  uint32_t wakeUsTotal;   ///< Sum of wake-to-ready times, for the mean
+} rfidPower_t;
+
+//======================= API =======================//
+void rfidPowerInit(rfidPower_t* p, uint32_t nowMs);
+rfidPowerAction_t rfidPowerUpdate(rfidPower_t* p, bool present, uint32_t nowMs, uint32_t holdoffMs);
+void rfidPowerWoke(rfidPower_t* p, uint32_t latencyUs);
+void rfidPowerPolled(rfidPower_t* p, uint16_t commands);
+uint64_t rfidPowerAsleepMs(const rfidPower_t* p, uint32_t nowMs);
+const char* rfidPowerStateName(uint8_t state);
+
+#ifdef ARDUINO
+void rfidPowerPrintStats(const rfidPower_t* p);
+#endif
+
+/** @brief True if the reader is powered and should be polled. */
+static inline bool rfidPowerPolling(const rfidPower_t* p) { return p->state != RFID_PWR_ASLEEP; }
+
+#endif
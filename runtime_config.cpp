@@ -0,0 +1,216 @@
+/**
+ * @file runtime_config.cpp
+ * @brief Runtime configuration: defaults, validation, publication and NVS persistence.
+ *
+ * @details
+ * See `runtime_config.h` for the publication protocol. The writer side is
+ * `cfgPublish()`; it never waits for readers. Field limits live in the
+ * `cfgFields[]` descriptor table, which also drives the console's `set` and
+ * `get` commands, so adding a parameter means adding one struct member, one
+ * default and one table row.
+ *
+ * The configuration is stored in the NVS namespace `"config"` together with
+ * `CFG_LAYOUT_VERSION` when built for the board (`ARDUINO` defined); host
+ * builds get no-op persistence.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "runtime_config.h"
+#include "door_logic.h"
+#include "approach.h"
+#include "rfid_power.h"
+
+#ifdef ARDUINO
+#include <Preferences.h>
+#endif
+
+//========= FIELD TABLE =========
+const cfgField_t cfgFields[] = {
+  { "close_sum_cm", CFG_FLOAT, offsetof(doorConfig_t, closeSumCm), 5.0f, 2000.0f, "cm" },
+  { "motion_votes", CFG_U32, offsetof(doorConfig_t, motionVotes), 0.0f, DOOR_WINDOW - 1, "samples" },
+  { "lock_ms", CFG_U32, offsetof(doorConfig_t, lockMs), 1000.0f, 120000.0f, "ms" },
+  { "backlight_ms", CFG_U32, offsetof(doorConfig_t, backlightMs), 1000.0f, 600000.0f, "ms" },
+  { "sample_ms", CFG_U32, offsetof(doorConfig_t, samplePeriodMs), 10.0f, 200.0f, "ms" },
+  { "rfid_poll_ms", CFG_U32, offsetof(doorConfig_t, rfidPollMs), 50.0f, 5000.0f, "ms" },
+  { "debounce_ms", CFG_U32, offsetof(doorConfig_t, debounceMs), 5.0f, 1000.0f, "ms" },
+  { "approach_lead_ms", CFG_U32, offsetof(doorConfig_t, approachLeadMs), 0.0f, 10000.0f, "ms" },
+  { "rfid_fast_poll_ms", CFG_U32, offsetof(doorConfig_t, rfidFastPollMs), 20.0f, 5000.0f, "ms" },
+  { "rfid_holdoff_ms", CFG_U32, offsetof(doorConfig_t, rfidHoldoffMs), 0.0f, 600000.0f, "ms" },
+};
+const int cfgNumFields = sizeof(cfgFields) / sizeof(cfgFields[0]);
+
+//========= VALUES =========
+
+/**
+ * @brief Fills a configuration with the compiled-in defaults.
+ */
+void cfgDefaults(doorConfig_t* cfg) {
+  cfg->closeSumCm = DOOR_CLOSE_SUM_CM;
+  cfg->motionVotes = DOOR_MOTION_VOTES;
+  cfg->lockMs = (uint32_t)(DOOR_LOCK_US / 1000);
+  cfg->backlightMs = (uint32_t)(DOOR_BACKLIGHT_US / 1000);
+  cfg->samplePeriodMs = DOOR_SAMPLE_MS;
+  cfg->rfidPollMs = DOOR_RFID_POLL_MS;
+  cfg->debounceMs = 50;
+  cfg->approachLeadMs = APPROACH_LEAD_MS;
+  cfg->rfidFastPollMs = DOOR_RFID_FAST_POLL_MS;
+  cfg->rfidHoldoffMs = RFID_HOLDOFF_MS;
+}
+
+/**
+ * @brief Reads a field as a float.
+ */
+float cfgGetField(const doorConfig_t* cfg, const cfgField_t* f) {
+  const uint8_t* p = (const uint8_t*)cfg + f->offset;
+  if (f->type == CFG_FLOAT) return *(const float*)p;
+  return (float)*(const uint32_t*)p;
+}
+
+/**
+ * @brief Checks every field against its limits, then the rules between fields.
+ *
+ * @details The fast RFID poll (someone approaching or present) may not be
+ * slower than the idle poll, or an approach would slow the reader down.
+ *
+ * @param cfg    Configuration to check
+ * @param err    Receives the first violation
+ * @param errLen Size of `err`
+ * @return true if the configuration may be published
+ */
+bool cfgValidate(const doorConfig_t* cfg, char* err, size_t errLen) {
+  for (int i = 0; i < cfgNumFields; i++) {
+    const cfgField_t* f = &cfgFields[i];
+    float v = cfgGetField(cfg, f);
+    if (!(v >= f->min && v <= f->max)) {  // also rejects NaN
+      snprintf(err, errLen, "%s must be %g..%g %s", f->name, f->min, f->max, f->unit);
+      return false;
+    }
+  }
+  if (cfg->rfidFastPollMs > cfg->rfidPollMs) {
+    snprintf(err, errLen, "rfid_fast_poll_ms must be <= rfid_poll_ms (%lu ms)", (unsigned long)cfg->rfidPollMs);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Looks a field up by name.
+ * @return Descriptor, or NULL if unknown
+ */
+const cfgField_t* cfgFindField(const char* name) {
+  for (int i = 0; i < cfgNumFields; i++) {
+    if (strcmp(name, cfgFields[i].name) == 0) return &cfgFields[i];
+  }
+  return NULL;
+}
+
+/**
+ * @brief Parses and range-checks one value into a configuration.
+ * @return false (with `err` set) if the text is not a number in range; `cfg` is then unchanged
+ */
+bool cfgSetField(doorConfig_t* cfg, const cfgField_t* f, const char* value, char* err, size_t errLen) {
+  char* end;
+  float v = strtof(value, &end);
+  if (end == value || *end != '\0') {
+    snprintf(err, errLen, "%s: \"%s\" is not a number", f->name, value);
+    return false;
+  }
+  if (!(v >= f->min && v <= f->max)) {
+    snprintf(err, errLen, "%s must be %g..%g %s", f->name, f->min, f->max, f->unit);
+    return false;
+  }
+  uint8_t* p = (uint8_t*)cfg + f->offset;
+  if (f->type == CFG_FLOAT) {
+    *(float*)p = v;
+  } else {
+    if (v != (float)(uint32_t)v) {
+      snprintf(err, errLen, "%s must be a whole number", f->name);
+      return false;
+    }
+    *(uint32_t*)p = (uint32_t)v;
+  }
+  return true;
+}
+
+//========= PUBLICATION =========
+
+/**
+ * @brief Initializes both slots with the same configuration, version 0.
+ */
+void cfgStoreInit(cfgStore_t* s, const doorConfig_t* initial) {
+  for (int i = 0; i < 2; i++) {
+    s->slots[i].cfg = *initial;
+    s->slots[i].seq.store(0, std::memory_order_relaxed);
+  }
+  s->version.store(0, std::memory_order_release);
+}
+
+/**
+ * @brief Publishes a new configuration. Single writer only; never blocks.
+ *
+ * @details Fills the inactive slot under its sequence number, then flips
+ * `version` so new readers pick it up. Readers still on the old slot finish
+ * undisturbed unless another publish reaches that slot first, in which case
+ * they see its sequence number change and retry.
+ */
+void cfgPublish(cfgStore_t* s, const doorConfig_t* cfg) {
+  uint32_t v = s->version.load(std::memory_order_relaxed);
+  cfgSlot_t* slot = &s->slots[(v + 1) & 1];
+  uint32_t seq = slot->seq.load(std::memory_order_relaxed);
+
+  slot->seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot->cfg = *cfg;
+  slot->seq.store(seq + 2, std::memory_order_release);
+
+  s->version.store(v + 1, std::memory_order_release);
+}
+
+//========= PERSISTENCE =========
+
+/**
+ * @brief Writes a configuration to NVS.
+ * @return true on success (always false on host builds)
+ */
+bool cfgSave(const doorConfig_t* cfg) {
+#ifdef ARDUINO
+  Preferences prefs;
+  if (!prefs.begin("config", false)) return false;
+  prefs.putUInt("layout", CFG_LAYOUT_VERSION);
+  size_t n = prefs.putBytes("cfg", cfg, sizeof(*cfg));
+  prefs.end();
+  return n == sizeof(*cfg);
+#else
+  (void)cfg;
+  return false;
+#endif
+}
+
+/**
+ * @brief Reads the saved configuration from NVS.
+ * @return false if nothing valid is stored; `cfg` is then unchanged
+ */
+bool cfgLoad(doorConfig_t* cfg) {
+#ifdef ARDUINO
+  Preferences prefs;
+  if (!prefs.begin("config", true)) return false;
+  doorConfig_t saved;
+  bool ok = prefs.getUInt("layout", 0) == CFG_LAYOUT_VERSION &&
+            prefs.getBytes("cfg", &saved, sizeof(saved)) == sizeof(saved);
+  prefs.end();
+  char err[64];
+  if (!ok || !cfgValidate(&saved, err, sizeof(err))) return false;
+  *cfg = saved;
+  return true;
+#else
+  (void)cfg;
+  return false;
+#endif
+}
@@ -0,0 +1,150 @@
+/**
+ * @file runtime_config.h
+ * @brief Runtime-tunable operating parameters with lock-free snapshot reads.
+ *
+ * @details
+ * The door's thresholds and periods live in one `doorConfig_t` block that can
+ * be changed from the serial console (`set`, `get`, `save`, `defaults`),
+ * is validated before it is published and is persisted to NVS.
+ *
+ * Publication is double-buffered and sequence checked:
+ * - The store holds two slots. The writer fills the inactive slot, bumping
+ *   that slot's sequence number to odd before and to even after, then makes it
+ *   current by incrementing `version`.
+ * - Readers take `version`, read the fields they need in place from the slot
+ *   it selects and re-check that slot's sequence number; if the writer got
+ *   around to that slot meanwhile the read is retried. Readers never lock,
+ *   never block the writer and never copy the block.
+ * - `version` doubles as a change counter: hot paths compare it against the
+ *   version they last derived values from (timer periods, tick counts) and
+ *   only re-read the block when it moved. On the 50 Hz path the cost of the
+ *   configuration is therefore one atomic load per sample.
+ *
+ * There is a single writer (the console task, or `setup()` before the tasks
+ * start). The store itself has no Arduino or FreeRTOS dependencies and is
+ * stress tested on a host by `tools/config_stress`; only the NVS persistence
+ * is compiled for the board.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef RUNTIME_CONFIG_H
+#define RUNTIME_CONFIG_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+//========= CONFIGURATION =========
+#define CFG_LAYOUT_VERSION 3  ///< Bumped when doorConfig_t changes; older NVS blobs are ignored
+
+/**
+ * @brief Operating parameters. Defaults are the `DOOR_*` constants of door_logic.h.
+ */
+typedef struct {
+  float closeSumCm;         ///< Window distance sum below which someone is "close"
+  uint32_t motionVotes;     ///< PIR-high samples in the window must exceed this
+  uint32_t lockMs;          ///< Unlock duration after a grant
+  uint32_t backlightMs;     ///< Backlight timeout
+  uint32_t samplePeriodMs;  ///< Sensor sample period
+  uint32_t rfidPollMs;      ///< RFID reader poll period
+  uint32_t debounceMs;      ///< Button debounce time
+  uint32_t approachLeadMs;  ///< Pre-wake this long before a predicted arrival (approach.h)
+  uint32_t rfidFastPollMs;  ///< RFID poll period while someone approaches or is present
+  uint32_t rfidHoldoffMs;   ///< Keep the RFID reader powered this long after presence ends (rfid_power.h)
+} doorConfig_t;
+
+/** @brief One slot of the double buffer. */
+typedef struct {
+  std::atomic<uint32_t> seq;  ///< Odd while the writer is filling the slot
+  doorConfig_t cfg;
+} cfgSlot_t;
+
+/** @brief Double-buffered configuration store. */
+typedef struct {
+  std::atomic<uint32_t> version;  ///< Published updates; the current slot is `version & 1`
+  cfgSlot_t slots[2];
+} cfgStore_t;
+
+/** @brief Field types for the descriptor table. */
+typedef enum { CFG_FLOAT = 0, CFG_U32 } cfgType_t;
+
+/** @brief Descriptor of one field, used by the console and validation. */
+typedef struct {
+  const char* name;  ///< Name used by `set` / `get`
+  uint8_t type;      ///< ::cfgType_t
+  size_t offset;     ///< offsetof(doorConfig_t, field)
+  float min;         ///< Smallest accepted value
+  float max;         ///< Largest accepted value
+  const char* unit;  ///< Unit shown by `get`
+} cfgField_t;
+
+extern const cfgField_t cfgFields[];
+extern const int cfgNumFields;
+
+//======================= API =======================//
+void cfgDefaults(doorConfig_t* cfg);
+bool cfgValidate(const doorConfig_t* cfg, char* err, size_t errLen);
+const cfgField_t* cfgFindField(const char* name);
+bool cfgSetField(doorConfig_t* cfg, const cfgField_t* f, const char* value, char* err, size_t errLen);
+float cfgGetField(const doorConfig_t* cfg, const cfgField_t* f);
+
+void cfgStoreInit(cfgStore_t* s, const doorConfig_t* initial);
+void cfgPublish(cfgStore_t* s, const doorConfig_t* cfg);
+
+/**
+ * @brief Current version; changes whenever a new configuration is published.
+ */
+static inline uint32_t cfgVersion(const cfgStore_t* s) {
+  return s->version.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Starts a read: returns the current slot and the token to validate it with.
+ */
+static inline uint32_t cfgReadBegin(const cfgStore_t* s, const doorConfig_t** cfg, uint32_t* version) {
+  for (;;) {
+    uint32_t v = s->version.load(std::memory_order_acquire);
+    const cfgSlot_t* slot = &s->slots[v & 1];
+    uint32_t seq = slot->seq.load(std::memory_order_acquire);
+    if (seq & 1) continue;  // writer lapped us and is filling this slot
+    *cfg = &slot->cfg;
+    if (version) *version = v;
+    return seq;
+  }
+}
+
+/**
+ * @brief Ends a read; false means the slot changed underneath and the read must be repeated.
+ */
+static inline bool cfgReadValid(const cfgStore_t* s, const doorConfig_t* cfg, uint32_t token) {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const cfgSlot_t* slot = &s->slots[cfg == &s->slots[0].cfg ? 0 : 1];
+  return slot->seq.load(std::memory_order_relaxed) == token;
+}
+
+/**
+ * @brief Runs `fn(const doorConfig_t&)` on a consistent snapshot, retrying if it raced the writer.
+ *
+ * @details `fn` may run more than once, so it should only read the block into
+ * locals. Returns the version the snapshot belongs to.
+ */
+template <typename Fn>
+uint32_t cfgRead(const cfgStore_t* s, Fn fn) {
+  const doorConfig_t* cfg;
+  uint32_t version;
+  uint32_t token;
+  do {
+    token = cfgReadBegin(s, &cfg, &version);
+    fn(*cfg);
+  } while (!cfgReadValid(s, cfg, token));
+  return version;
+}
+
+bool cfgSave(const doorConfig_t* cfg);
+bool cfgLoad(doorConfig_t* cfg);
+
+#endif
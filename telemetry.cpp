@@ -0,0 +1,239 @@
+/**
+ * @file telemetry.cpp
+ * @brief Producer API and batching UART writer for the binary telemetry stream.
+ *
+ * @details
+ * Producers fill a `tlmRecord_t` (header + payload) and post it to
+ * `telemetryQueue` without blocking, so the 50 Hz sensor path never waits on
+ * the UART. `telemetryTask` appends the CRC, COBS-encodes each record into a
+ * local batch buffer and hands the batch to `Serial.write()` either when it is
+ * full or when `TELEMETRY_BATCH_WINDOW_MS` has elapsed since the first pending
+ * frame. Each batch starts with an extra `0x00` so any plain-text output
+ * written since the previous batch ends up in its own (rejected) frame.
+ *
+ * Sequence numbers are assigned at the producer, so a gap seen by the host
+ * collector means a record was dropped on the device (see `telemetryDropped`).
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <Arduino.h>
+#include <string.h>
+#include "telemetry.h"
+#include "global_defs.h"
+#include "profiler.h"
+
+//========= GLOBAL VARIABLES =========
+volatile bool telemetrySampleStream = false;
+volatile uint32_t telemetryDropped = 0;
+
+static volatile uint16_t tlmSeq = 0;  ///< Next sequence number
+static portMUX_TYPE tlmMux = portMUX_INITIALIZER_UNLOCKED;
+
+//========= HELPERS =========
+
+/**
+ * @brief Fills the header, copies the payload and posts the record.
+ * @param type    Message type
+ * @param payload Payload bytes
+ * @param len     Payload length
+ */
+static void telemetryPost(uint8_t type, const void* payload, uint8_t len) {
+  if (telemetryQueue == NULL) return;
+
+  tlmRecord_t rec;
+  tlmHeader_t hdr;
+  hdr.version = TLM_PROTO_VERSION;
+  hdr.type = type;
+  portENTER_CRITICAL(&tlmMux);
+  hdr.seq = tlmSeq++;
+  portEXIT_CRITICAL(&tlmMux);
+  hdr.timestampMs = millis();
+
+  memcpy(rec.data, &hdr, sizeof(hdr));
+  memcpy(rec.data + sizeof(hdr), payload, len);
+  rec.len = sizeof(hdr) + len;
+
+  if (xQueueSend(telemetryQueue, &rec, 0) != pdPASS) {
+    telemetryDropped++;
+  }
+}
+
+/**
+ * @brief Parses a "DE AD BE EF" style UID string into raw bytes.
+ * @return Number of bytes parsed
+ */
+static uint8_t parseUid(const char* s, uint8_t* out, uint8_t maxLen) {
+  uint8_t n = 0;
+  while (*s && n < maxLen) {
+    while (*s == ' ') s++;
+    if (!s[0] || !s[1]) break;
+    char hex[3] = { s[0], s[1], 0 };
+    out[n++] = (uint8_t)strtoul(hex, NULL, 16);
+    s += 2;
+  }
+  return n;
+}
+
+//========= PRODUCER API =========
+
+/**
+ * @brief Creates the telemetry queue.
+ * @return true on success
+ */
+bool telemetryInit() {
+  telemetryQueue = xQueueCreate(TELEMETRY_QUEUE_LEN, sizeof(tlmRecord_t));
+  return telemetryQueue != NULL;
+}
+
+/**
+ * @brief Publishes one raw sensor sample (only when `telemetrySampleStream` is set).
+ * @param distanceCm  Ultrasonic distance in cm
+ * @param motionState Raw PIR level
+ * @param closeDist   Current proximity decision
+ * @param motion      Current motion decision
+ */
+void telemetrySensorSample(float distanceCm, int motionState, bool closeDist, bool motion) {
+  if (!telemetrySampleStream) return;
+  tlmSensorSample_t p;
+  p.distanceMm = (uint16_t)(distanceCm * 10.0f);
+  p.motion = (uint8_t)motionState;
+  p.flags = (closeDist ? 0x01 : 0) | (motion ? 0x02 : 0);
+  telemetryPost(TLM_SENSOR_SAMPLE, &p, sizeof(p));
+}
+
+/**
+ * @brief Publishes a presence start/end edge.
+ * @param present   true when presence started, false when it ended
+ * @param closeDist Proximity decision at the edge
+ * @param motion    Motion decision at the edge
+ */
+void telemetryDetectionEdge(bool present, bool closeDist, bool motion) {
+  tlmDetectionEdge_t p;
+  p.present = present ? 1 : 0;
+  p.flags = (closeDist ? 0x01 : 0) | (motion ? 0x02 : 0);
+  telemetryPost(TLM_DETECTION_EDGE, &p, sizeof(p));
+}
+
+/**
+ * @brief Publishes the outcome of an RFID scan.
+ * @param decision ::TelemetryDecision
+ * @param uidStr   UID as formatted by taskRFIDReader
+ */
+void telemetryAccessDecision(uint8_t decision, const char* uidStr) {
+  tlmAccessDecision_t p;
+  memset(&p, 0, sizeof(p));
+  p.decision = decision;
+  p.uidLen = parseUid(uidStr, p.uid, sizeof(p.uid));
+  telemetryPost(TLM_ACCESS_DECISION, &p, sizeof(p));
+}
+
+/**
+ * @brief Publishes a servo lock state change.
+ * @param locked     true when locked
+ * @param servoAngle Commanded servo angle
+ */
+void telemetryLockState(bool locked, uint8_t servoAngle) {
+  tlmLockState_t p;
+  p.locked = locked ? 1 : 0;
+  p.servoAngle = servoAngle;
+  telemetryPost(TLM_LOCK_STATE, &p, sizeof(p));
+}
+
+/**
+ * @brief Publishes anomalies raised by the streaming detector.
+ * @param events  Bitmask of `ANOMALY_*` flags
+ * @param bucket  Time-of-day bucket
+ * @param dwellMs Current presence dwell
+ */
+void telemetryAnomaly(uint8_t events, uint8_t bucket, uint32_t dwellMs) {
+  tlmAnomaly_t p;
+  p.events = events;
+  p.bucket = bucket;
+  uint32_t dwellS = dwellMs / 1000;
+  p.dwellS = dwellS > 0xFFFF ? 0xFFFF : (uint16_t)dwellS;
+  telemetryPost(TLM_ANOMALY, &p, sizeof(p));
+}
+
+/**
+ * @brief Publishes an alert raised by the event correlator.
+ * @param alert One `CORR_ALERT_*` flag
+ */
+void telemetryAlert(uint8_t alert) {
+  tlmAlert_t p;
+  p.alert = alert;
+  telemetryPost(TLM_ALERT, &p, sizeof(p));
+}
+
+/**
+ * @brief Publishes the summary of a presence that just ended (see presence.h).
+ * @param startMs    First detecting sample
+ * @param durationMs First to last detecting sample
+ * @param samples    Detecting samples
+ * @param minMm      Closest echo, 0 if none
+ * @param meanMm     Mean echo distance, 0 if none
+ */
+void telemetryPresence(uint32_t startMs, uint32_t durationMs, uint32_t samples, uint16_t minMm, uint16_t meanMm) {
+  tlmPresence_t p;
+  p.startMs = startMs;
+  p.durationMs = durationMs;
+  p.samples = samples;
+  p.minMm = minMm;
+  p.meanMm = meanMm;
+  telemetryPost(TLM_PRESENCE, &p, sizeof(p));
+}
+
+//========= TASK =========
+
+/**
+ * @brief Frames queued records and writes them to Serial in batches.
+ *
+ * @details
+ * - Appends CRC-16 and COBS-encodes each record into a local batch buffer.
+ * - Flushes when the next frame would not fit, or `TELEMETRY_BATCH_WINDOW_MS`
+ *   after the first frame of the batch was queued.
+ *
+ * @param pvParameters Unused
+ */
+void telemetryTask(void* pvParameters) {
+  static uint8_t batch[TELEMETRY_BATCH_BYTES];
+  size_t batchLen = 0;
+  TickType_t batchStart = 0;
+  tlmRecord_t rec;
+  uint8_t raw[TLM_MAX_RECORD];
+
+  while (1) {
+    profTaskWake();
+    TickType_t wait = portMAX_DELAY;
+    if (batchLen > 0) {
+      TickType_t elapsed = xTaskGetTickCount() - batchStart;
+      TickType_t window = pdMS_TO_TICKS(TELEMETRY_BATCH_WINDOW_MS);
+      wait = (elapsed >= window) ? 0 : window - elapsed;
+    }
+
+    if (xQueueReceive(telemetryQueue, &rec, wait) == pdTRUE) {
+      memcpy(raw, rec.data, rec.len);
+      uint16_t crc = tlmCrc16(raw, rec.len);
+      raw[rec.len] = crc & 0xFF;
+      raw[rec.len + 1] = crc >> 8;
+
+      if (batchLen + TLM_MAX_FRAME > sizeof(batch)) {
+        Serial.write(batch, batchLen);
+        batchLen = 0;
+      }
+      if (batchLen == 0) {
+        // leading delimiter closes any plain-text output that preceded this batch
+        batch[batchLen++] = 0x00;
+        batchStart = xTaskGetTickCount();
+      }
+      batchLen += tlmCobsEncode(raw, rec.len + TLM_CRC_SIZE, batch + batchLen);
+    } else if (batchLen > 0) {
+      // — batch window expired —
+      Serial.write(batch, batchLen);
+      batchLen = 0;
+    }
+  }
+}
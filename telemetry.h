@@ -0,0 +1,54 @@
+/**
+ * @file telemetry.h
+ * @brief Binary telemetry stream for the Smart Security Door system.
+ *
+ * @details
+ * Tasks publish typed events (sensor samples, detection edges, presence summaries,
+ * access decisions, lock state changes, anomalies and alerts) through the non-blocking `telemetry*` functions below.
+ * Records are queued, COBS framed with a CRC by `telemetryTask`, and written to
+ * `Serial` in batches so the UART sees a few large writes instead of many small
+ * formatted prints. The wire format is described in `telemetry_proto.h` and is
+ * decoded on a Linux host by `tools/telemetry_collector`.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include <stdint.h>
+#include "telemetry_proto.h"
+
+//========= CONFIGURATION =========
+#define TELEMETRY_QUEUE_LEN 32       ///< Records buffered between producers and telemetryTask
+#define TELEMETRY_BATCH_BYTES 256    ///< Flush once this many encoded bytes are pending
+#define TELEMETRY_BATCH_WINDOW_MS 50 ///< Flush at most this long after the first pending frame
+
+/**
+ * @brief Unencoded record as passed through `telemetryQueue`.
+ */
+typedef struct {
+  uint8_t len;                                            ///< Header + payload length
+  uint8_t data[sizeof(tlmHeader_t) + TLM_MAX_PAYLOAD];   ///< Header followed by payload
+} tlmRecord_t;
+
+extern volatile bool telemetrySampleStream;  ///< Emit every 50 Hz sample when true (off by default)
+extern volatile uint32_t telemetryDropped;   ///< Records dropped because the queue was full
+
+//======================= API =======================//
+bool telemetryInit();
+void telemetryTask(void* pvParameters);
+
+void telemetrySensorSample(float distanceCm, int motionState, bool closeDist, bool motion);
+void telemetryDetectionEdge(bool present, bool closeDist, bool motion);
+void telemetryAccessDecision(uint8_t decision, const char* uidStr);
+void telemetryLockState(bool locked, uint8_t servoAngle);
+void telemetryAnomaly(uint8_t events, uint8_t bucket, uint32_t dwellMs);
+void telemetryAlert(uint8_t alert);
+void telemetryPresence(uint32_t startMs, uint32_t durationMs, uint32_t samples, uint16_t minMm, uint16_t meanMm);
+
+#endif
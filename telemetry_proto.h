@@ -0,0 +1,206 @@
+/**
+ * @file telemetry_proto.h
+ * @brief Binary telemetry wire format shared by the firmware and the host collector.
+ *
+ * @details
+ * Every telemetry record is a small, typed, versioned message:
+ *
+ *     [ header (8 B) | payload (type dependent) | CRC-16/CCITT-FALSE (2 B, LE) ]
+ *
+ * The whole record is COBS encoded and terminated by a single `0x00` byte, so a
+ * receiver can resynchronise on any zero byte (including after plain-text
+ * `Serial.print` output that shares the same UART). All multi-byte fields are
+ * little-endian, which matches both the ESP32 and x86/ARM hosts.
+ *
+ * This header has no Arduino or FreeRTOS dependencies so it can be included by
+ * the Linux collector in `tools/telemetry_collector`.
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#ifndef TELEMETRY_PROTO_H
+#define TELEMETRY_PROTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//========= PROTOCOL CONSTANTS =========
+#define TLM_PROTO_VERSION 1   ///< Bumped whenever a payload layout changes
+#define TLM_MAX_PAYLOAD 16    ///< Largest payload of any message type
+#define TLM_CRC_SIZE 2        ///< Trailing CRC-16 size in bytes
+
+/**
+ * @brief Telemetry message types.
+ */
+enum TelemetryMsgType : uint8_t {
+  TLM_SENSOR_SAMPLE = 1,    ///< One 50 Hz ultrasonic + PIR sample
+  TLM_DETECTION_EDGE = 2,   ///< Presence started / ended
+  TLM_ACCESS_DECISION = 3,  ///< Result of an RFID scan
+  TLM_LOCK_STATE = 4,       ///< Servo moved to locked / unlocked
+  TLM_ANOMALY = 5,          ///< Anomaly raised by the streaming detector
+  TLM_ALERT = 6,            ///< Alert raised by the event correlator
+  TLM_PRESENCE = 7          ///< Summary of a presence that just ended
+};
+
+/**
+ * @brief Outcome of an RFID scan as reported in ::TLM_ACCESS_DECISION.
+ */
+enum TelemetryDecision : uint8_t {
+  TLM_DECISION_GRANTED = 0,  ///< New authorized tag, door unlocked
+  TLM_DECISION_REGRANT = 1,  ///< Same authorized tag re-scanned while locked
+  TLM_DECISION_IGNORED = 2,  ///< Same authorized tag re-scanned while unlocked
+  TLM_DECISION_DENIED = 3    ///< Unknown tag
+};
+
+//========= MESSAGE LAYOUT =========
+#pragma pack(push, 1)
+
+/** @brief Common header carried by every record. */
+typedef struct {
+  uint8_t version;        ///< ::TLM_PROTO_VERSION
+  uint8_t type;           ///< ::TelemetryMsgType
+  uint16_t seq;           ///< Per-boot sequence number, gaps mean dropped records
+  uint32_t timestampMs;   ///< `millis()` at the time of the event
+} tlmHeader_t;
+
+/** @brief ::TLM_SENSOR_SAMPLE payload. */
+typedef struct {
+  uint16_t distanceMm;  ///< Ultrasonic distance in mm, 0 = no echo
+  uint8_t motion;       ///< Raw PIR level
+  uint8_t flags;        ///< bit0 = close_dist, bit1 = motion_detected
+} tlmSensorSample_t;
+
+/** @brief ::TLM_DETECTION_EDGE payload. */
+typedef struct {
+  uint8_t present;  ///< 1 = presence started, 0 = presence ended
+  uint8_t flags;    ///< bit0 = close_dist, bit1 = motion_detected
+} tlmDetectionEdge_t;
+
+/** @brief ::TLM_ACCESS_DECISION payload. */
+typedef struct {
+  uint8_t decision;  ///< ::TelemetryDecision
+  uint8_t uidLen;    ///< Number of valid bytes in `uid`
+  uint8_t uid[10];   ///< Raw UID bytes
+} tlmAccessDecision_t;
+
+/** @brief ::TLM_LOCK_STATE payload. */
+typedef struct {
+  uint8_t locked;      ///< 1 = locked, 0 = unlocked
+  uint8_t servoAngle;  ///< Commanded servo angle in degrees
+} tlmLockState_t;
+
+/** @brief ::TLM_ANOMALY payload. */
+typedef struct {
+  uint8_t events;    ///< Bitmask of `ANOMALY_*` flags (see anomaly.h)
+  uint8_t bucket;    ///< Time-of-day bucket the anomaly was judged against
+  uint16_t dwellS;   ///< Current presence dwell in seconds (0 if none)
+} tlmAnomaly_t;
+
+/** @brief ::TLM_ALERT payload. */
+typedef struct {
+  uint8_t alert;  ///< One `CORR_ALERT_*` flag (see correlator.h)
+} tlmAlert_t;
+
+/** @brief ::TLM_PRESENCE payload (see presence.h). */
+typedef struct {
+  uint32_t startMs;     ///< `millis()` of the first detecting sample
+  uint32_t durationMs;  ///< First to last detecting sample
+  uint32_t samples;     ///< Detecting samples
+  uint16_t minMm;       ///< Closest echo, 0 if none
+  uint16_t meanMm;      ///< Mean echo distance, 0 if none
+} tlmPresence_t;
+
+#pragma pack(pop)
+
+#define TLM_MAX_RECORD (sizeof(tlmHeader_t) + TLM_MAX_PAYLOAD + TLM_CRC_SIZE)  ///< Largest unencoded record
+#define TLM_MAX_FRAME (TLM_MAX_RECORD + TLM_MAX_RECORD / 254 + 2)             ///< Largest COBS frame incl. delimiter
+
+//========= HELPERS =========
+
+/**
+ * @brief Expected payload size for a message type.
+ * @param type Message type
+ * @return Payload size in bytes, or -1 for an unknown type
+ */
+static inline int tlmPayloadSize(uint8_t type) {
+  switch (type) {
+    case TLM_SENSOR_SAMPLE: return sizeof(tlmSensorSample_t);
+    case TLM_DETECTION_EDGE: return sizeof(tlmDetectionEdge_t);
+    case TLM_ACCESS_DECISION: return sizeof(tlmAccessDecision_t);
+    case TLM_LOCK_STATE: return sizeof(tlmLockState_t);
+    case TLM_ANOMALY: return sizeof(tlmAnomaly_t);
+    case TLM_ALERT: return sizeof(tlmAlert_t);
+    case TLM_PRESENCE: return sizeof(tlmPresence_t);
+    default: return -1;
+  }
+}
+
+/**
+ * @brief CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF).
+ * @param data Input bytes
+ * @param len  Number of bytes
+ * @return CRC value
+ */
+static inline uint16_t tlmCrc16(const uint8_t* data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < len; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+/**
+ * @brief COBS-encodes a buffer and appends the `0x00` frame delimiter.
+ * @param in  Raw record
+ * @param len Record length
+ * @param out Output buffer, at least `len + len / 254 + 2` bytes
+ * @return Number of bytes written to `out`, including the delimiter
+ */
+static inline size_t tlmCobsEncode(const uint8_t* in, size_t len, uint8_t* out) {
+  size_t codeIdx = 0;
+  size_t o = 1;
+  uint8_t code = 1;
+  for (size_t i = 0; i < len; i++) {
+    if (in[i] == 0) {
+      out[codeIdx] = code;
+      codeIdx = o++;
+      code = 1;
+    } else {
+      out[o++] = in[i];
+      if (++code == 0xFF) {
+        out[codeIdx] = code;
+        codeIdx = o++;
+        code = 1;
+      }
+    }
+  }
+  out[codeIdx] = code;
+  out[o++] = 0x00;
+  return o;
+}
+
+/**
+ * @brief Decodes one COBS frame (without its `0x00` delimiter).
+ * @param in  Encoded bytes
+ * @param len Encoded length
+ * @param out Output buffer, at least `len` bytes
+ * @return Decoded length, or 0 if the frame is malformed
+ */
+static inline size_t tlmCobsDecode(const uint8_t* in, size_t len, uint8_t* out) {
+  size_t i = 0, o = 0;
+  while (i < len) {
+    uint8_t code = in[i++];
+    if (code == 0 || i + code - 1 > len) return 0;
+    for (uint8_t k = 1; k < code; k++) out[o++] = in[i++];
+    if (code != 0xFF && i < len) out[o++] = 0;
+  }
+  return o;
+}
+
+#endif
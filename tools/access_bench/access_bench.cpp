@@ -0,0 +1,280 @@
+/**
+ * @file access_bench.cpp
+ * @brief Host benchmark of the compiled access schedules.
+ *
+ * @details
+ * Generates a large random policy (10 000 credentials by default, schedules
+ * of several overlapping windows including overnight ones, holidays and
+ * expiry dates), compiles it with `accessCompile()` and times `accessCheck()`
+ * over a fixed set of random scans. The same scans are decided by a direct
+ * evaluator over the source rules (linear UID search, per-window tests), which
+ * serves both as the cost baseline and as a cross-check: any scan where the
+ * two disagree is reported and makes the benchmark fail.
+ *
+ * Build:
+ *     g++ -std=c++17 -O2 -I../.. -o access_bench access_bench.cpp ../../access_schedule.cpp
+ *
+ * Usage:
+ *     access_bench [--creds 10000] [--schedules 64] [--scans 1000000] [--seed 1]
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "access_schedule.h"
+
+/** @brief One generated scan. */
+typedef struct {
+  std::string uid;
+  uint64_t key;
+  uint16_t year;
+  uint8_t month, day, hour, minute;
+} scan_t;
+
+static double nowSeconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//========= REFERENCE EVALUATOR =========
+
+/**
+ * @brief Decides a scan straight from the rules, evaluating every window.
+ */
+static accessResult_t referenceCheck(const accessPolicy_t* p, const std::vector<uint16_t>& holidayDays,
+                                     const std::vector<uint16_t>& expiry, const scan_t& s) {
+  int found = -1;
+  for (int i = 0; i < p->numCredentials; i++) {
+    if (strcmp(p->credentials[i].uid, s.uid.c_str()) == 0) {
+      found = i;
+      break;
+    }
+  }
+  if (found < 0) return ACCESS_UNKNOWN;
+
+  uint16_t day = accessDayNumber(s.year, s.month, s.day);
+  if (day > expiry[found]) return ACCESS_EXPIRED;
+
+  bool holiday = false;
+  for (uint16_t h : holidayDays) holiday |= (h == day);
+  int dow = (day + 6) % 7;
+  int prevDow = (dow + 6) % 7;
+  int minute = s.hour * 60 + s.minute;
+
+  const accessScheduleDef_t* sched = &p->schedules[p->credentials[found].schedule];
+  for (int w = 0; w < sched->numWindows; w++) {
+    const accessWindow_t* win = &sched->windows[w];
+    bool wraps = win->end <= win->start;
+    if (holiday) {
+      if (!(win->days & ACCESS_HOLIDAY)) continue;
+      if (wraps ? (minute >= win->start || minute < win->end) : (minute >= win->start && minute < win->end))
+        return ACCESS_OK;
+    } else {
+      bool today = win->days & (1 << dow);
+      bool yesterday = win->days & (1 << prevDow);
+      if (!wraps && today && minute >= win->start && minute < win->end) return ACCESS_OK;
+      if (wraps && today && minute >= win->start) return ACCESS_OK;
+      if (wraps && yesterday && minute < win->end) return ACCESS_OK;
+    }
+  }
+  return ACCESS_OUT_OF_HOURS;
+}
+
+//========= MAIN =========
+
+int main(int argc, char** argv) {
+  int numCreds = 10000, numSchedules = 64, numScans = 1000000;
+  uint64_t seed = 1;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--creds")) numCreds = atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--schedules")) numSchedules = atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--scans")) numScans = atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--seed")) seed = strtoull(argv[i + 1], NULL, 10);
+    else {
+      fprintf(stderr, "usage: %s [--creds N] [--schedules N] [--scans N] [--seed S]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (numCreds < 1 || numCreds > 65535 || numSchedules < 1 || numSchedules > 255 || numScans < 1) {
+    fprintf(stderr, "out of range\n");
+    return 2;
+  }
+  std::mt19937_64 rng(seed);
+  auto pick = [&](int n) { return (int)(rng() % (uint64_t)n); };
+
+  // Schedules: 4-10 windows on 15-minute boundaries, about one in five overnight
+  std::vector<std::vector<accessWindow_t>> windows(numSchedules);
+  std::vector<std::string> schedNames(numSchedules);
+  std::vector<accessScheduleDef_t> schedules(numSchedules);
+  for (int i = 0; i < numSchedules; i++) {
+    int n = 4 + pick(7);
+    for (int w = 0; w < n; w++) {
+      accessWindow_t win;
+      win.days = (uint8_t)(1 + pick(255));
+      win.start = (uint16_t)(pick(96) * ACCESS_SLOT_MIN);
+      int len = (pick(5) == 0 ? 16 + pick(40) : 1 + pick(40)) * ACCESS_SLOT_MIN;
+      win.end = (uint16_t)((win.start + len) % 1440);
+      windows[i].push_back(win);
+    }
+    schedNames[i] = "s" + std::to_string(i);
+    schedules[i] = { schedNames[i].c_str(), windows[i].data(), (uint8_t)n };
+  }
+
+  // Holidays: 15 per year in 2025-2026
+  std::vector<std::string> holidayStr;
+  std::vector<uint16_t> holidayDays;
+  for (int y = 2025; y <= 2026; y++) {
+    for (int k = 0; k < 15; k++) {
+      char buf[16];
+      int m = 1 + pick(12), d = 1 + pick(28);
+      snprintf(buf, sizeof(buf), "%04d-%02d-%02d", y, m, d);
+      uint16_t dn = accessDayNumber((uint16_t)y, (uint8_t)m, (uint8_t)d);
+      bool dup = false;
+      for (uint16_t h : holidayDays) dup |= (h == dn);
+      if (dup) continue;
+      holidayStr.push_back(buf);
+      holidayDays.push_back(dn);
+    }
+  }
+  std::vector<const char*> holidays;
+  for (auto& h : holidayStr) holidays.push_back(h.c_str());
+
+  // Credentials: unique 4- or 7-byte UIDs, 60% with an expiry in 2025-2026
+  std::vector<std::string> uids, expiries;
+  std::vector<uint16_t> expiryDays;
+  std::vector<uint64_t> keys;
+  std::vector<accessCredentialDef_t> creds(numCreds);
+  uids.reserve(numCreds);
+  expiries.reserve(numCreds);
+  std::unordered_set<uint64_t> seen;
+  while ((int)uids.size() < numCreds) {
+    uint8_t bytes[7];
+    uint8_t len = pick(4) == 0 ? 7 : 4;
+    std::string s;
+    for (int b = 0; b < len; b++) {
+      char hex[4];
+      bytes[b] = (uint8_t)rng();
+      snprintf(hex, sizeof(hex), b ? " %02X" : "%02X", bytes[b]);
+      s += hex;
+    }
+    uint64_t key = accessKeyFromBytes(bytes, len);
+    if (!seen.insert(key).second) continue;
+    uids.push_back(s);
+    keys.push_back(key);
+    if (pick(10) < 6) {
+      char buf[16];
+      int y = 2025 + pick(2), m = 1 + pick(12), d = 1 + pick(28);
+      snprintf(buf, sizeof(buf), "%04d-%02d-%02d", y, m, d);
+      expiries.push_back(buf);
+      expiryDays.push_back(accessDayNumber((uint16_t)y, (uint8_t)m, (uint8_t)d));
+    } else {
+      expiries.push_back("");
+      expiryDays.push_back(ACCESS_NEVER_EXPIRES);
+    }
+  }
+  for (int i = 0; i < numCreds; i++) {
+    creds[i] = { uids[i].c_str(), (uint8_t)pick(numSchedules), expiries[i].empty() ? NULL : expiries[i].c_str() };
+  }
+
+  accessPolicy_t policy = { schedules.data(), (uint8_t)numSchedules, creds.data(), (uint16_t)numCreds,
+                            holidays.data(), (uint8_t)holidays.size() };
+
+  // Compile
+  std::vector<accessCredential_t> credStorage(numCreds);
+  std::vector<accessSchedule_t> schedStorage(numSchedules);
+  accessTable_t table;
+  accessTableInit(&table, credStorage.data(), (uint16_t)numCreds, schedStorage.data(), (uint8_t)numSchedules);
+  char err[96];
+  double t0 = nowSeconds();
+  if (!accessCompile(&table, &policy, err, sizeof(err))) {
+    fprintf(stderr, "compile failed: %s\n", err);
+    return 1;
+  }
+  double compileS = nowSeconds() - t0;
+
+  // Scans: 80% known badges, times spread over 2025-2026
+  std::vector<scan_t> scans(numScans);
+  for (auto& s : scans) {
+    if (pick(10) < 8) {
+      int i = pick(numCreds);
+      s.uid = uids[i];
+      s.key = keys[i];
+    } else {
+      uint8_t bytes[4] = { (uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng(), (uint8_t)rng() };
+      char buf[16];
+      snprintf(buf, sizeof(buf), "%02X %02X %02X %02X", bytes[0], bytes[1], bytes[2], bytes[3]);
+      s.uid = buf;
+      s.key = accessKeyFromBytes(bytes, 4);
+    }
+    s.year = (uint16_t)(2025 + pick(2));
+    s.month = (uint8_t)(1 + pick(12));
+    s.day = (uint8_t)(1 + pick(28));
+    s.hour = (uint8_t)pick(24);
+    s.minute = (uint8_t)pick(60);
+  }
+
+  // Compiled path: time resolution + lookup, as done per scan on the door
+  std::vector<uint8_t> fast(numScans);
+  t0 = nowSeconds();
+  for (int i = 0; i < numScans; i++) {
+    const scan_t& s = scans[i];
+    accessTime_t at;
+    accessTimeFromCalendar(&table, s.year, s.month, s.day, s.hour, s.minute, &at);
+    fast[i] = (uint8_t)accessCheck(&table, s.key, &at);
+  }
+  double fastS = nowSeconds() - t0;
+
+  // Lookup alone, time already resolved
+  std::vector<accessTime_t> times(numScans);
+  for (int i = 0; i < numScans; i++) {
+    const scan_t& s = scans[i];
+    accessTimeFromCalendar(&table, s.year, s.month, s.day, s.hour, s.minute, &times[i]);
+  }
+  unsigned granted = 0;
+  t0 = nowSeconds();
+  for (int i = 0; i < numScans; i++) granted += accessCheck(&table, scans[i].key, &times[i]) == ACCESS_OK;
+  double lookupS = nowSeconds() - t0;
+
+  // Reference path over a subset (it is much slower)
+  int refScans = numScans < 20000 ? numScans : 20000;
+  unsigned mismatches = 0;
+  t0 = nowSeconds();
+  for (int i = 0; i < refScans; i++) {
+    accessResult_t r = referenceCheck(&policy, holidayDays, expiryDays, scans[i]);
+    if (r != (accessResult_t)fast[i]) {
+      if (++mismatches <= 5) {
+        const scan_t& s = scans[i];
+        fprintf(stderr, "mismatch: %s %04u-%02u-%02u %02u:%02u compiled=%s reference=%s\n", s.uid.c_str(),
+                s.year, s.month, s.day, s.hour, s.minute, accessResultName((accessResult_t)fast[i]),
+                accessResultName(r));
+      }
+    }
+  }
+  double refS = nowSeconds() - t0;
+
+  unsigned counts[5] = {};
+  for (uint8_t r : fast) counts[r]++;
+
+  size_t bytes = table.numCreds * sizeof(accessCredential_t) + table.numSchedules * sizeof(accessSchedule_t) +
+                 sizeof(table.holidays);
+  printf("policy: %d credentials, %d schedules, %zu holidays\n", numCreds, numSchedules, holidays.size());
+  printf("tables: %zu B (%zu B/credential, %zu B/schedule, %zu B holidays), compiled in %.2f ms\n", bytes,
+         sizeof(accessCredential_t), sizeof(accessSchedule_t), sizeof(table.holidays), compileS * 1e3);
+  printf("results: ok %u, unknown %u, expired %u, out_of_hours %u (granted %u)\n", counts[ACCESS_OK],
+         counts[ACCESS_UNKNOWN], counts[ACCESS_EXPIRED], counts[ACCESS_OUT_OF_HOURS], granted);
+  printf("compiled:  %7.1f ns/decision incl. time resolution, %7.1f ns lookup only (%d scans)\n",
+         fastS * 1e9 / numScans, lookupS * 1e9 / numScans, numScans);
+  printf("reference: %7.1f ns/decision (%d scans), %.0fx slower\n", refS * 1e9 / refScans, refScans,
+         (refS / refScans) / (fastS / numScans));
+  printf("cross-check: %u mismatches\n", mismatches);
+  return mismatches ? 1 : 0;
+}
@@ -0,0 +1,305 @@
+/**
+ * @file anomaly_replay.cpp
+ * @brief Replays sensor traces through the anomaly detector and measures its per-sample cost.
+ *
+ * @details
+ * `--scenarios` builds traces of 20 ms samples from scripted segments (so
+ * long at some hour, present or not, at some PIR duty cycle, with an RFID
+ * scan at the start) and compares the loitering, denial-burst and
+ * high-activity events with the expected counts. The scripts cover a quiet
+ * door, loitering against the cold threshold and a learned dwell baseline,
+ * a scan ending the loitering watch, a visit inside the learned spread, a
+ * bucket that has not learned yet, denials inside and outside the burst
+ * window and a PIR duty window above its baseline. The exit status is
+ * non-zero on any mismatch.
+ *
+ * Recorded mode reads the CSV written by `tools/telemetry_collector` (from a
+ * file or stdin; the firmware must be streaming raw samples). Every `sample`
+ * record goes through the presence tracker and `anomalyOnSample()`, every
+ * `access` record through `anomalyOnScan()`, as in `core1.cpp`. The events
+ * are printed in the collector's own `anomaly` format. The capture carries
+ * no wall-clock time, so `--hour H` gives the hour of its first sample.
+ *
+ * `--bench N` times `anomalyOnSample()` on N samples, the mean and the tail
+ * of single calls, against the 20 ms sample period it has to fit in.
+ *
+ * Build:
+ *     g++ -std=c++17 -O2 -I../.. -o anomaly_replay anomaly_replay.cpp ../../anomaly.cpp ../../presence.cpp
+ *
+ * Usage:
+ *     anomaly_replay --scenarios
+ *     anomaly_replay [--hour H] [capture.csv]
+ *     anomaly_replay --bench 10000000
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "anomaly.h"
+#include "presence.h"
+
+#define SAMPLE_MS 20  ///< Firmware sample period (DOOR_SAMPLE_MS), also the per-sample budget
+
+//========= SCRIPTED TRACES =========
+
+enum { SCAN_NONE = 0, SCAN_GRANTED, SCAN_DENIED };
+
+/** @brief One stretch of samples with the same inputs. */
+typedef struct {
+  uint32_t ms;    ///< Length of the stretch
+  uint8_t hour;   ///< RTC hour
+  float cm;       ///< Distance, 0 for no echo
+  bool present;   ///< Presence decision
+  float duty;     ///< Fraction of samples with PIR high
+  uint8_t scan;   ///< Scan at the start of the stretch
+} segment_t;
+
+/** @brief A scripted trace and the events it must raise. */
+typedef struct {
+  const char* name;
+  std::vector<segment_t> segments;
+  unsigned loiter;    ///< Expected ANOMALY_LOITERING events
+  unsigned denials;   ///< Expected ANOMALY_DENIAL_BURST events
+  unsigned activity;  ///< Expected ANOMALY_HIGH_ACTIVITY events
+} scenario_t;
+
+static segment_t idle(uint32_t ms, uint8_t hour = 10) { return { ms, hour, 0.0f, false, 0.0f, SCAN_NONE }; }
+static segment_t near(uint32_t ms, uint8_t hour = 10) { return { ms, hour, 45.0f, true, 0.0f, SCAN_NONE }; }
+static segment_t pir(uint32_t ms, float duty) { return { ms, 10, 0.0f, false, duty, SCAN_NONE }; }
+static segment_t scan(segment_t s, uint8_t result) {
+  s.scan = result;
+  return s;
+}
+
+/** @brief Appends `n` visits alternating between two dwell times, each followed by 20 s of nothing. */
+static void visits(std::vector<segment_t>* v, int n, uint32_t shortMs, uint32_t longMs, uint8_t hour = 10) {
+  for (int i = 0; i < n; i++) {
+    v->push_back(near(i & 1 ? longMs : shortMs, hour));
+    v->push_back(idle(20000, hour));
+  }
+}
+
+static std::vector<scenario_t> scenarios() {
+  std::vector<scenario_t> v;
+  v.push_back({ "quiet door", { idle(600000) }, 0, 0, 0 });
+  v.push_back({ "loitering, cold bucket", { idle(1000), near(150000), idle(1000) }, 1, 0, 0 });
+  v.push_back({ "scan ends loitering watch", { near(5000), scan(near(145000), SCAN_GRANTED), idle(1000) }, 0, 0, 0 });
+
+  scenario_t learned = { "loitering, learned dwell", {}, 1, 0, 0 };
+  visits(&learned.segments, 25, 8000, 12000);
+  learned.segments.push_back(near(45000));
+  learned.segments.push_back(idle(1000));
+  v.push_back(learned);
+
+  scenario_t spread = { "visit inside learned spread", {}, 0, 0, 0 };
+  visits(&spread.segments, 25, 36000, 44000);
+  spread.segments.push_back(near(45000));
+  spread.segments.push_back(idle(1000));
+  v.push_back(spread);
+
+  scenario_t cold = { "other bucket still learning", {}, 0, 0, 0 };
+  visits(&cold.segments, 25, 8000, 12000);
+  cold.segments.push_back(near(45000, 22));
+  cold.segments.push_back(idle(1000, 22));
+  v.push_back(cold);
+
+  v.push_back({ "denial burst",
+                { scan(idle(10000), SCAN_DENIED), scan(idle(10000), SCAN_DENIED), scan(idle(1000), SCAN_DENIED) },
+                0, 1, 0 });
+  v.push_back({ "denials outside window",
+                { scan(idle(40000), SCAN_DENIED), scan(idle(40000), SCAN_DENIED), scan(idle(1000), SCAN_DENIED) },
+                0, 0, 0 });
+
+  const uint32_t window = ANOMALY_DUTY_WINDOW * SAMPLE_MS;
+  scenario_t busy = { "high PIR activity", {}, 0, 0, 1 };
+  for (int i = 0; i < 25; i++) busy.segments.push_back(pir(window, i & 1 ? 0.07f : 0.03f));
+  busy.segments.push_back(pir(window, 0.6f));
+  v.push_back(busy);
+  return v;
+}
+
+/** @brief Event counts of one run. */
+typedef struct {
+  unsigned loiter, denials, activity;
+} counts_t;
+
+static void count(counts_t* c, uint8_t events) {
+  c->loiter += (events & ANOMALY_LOITERING) != 0;
+  c->denials += (events & ANOMALY_DENIAL_BURST) != 0;
+  c->activity += (events & ANOMALY_HIGH_ACTIVITY) != 0;
+}
+
+/**
+ * @brief Runs one scenario; returns true if the events match.
+ */
+static bool runScenario(const scenario_t& sc) {
+  anomalyDetector_t det;
+  anomalyInit(&det);
+  counts_t c = { 0, 0, 0 };
+  uint32_t t = 0;
+  unsigned samples = 0;
+  for (const segment_t& seg : sc.segments) {
+    if (seg.scan != SCAN_NONE) count(&c, anomalyOnScan(&det, t, seg.scan == SCAN_GRANTED));
+    float acc = 0.0f;
+    for (uint32_t ms = 0; ms < seg.ms; ms += SAMPLE_MS, t += SAMPLE_MS, samples++) {
+      acc += seg.duty;
+      bool high = acc >= 1.0f;
+      if (high) acc -= 1.0f;
+      count(&c, anomalyOnSample(&det, t, seg.hour, seg.cm, high, seg.present));
+    }
+  }
+
+  bool ok = c.loiter == sc.loiter && c.denials == sc.denials && c.activity == sc.activity;
+  printf("%-30s %6u samples: loitering %u, denial bursts %u, high activity %u  %s\n", sc.name, samples, c.loiter,
+         c.denials, c.activity, ok ? "ok" : "FAIL");
+  if (!ok) printf("    expected loitering %u, denial bursts %u, high activity %u\n", sc.loiter, sc.denials, sc.activity);
+  return ok;
+}
+
+static int runScenarios() {
+  int failed = 0;
+  for (const scenario_t& sc : scenarios()) failed += !runScenario(sc);
+  printf("%d scenario(s) failed\n", failed);
+  return failed ? 1 : 0;
+}
+
+//========= RECORDED TRACES =========
+
+/**
+ * @brief Replays the `sample` and `access` records of a collector CSV.
+ * @param in    Capture
+ * @param hour0 Hour of day of the first record
+ */
+static int replay(FILE* in, unsigned hour0) {
+  anomalyDetector_t det;
+  anomalyInit(&det);
+  presenceTracker_t presence;
+  presenceInit(&presence);
+  char line[256];
+  unsigned samples = 0, scans = 0, anomalies = 0;
+  bool first = true;
+  uint32_t t0 = 0;
+  while (fgets(line, sizeof(line), in)) {
+    unsigned t, seq, pirLevel, close, motion;
+    char type[16], decision[16];
+    float cm;
+    if (sscanf(line, "%u,%u,%15[^,],", &t, &seq, type) != 3) continue;
+    if (first) {
+      t0 = t;
+      first = false;
+    }
+    uint8_t hour = (uint8_t)((hour0 + (t - t0) / 3600000u) % 24);
+    uint8_t events;
+
+    if (!strcmp(type, "sample") &&
+        sscanf(line, "%u,%u,%15[^,],%f,%u,%u,%u", &t, &seq, type, &cm, &pirLevel, &close, &motion) == 7) {
+      samples++;
+      presenceSummary_t s;
+      presenceUpdate(&presence, t, (uint16_t)lroundf(cm * 10.0f), close, motion, &s);
+      events = anomalyOnSample(&det, t, hour, cm, pirLevel, presenceActive(&presence));
+    } else if (!strcmp(type, "access") && sscanf(line, "%u,%u,%15[^,],%15[^,]", &t, &seq, type, decision) == 4) {
+      scans++;
+      events = anomalyOnScan(&det, t, strcmp(decision, "denied") != 0);
+    } else {
+      continue;
+    }
+    if (events) {
+      anomalies++;
+      uint32_t dwellMs = anomalyPresenceMs(&det, t);
+      printf("%u,anomaly,%u,%u,%u\n", t, events, anomalyBucketForHour(hour), (unsigned)(dwellMs / 1000));
+    }
+  }
+  fprintf(stderr, "%u samples, %u scans: %u anomalies\n", samples, scans, anomalies);
+  return 0;
+}
+
+//========= BENCHMARK =========
+
+/** @brief Synthetic sample input. */
+typedef struct {
+  float cm;
+  bool pir;
+  bool present;
+} input_t;
+
+static int runBench(long n) {
+  std::vector<input_t> z;
+  uint32_t seed = 1;
+  while ((long)z.size() < n) {
+    seed = seed * 1103515245u + 12345u;
+    uint32_t len = 1 + (seed >> 16) % 500;
+    bool present = (seed & 0x300) == 0;
+    for (uint32_t i = 0; i < len && (long)z.size() < n; i++) {
+      seed = seed * 1103515245u + 12345u;
+      z.push_back({ present ? 30.0f + (seed >> 24) % 50 : 0.0f, (seed & 0x1000) != 0, present });
+    }
+  }
+
+  // mean: one timed loop over every sample
+  anomalyDetector_t det;
+  anomalyInit(&det);
+  unsigned events = 0;
+  uint32_t t = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (const input_t& s : z) {
+    t += SAMPLE_MS;
+    events += anomalyOnSample(&det, t, (t / 3600000u) % 24, s.cm, s.pir, s.present) != ANOMALY_NONE;
+  }
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  // tail: every call timed on its own (includes the clock overhead; the
+  // maximum also catches host preemption, so the 99.99th percentile is the useful figure)
+  anomalyInit(&det);
+  t = 0;
+  std::vector<float> ns(z.size());
+  for (size_t i = 0; i < z.size(); i++) {
+    t += SAMPLE_MS;
+    auto a = std::chrono::steady_clock::now();
+    anomalyOnSample(&det, t, (t / 3600000u) % 24, z[i].cm, z[i].pir, z[i].present);
+    ns[i] = std::chrono::duration<float, std::nano>(std::chrono::steady_clock::now() - a).count();
+  }
+  std::sort(ns.begin(), ns.end());
+  float p9999 = ns[(size_t)(ns.size() * 0.9999)];
+
+  double mean = sec * 1e9 / n;
+  double budgetNs = SAMPLE_MS * 1e6;
+  printf("%ld samples in %.3f s: mean %.1f ns, p99.99 %.0f ns, max %.0f ns per sample, %u events, state %zu B\n", n,
+         sec, mean, p9999, ns.back(), events, sizeof(anomalyDetector_t));
+  printf("%d ms sample budget: mean uses %.5f%%, p99.99 %.5f%% (host CPU)\n", SAMPLE_MS, 100.0 * mean / budgetNs,
+         100.0 * p9999 / budgetNs);
+  return 0;
+}
+
+//========= MAIN =========
+
+int main(int argc, char** argv) {
+  if (argc == 2 && !strcmp(argv[1], "--scenarios")) return runScenarios();
+  if (argc == 3 && !strcmp(argv[1], "--bench")) return runBench(atol(argv[2]));
+
+  unsigned hour0 = 12;
+  FILE* in = stdin;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--hour") && i + 1 < argc) {
+      hour0 = (unsigned)atoi(argv[++i]) % 24;
+    } else if (argv[i][0] != '-' && in == stdin) {
+      in = fopen(argv[i], "r");
+      if (!in) {
+        perror(argv[i]);
+        return 2;
+      }
+    } else {
+      fprintf(stderr, "usage: %s --scenarios | [--hour H] [capture.csv] | --bench N\n", argv[0]);
+      return 2;
+    }
+  }
+  return replay(in, hour0);
+}
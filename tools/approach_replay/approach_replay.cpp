@@ -0,0 +1,346 @@
+/**
+ * @file approach_replay.cpp
+ * @brief Validates the approach tracker on recorded and synthetic walk-up traces.
+ *
+ * @details
+ * Recorded mode reads the CSV written by `tools/telemetry_collector` (from a
+ * file or stdin; the firmware must be streaming raw samples), feeds every
+ * `sample` record through `approachUpdate()` with the time step taken from
+ * the timestamps, and prints the wake and release events the firmware would
+ * have raised. `--trace` also prints the estimate after every sample.
+ *
+ * `--synthetic` generates seeded scenes with sensor noise, dropped echoes and
+ * spikes, optionally with a wall behind the door as background:
+ * - **walk-up**: someone walks up to the reader at 0.7–1.8 m/s, waits, leaves;
+ * - **passer-by**: someone crosses the beam at 0.6–3 m;
+ * - **loiterer**: someone stands 0.8–2.5 m away;
+ * - **walk-away**: someone steps into the beam at 0.8 m and leaves.
+ *
+ * For walk-ups it reports how far ahead of the arrival (true distance
+ * reaching `APPROACH_ARRIVE_MM`) the wake came, next to the static proximity
+ * flag of `doorSensorUpdate()`, and the velocity error while walking; for the
+ * other scenes it counts wakes as false. The exit status is non-zero if fewer
+ * than 95 % of walk-ups wake at least 1 s ahead of arrival, if any wake is
+ * left unreleased after the scene, or if more than 2 % of the other scenes
+ * wake.
+ *
+ * `--emit SEED` writes one synthetic walk-up as collector CSV, for feeding
+ * back through recorded mode; `--bench N` times the tracker on N samples.
+ *
+ * Build:
+ *     g++ -std=c++17 -O2 -I../.. -o approach_replay approach_replay.cpp ../../approach.cpp ../../door_logic.cpp
+ *
+ * Usage:
+ *     approach_replay [--lead MS] [--trace] [capture.csv]
+ *     approach_replay [--lead MS] --synthetic [SCENES_PER_KIND]
+ *     approach_replay --emit 7 | approach_replay --trace
+ *     approach_replay --bench 10000000
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "approach.h"
+#include "door_logic.h"
+
+static uint32_t leadMs = APPROACH_LEAD_MS;
+
+//========= RECORDED TRACES =========
+
+static void printEvents(uint8_t ev, uint32_t t, const approachTracker_t* a) {
+  if (ev & APPROACH_WAKE) {
+    printf("%u,approach,wake,%d,%d,%u\n", t, (int)approachDistanceMm(a), (int)approachVelocityMms(a),
+           a->ttaMs == APPROACH_NO_ARRIVAL ? 0 : a->ttaMs);
+  }
+  if (ev & APPROACH_RELEASED) printf("%u,approach,release\n", t);
+}
+
+/**
+ * @brief Replays the `sample` records of a collector CSV.
+ */
+static int replay(FILE* in, bool trace) {
+  approachTracker_t a;
+  approachInit(&a);
+  char line[256];
+  unsigned samples = 0;
+  bool havePrev = false;
+  uint32_t prevT = 0;
+  while (fgets(line, sizeof(line), in)) {
+    unsigned t, seq;
+    char type[16];
+    float cm;
+    if (sscanf(line, "%u,%u,%15[^,],%f", &t, &seq, type, &cm) != 4 || strcmp(type, "sample")) continue;
+    uint32_t dt = havePrev ? t - prevT : DOOR_SAMPLE_MS;
+    havePrev = true;
+    prevT = t;
+    samples++;
+
+    uint8_t ev = approachUpdate(&a, (uint16_t)lroundf(cm * 10.0f), dt, leadMs);
+    if (trace) {
+      printf("%u,estimate,%u,%d,%d,%d\n", t, (unsigned)lroundf(cm * 10.0f),
+             a.tracking ? (int)approachDistanceMm(&a) : -1, a.tracking ? (int)approachVelocityMms(&a) : 0,
+             a.ttaMs == APPROACH_NO_ARRIVAL ? -1 : (int)a.ttaMs);
+    }
+    printEvents(ev, t, &a);
+  }
+  fprintf(stderr, "%u samples: %u wakes, %u tracks dropped, awake at end %u\n", samples, a.wakes, a.dropped,
+          a.awake);
+  return 0;
+}
+
+//========= SYNTHETIC SCENES =========
+
+typedef enum { SCENE_WALKUP = 0, SCENE_PASSER, SCENE_LOITER, SCENE_WALKAWAY, SCENE_KINDS } sceneKind_t;
+static const char* kSceneNames[] = { "walk-up", "passer-by", "loiterer", "walk-away" };
+
+/** @brief One generated scene: measured and true distance per 20 ms sample. */
+typedef struct {
+  std::vector<uint16_t> measured;  ///< What the sensor reports, mm (0 = no echo)
+  std::vector<float> truth;        ///< Person's distance, mm (0 = not in the beam)
+  std::vector<float> trueV;        ///< Person's radial velocity, mm/s
+  int arrival;                     ///< Sample at which truth reaches APPROACH_ARRIVE_MM, -1 if never
+  int walkEnd;                     ///< Last sample of steady walking (walk-up only)
+} scene_t;
+
+/**
+ * @brief Appends a straight walk from `from` to `to` at `speed` mm/s, with gait sway.
+ */
+static void walk(scene_t* s, float from, float to, float speed, std::mt19937* rng) {
+  std::uniform_real_distribution<float> phase(0, 6.283f);
+  float ph = phase(*rng);
+  float dir = to < from ? -1.0f : 1.0f;
+  int n = (int)(fabsf(to - from) / speed * 1000.0f / DOOR_SAMPLE_MS);
+  for (int i = 1; i <= n; i++) {
+    float x = from + dir * speed * i * DOOR_SAMPLE_MS / 1000.0f;
+    float t = i * DOOR_SAMPLE_MS / 1000.0f;
+    s->truth.push_back(x + 25.0f * sinf(6.283f * 1.8f * t + ph));  // torso sway at step rate
+    s->trueV.push_back(dir * speed);
+  }
+}
+
+/** @brief Appends `ms` of someone standing at `at`. */
+static void stand(scene_t* s, float at, int ms, std::mt19937* rng) {
+  std::uniform_real_distribution<float> phase(0, 6.283f);
+  float ph = phase(*rng);
+  for (int i = 0; i < ms / DOOR_SAMPLE_MS; i++) {
+    s->truth.push_back(at + 15.0f * sinf(6.283f * 0.4f * i * DOOR_SAMPLE_MS / 1000.0f + ph));
+    s->trueV.push_back(0);
+  }
+}
+
+/** @brief Appends `ms` with nobody in the beam. */
+static void empty(scene_t* s, int ms) {
+  for (int i = 0; i < ms / DOOR_SAMPLE_MS; i++) {
+    s->truth.push_back(0);
+    s->trueV.push_back(0);
+  }
+}
+
+/**
+ * @brief Generates one scene of the given kind, then the sensor's view of it.
+ */
+static scene_t makeScene(sceneKind_t kind, uint32_t seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> u(0, 1);
+  auto range = [&](float lo, float hi) { return lo + (hi - lo) * u(rng); };
+  scene_t s;
+  s.arrival = -1;
+  s.walkEnd = -1;
+
+  empty(&s, (int)range(500, 2000));
+  switch (kind) {
+    case SCENE_WALKUP: {
+      float speed = range(700, 1800), enter = range(2500, 3800), stop = range(250, 380);
+      walk(&s, enter, 700, speed, &rng);
+      s.walkEnd = (int)s.truth.size() - 1;
+      walk(&s, 700, stop, speed * 0.4f, &rng);  // slows down for the last steps
+      stand(&s, stop, (int)range(2000, 4000), &rng);
+      walk(&s, stop, 3500, range(700, 1500), &rng);
+      break;
+    }
+    case SCENE_PASSER:
+      stand(&s, range(600, 3000), (int)range(300, 1500), &rng);
+      break;
+    case SCENE_LOITER:
+      stand(&s, range(800, 2500), (int)range(5000, 10000), &rng);
+      break;
+    case SCENE_WALKAWAY:
+      stand(&s, 800, (int)range(300, 800), &rng);
+      walk(&s, 800, 3500, range(700, 1500), &rng);
+      break;
+    default:
+      break;
+  }
+  empty(&s, 2000);
+
+  for (size_t i = 0; i < s.truth.size(); i++) {
+    if (s.arrival < 0 && s.truth[i] > 0 && s.truth[i] <= APPROACH_ARRIVE_MM) s.arrival = (int)i;
+  }
+
+  // sensor: noise, lost echoes, spikes, and a wall behind the door in half the scenes
+  float wall = u(rng) < 0.5f ? range(3000, 4500) : 0;
+  std::normal_distribution<float> noise(0, 10);
+  for (float x : s.truth) {
+    float z = x > 0 ? x : wall;
+    float p = u(rng);
+    if (p < 0.03f) z = 0;                          // echo lost
+    else if (p < 0.04f) z = range(200, 4000);      // spurious echo
+    else if (z > 0) z += noise(rng);
+    if (z > 4000 || z < 0) z = 0;                  // out of the sensor's range
+    s.measured.push_back((uint16_t)lroundf(z));
+  }
+  return s;
+}
+
+/** @brief Outcome of running the tracker and the static flag over one scene. */
+typedef struct {
+  int wakeAt;            ///< First wake sample, -1 if none
+  int closeAt;           ///< First static proximity sample, -1 if none
+  bool awakeAtEnd;       ///< Wake still raised after the scene
+  double vErr2;          ///< Sum of squared velocity errors while walking
+  int vCount;            ///< Samples in vErr2
+} sceneResult_t;
+
+static sceneResult_t runScene(const scene_t& s) {
+  approachTracker_t a;
+  approachInit(&a);
+  doorSensorState_t w;
+  doorSensorInit(&w);
+  sceneResult_t r = { -1, -1, false, 0, 0 };
+
+  for (size_t i = 0; i < s.measured.size(); i++) {
+    uint8_t ev = approachUpdate(&a, s.measured[i], DOOR_SAMPLE_MS, leadMs);
+    if ((ev & APPROACH_WAKE) && r.wakeAt < 0) r.wakeAt = (int)i;
+
+    bool closeNow, motionNow;
+    doorSensorUpdate(&w, s.measured[i] / 10.0f, false, DOOR_CLOSE_SUM_CM, DOOR_MOTION_VOTES, &closeNow,
+                     &motionNow);
+    if (closeNow && r.closeAt < 0) r.closeAt = (int)i;
+
+    if ((int)i <= s.walkEnd && a.tracking && a.age >= APPROACH_MIN_AGE && s.truth[i] > 0) {
+      double e = approachVelocityMms(&a) - s.trueV[i];
+      r.vErr2 += e * e;
+      r.vCount++;
+    }
+  }
+  r.awakeAtEnd = a.awake;
+  return r;
+}
+
+static int runSynthetic(int perKind) {
+  int failed = 0;
+  printf("lead %u ms, %d scenes per kind\n", leadMs, perKind);
+  for (int k = 0; k < SCENE_KINDS; k++) {
+    int woke = 0, wokeEarly = 0, closeSeen = 0, stuck = 0;
+    std::vector<int> leads, closeLeads;
+    double vErr2 = 0;
+    long vCount = 0;
+    for (int i = 0; i < perKind; i++) {
+      scene_t s = makeScene((sceneKind_t)k, 1000u * k + i + 1);
+      sceneResult_t r = runScene(s);
+      stuck += r.awakeAtEnd;
+      vErr2 += r.vErr2;
+      vCount += r.vCount;
+      if (r.wakeAt >= 0) woke++;
+      if (k != SCENE_WALKUP) continue;
+      if (r.wakeAt >= 0) {
+        int lead = (s.arrival - r.wakeAt) * DOOR_SAMPLE_MS;
+        leads.push_back(lead);
+        wokeEarly += lead >= 1000;
+      }
+      if (r.closeAt >= 0) {
+        closeSeen++;
+        closeLeads.push_back((s.arrival - r.closeAt) * DOOR_SAMPLE_MS);
+      }
+    }
+
+    if (k == SCENE_WALKUP) {
+      std::sort(leads.begin(), leads.end());
+      std::sort(closeLeads.begin(), closeLeads.end());
+      auto pct = [](const std::vector<int>& v, double p) { return v.empty() ? 0 : v[(size_t)(p * (v.size() - 1))]; };
+      bool ok = wokeEarly * 100 >= perKind * 95 && stuck == 0;
+      printf("%-4s %-10s woke %d/%d, >=1 s ahead %d; lead ms p5/p50/p95 %d/%d/%d; velocity rms %.0f mm/s\n",
+             ok ? "ok" : "FAIL", kSceneNames[k], woke, perKind, wokeEarly, pct(leads, 0.05), pct(leads, 0.5),
+             pct(leads, 0.95), vCount ? sqrt(vErr2 / vCount) : 0.0);
+      printf("     static proximity flag: fired %d/%d, lead ms p50 %d\n", closeSeen, perKind, pct(closeLeads, 0.5));
+      failed += !ok;
+    } else {
+      bool ok = woke * 100 <= perKind * 2 && stuck == 0;
+      printf("%-4s %-10s false wakes %d/%d\n", ok ? "ok" : "FAIL", kSceneNames[k], woke, perKind);
+      failed += !ok;
+    }
+    if (stuck) printf("     %d scenes left a wake raised\n", stuck);
+  }
+  return failed ? 1 : 0;
+}
+
+static int emit(uint32_t seed) {
+  scene_t s = makeScene(SCENE_WALKUP, seed);
+  printf("t_ms,seq,type,fields...\n");
+  for (size_t i = 0; i < s.measured.size(); i++) {
+    printf("%zu,%zu,sample,%.1f,0,0,0\n", i * DOOR_SAMPLE_MS, i, s.measured[i] / 10.0);
+  }
+  fprintf(stderr, "arrival at %d ms\n", s.arrival * DOOR_SAMPLE_MS);
+  return 0;
+}
+
+//========= BENCHMARK =========
+
+static int runBench(long n) {
+  std::vector<uint16_t> z;
+  for (uint32_t seed = 1; (long)z.size() < n; seed++) {
+    scene_t s = makeScene((sceneKind_t)(seed % SCENE_KINDS), seed);
+    z.insert(z.end(), s.measured.begin(), s.measured.end());
+  }
+  z.resize(n);
+
+  approachTracker_t a;
+  approachInit(&a);
+  unsigned wakes = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (uint16_t mm : z) wakes += approachUpdate(&a, mm, DOOR_SAMPLE_MS, leadMs) & APPROACH_WAKE;
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  printf("%ld samples in %.3f s: %.1f ns/sample, %u wakes, state %zu B\n", n, s, s * 1e9 / n, wakes,
+         sizeof(approachTracker_t));
+  return 0;
+}
+
+//========= MAIN =========
+
+int main(int argc, char** argv) {
+  bool trace = false;
+  int i = 1;
+  for (; i < argc; i++) {
+    if (!strcmp(argv[i], "--lead") && i + 1 < argc) leadMs = (uint32_t)atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--trace")) trace = true;
+    else break;
+  }
+  if (i < argc && !strcmp(argv[i], "--synthetic")) return runSynthetic(i + 1 < argc ? atoi(argv[i + 1]) : 500);
+  if (i + 1 < argc && !strcmp(argv[i], "--emit")) return emit((uint32_t)atoi(argv[i + 1]));
+  if (i + 1 < argc && !strcmp(argv[i], "--bench")) return runBench(atol(argv[i + 1]));
+
+  FILE* in = stdin;
+  if (i + 1 == argc && argv[i][0] != '-') {
+    in = fopen(argv[i], "r");
+    if (!in) {
+      perror(argv[i]);
+      return 2;
+    }
+  } else if (i != argc) {
+    fprintf(stderr,
+            "usage: %s [--lead MS] [--trace] [capture.csv] | --synthetic [N] | --emit SEED | --bench N\n",
+            argv[0]);
+    return 2;
+  }
+  return replay(in, trace);
+}
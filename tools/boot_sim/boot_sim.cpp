@@ -0,0 +1,413 @@
+/**
+ * @file boot_sim.cpp
+ * @brief Measures the boot schedule on a host with modelled stage durations.
+ *
+ * @details
+ * Drives the firmware's boot scheduler (`boot.h`) against a virtual
+ * microsecond clock. The stage table mirrors the one in
+ * `EEP590C_final_project.ino`: the same names, dependencies, cores and
+ * critical flags. Each init function is replaced by a duration, estimated
+ * from the delays in the libraries it calls:
+ * - `PCD_Init()` waits 50 ms after its hard reset;
+ * - `LiquidCrystal_I2C::begin()` waits 50 ms plus the HD44780 init sequence,
+ *   and the labels go out one expander write at a time;
+ * - NVS reads take a few ms.
+ * On the device, the console's `boot` command prints the measured numbers.
+ *
+ * Worker 0 is setup() on core 1. Worker 1 is the helper task on core 0.
+ * With `--workers 1`, setup() runs every stage, which is the helper-less
+ * fallback. For comparison the tool also times the old `setup()`: the same
+ * work done serially in its original order, plus its `delay(50)` after the
+ * servo write and the RTC read it made before creating any task. There, the
+ * door was only usable once every task existed.
+ *
+ * `--fail a,b` makes those stages' init functions fail. `--fault` injects a
+ * failure that only a later stage sees: a missing telemetry or correlator
+ * queue, which bootQueues() tolerates and bootServices() reports. The tool
+ * prints the resulting report: which stages were skipped or failed and
+ * whether the door is degraded. `--jitter N` repeats the boot N times with every duration scaled
+ * by a random factor in 0.5–2x. `--scenarios` checks:
+ * - that every single-stage failure still completes the boot, skips exactly
+ *   the stages that transitively need it and flags degradation exactly when
+ *   a critical stage is lost;
+ * - that a missing telemetry or correlator queue fails the services stage
+ *   (instead of starting a task on a NULL queue) without degrading the door;
+ * - that a forward dependency is rejected;
+ * - that pinned stages run on their core;
+ * - that two stages touching the same unlocked driver (LEDC, SPI, Wire) never
+ *   run at the same time, over many boots with jittered durations;
+ * - that the clock is readable when the door is reported ready;
+ * - that two workers make the door ready sooner than one.
+ *
+ * Build:
+ *     g++ -std=c++17 -O2 -I../.. -o boot_sim boot_sim.cpp ../../boot.cpp
+ *
+ * Usage:
+ *     boot_sim [--workers 1|2] [--fail rfid,lcd] [--fault telemetry-queue,corr-queue] [--jitter 1000]
+ *              [--seed 1]
+ *     boot_sim --scenarios
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "boot.h"
+
+//========= STAGE TABLE (mirrors the sketch) =========
+
+enum BootStage {
+  STAGE_SERVO = 0,
+  STAGE_GPIO,
+  STAGE_CONFIG,
+  STAGE_ACCESS,
+  STAGE_QUEUES,
+  STAGE_TIMERS,
+  STAGE_RFID,
+  STAGE_DOOR_TASKS,
+  STAGE_READER_TASK,
+  STAGE_SENSORS,
+  STAGE_I2C,
+  STAGE_RTC,
+  STAGE_LCD,
+  STAGE_I2C_BUS,
+  STAGE_DISPLAY,
+  STAGE_SERVICES,
+  STAGE_COUNT
+};
+
+#define B(stage) BOOT_BIT(STAGE_##stage)
+static const bootStage_t kStages[STAGE_COUNT] = {
+  { "servo", NULL, 0, 0, BOOT_ANY_CORE, true },
+  { "gpio", NULL, 0, 0, BOOT_ANY_CORE, true },
+  { "config", NULL, 0, 0, BOOT_ANY_CORE, true },
+  { "access", NULL, 0, 0, BOOT_ANY_CORE, true },
+  { "queues", NULL, 0, 0, BOOT_ANY_CORE, true },
+  { "timers", NULL, 0, 0, BOOT_ANY_CORE, true },
+  { "rfid", NULL, 0, 0, BOOT_ANY_CORE, true },
+  { "door tasks", NULL, B(QUEUES) | B(TIMERS), B(SERVO) | B(CONFIG) | B(ACCESS), BOOT_ANY_CORE, true },
+  { "reader task", NULL, B(RFID) | B(QUEUES) | B(CONFIG), 0, BOOT_ANY_CORE, true },
+  { "sensors", NULL, B(GPIO) | B(QUEUES) | B(TIMERS) | B(CONFIG), B(READER_TASK), 1, true },
+  { "i2c", NULL, 0, 0, 0, true },
+  { "rtc", NULL, B(I2C), 0, 0, true },
+  { "lcd", NULL, B(I2C), B(RTC), 0, false },
+  { "i2c bus", NULL, B(I2C), B(RTC) | B(LCD), 0, true },
+  { "display", NULL, B(I2C_BUS) | B(LCD), 0, BOOT_ANY_CORE, false },
+  { "services", NULL, 0, B(QUEUES) | B(CONFIG), BOOT_ANY_CORE, false },
+};
+#undef B
+
+/** @brief Modelled init time of each stage, µs. */
+static const uint32_t kStageUs[STAGE_COUNT] = {
+  180,    // servo: LEDC timers and channels for the servo and the LED, first write
+  40,     // gpio
+  4000,   // config: NVS open and blob read
+  200,    // access: compile 4 credentials, 3 schedules
+  80,     // queues
+  120,    // timers
+  51000,  // rfid: PCD_Init hard reset (50 ms) and register setup
+  250,    // door tasks
+  120,    // reader task
+  300,    // sensors: two tasks and the echo interrupt
+  500,    // i2c
+  1200,   // rtc: probe and lostPower() read
+  76000,  // lcd: HD44780 init (~65 ms), clear, 15 characters of labels
+  200,    // i2c bus
+  120,    // display
+  500,    // services: four tasks
+};
+
+/** @brief Driver state a stage touches without a lock of its own. */
+enum {
+  RES_LEDC = 1 << 0,  ///< LEDC timer / channel allocation
+  RES_SPI = 1 << 1,   ///< SPI2 and the MFRC522
+  RES_WIRE = 1 << 2,  ///< Wire and the devices on it
+};
+
+static const uint8_t kStageRes[STAGE_COUNT] = {
+  RES_LEDC,  // servo (and the LED PWM)
+  0,         // gpio
+  0,         // config: NVS locks itself
+  0,         // access
+  0,         // queues
+  0,         // timers
+  RES_SPI,   // rfid
+  0,         // door tasks
+  0,         // reader task
+  0,         // sensors
+  RES_WIRE,  // i2c
+  RES_WIRE,  // rtc
+  RES_WIRE,  // lcd
+  RES_WIRE,  // i2c bus: the bus task takes Wire over
+  0,         // display
+  0,         // services
+};
+
+/**
+ * @brief Faults that fail no stage by themselves, only through what a later
+ * stage finds (`--fault`).
+ */
+enum {
+  FAULT_TELEMETRY_QUEUE = 1 << 0,  ///< telemetryInit() fails; bootQueues() still succeeds
+  FAULT_CORR_QUEUE = 1 << 1,       ///< corrQueue creation fails; bootQueues() still succeeds
+};
+static const char* kFaultNames[] = { "telemetry-queue", "corr-queue" };
+
+static uint32_t simFaults = 0;  ///< FAULT_* injected into the next simulate()
+
+#define OLD_SERVO_DELAY_US 50000  ///< delay(50) after the servo write in the old setup()
+#define OLD_TIMESTAMP_US 1500     ///< RTC read through the bus manager before any task existed
+
+static const int kOldOrder[] = {
+  STAGE_GPIO, STAGE_I2C, STAGE_LCD, STAGE_SERVO, STAGE_RTC, STAGE_CONFIG, STAGE_ACCESS, STAGE_I2C_BUS,
+  STAGE_TIMERS, STAGE_RFID, STAGE_QUEUES, STAGE_READER_TASK, STAGE_DOOR_TASKS, STAGE_SENSORS, STAGE_DISPLAY,
+  STAGE_SERVICES
+};  ///< Order of the work in the old setup()
+
+//========= SIMULATION =========
+
+/**
+ * @brief Outcome of a stage's init function, as the sketch computes it.
+ * @details bootServices() fails when a queue it would start a reader for is
+ * missing, so it does not start telemetryTask or correlatorTask on a NULL queue.
+ */
+static bool stageOk(int stage, uint32_t failed) {
+  if (failed & BOOT_BIT(stage)) return false;
+  if (stage == STAGE_SERVICES) return !(simFaults & (FAULT_TELEMETRY_QUEUE | FAULT_CORR_QUEUE));
+  return true;
+}
+
+/**
+ * @brief Boots the plan on virtual workers.
+ *
+ * @param b       Plan, initialised here
+ * @param stages  Stage table
+ * @param workers 1 or 2
+ * @param failed  Mask of stages whose init fails
+ * @param scale   Per-stage duration factors, or NULL
+ * @return false if the schedule stalled (a bug in the scheduler or the table)
+ */
+static bool simulate(bootPlan_t* b, const bootStage_t* stages, int workers, uint32_t failed, const double* scale) {
+  char err[96];
+  if (!bootPlanInit(b, stages, STAGE_COUNT, err, sizeof(err))) {
+    fprintf(stderr, "plan rejected: %s\n", err);
+    return false;
+  }
+  const uint8_t cores[2] = { (uint8_t)(workers == 1 ? BOOT_ANY_CORE : 1), 0 };
+  int running[2] = { -1, -1 };
+  uint32_t until[2] = { 0, 0 };
+  uint32_t t = 0;
+  while (1) {
+    bool done = false;
+    for (int w = 0; w < workers; w++) {
+      if (running[w] >= 0) continue;
+      int s = bootClaim(b, cores[w], t);
+      if (s == BOOT_DONE) done = true;
+      if (s < 0) continue;
+      running[w] = s;
+      until[w] = t + (uint32_t)(kStageUs[s] * (scale ? scale[s] : 1.0));
+    }
+
+    int next = -1;
+    for (int w = 0; w < workers; w++)
+      if (running[w] >= 0 && (next < 0 || until[w] < until[next])) next = w;
+    if (next < 0) return done;  // nothing running and nothing claimable
+
+    t = until[next];
+    bootFinish(b, running[next], stageOk(running[next], failed), t);
+    running[next] = -1;
+  }
+}
+
+/** @brief The old setup(): everything serial, the door usable after the last task. */
+static uint32_t oldSetupUs(const double* scale) {
+  uint32_t t = OLD_SERVO_DELAY_US + OLD_TIMESTAMP_US;
+  for (int s : kOldOrder) t += (uint32_t)(kStageUs[s] * (scale ? scale[s] : 1.0));
+  return t;
+}
+
+static void printReport(const bootPlan_t* b) {
+  printf("  %-14s %4s %9s %9s %9s  %s\n", "stage", "core", "start ms", "ready ms", "took ms", "result");
+  for (uint8_t i = 0; i < b->count; i++) {
+    const char* core = b->core[i] == BOOT_ANY_CORE ? "-" : b->core[i] ? "1" : "0";
+    printf("  %-14s %4s %9.1f %9.1f %9.1f  %s%s\n", b->stages[i].name, core, b->startUs[i] / 1000.0,
+           b->readyUs[i] / 1000.0, (b->readyUs[i] - b->startUs[i]) / 1000.0, bootStateName(b->state[i]),
+           b->stages[i].critical ? " *" : "");
+  }
+  printf("door ready at %.1f ms, complete at %.1f ms%s\n", b->doorReadyUs / 1000.0, b->doneUs / 1000.0,
+         bootDegraded(b) ? ", DEGRADED" : "");
+}
+
+static int stageByName(const char* name) {
+  for (int s = 0; s < STAGE_COUNT; s++)
+    if (!strcmp(kStages[s].name, name)) return s;
+  return -1;
+}
+
+//========= SCENARIOS =========
+
+/** @brief Stages that transitively need `stage`, including itself. */
+static uint32_t needsClosure(int stage) {
+  uint32_t m = BOOT_BIT(stage);
+  for (int s = stage + 1; s < STAGE_COUNT; s++)
+    if (kStages[s].needs & m) m |= BOOT_BIT(s);
+  return m;
+}
+
+static int runScenarios() {
+  int failed = 0;
+  auto check = [&](bool ok, const char* what) {
+    printf("%-72s %s\n", what, ok ? "ok" : "FAIL");
+    failed += !ok;
+  };
+  bootPlan_t b;
+
+  for (int workers = 1; workers <= 2; workers++) {
+    for (int f = 0; f < STAGE_COUNT; f++) {
+      bool done = simulate(&b, kStages, workers, BOOT_BIT(f), NULL);
+      uint32_t lost = needsClosure(f);
+      bool critical = false;
+      for (int s = 0; s < STAGE_COUNT; s++) critical |= kStages[s].critical && (lost & BOOT_BIT(s));
+      bool ok = done && b.left == 0 && b.broken == lost && bootDegraded(&b) == critical;
+      for (int s = 0; ok && s < STAGE_COUNT; s++) {
+        uint8_t want = s == f ? BOOT_FAILED : (lost & BOOT_BIT(s)) ? BOOT_SKIPPED : BOOT_READY;
+        ok = b.state[s] == want;
+      }
+      char what[96];
+      snprintf(what, sizeof(what), "%d worker(s), %s fails: %d skipped, %s", workers, kStages[f].name,
+               __builtin_popcount(lost) - 1, critical ? "degraded" : "door unaffected");
+      check(ok, what);
+    }
+  }
+
+  bootStage_t bad[STAGE_COUNT];
+  memcpy(bad, kStages, sizeof(bad));
+  bad[STAGE_SERVO].needs = BOOT_BIT(STAGE_RFID);
+  char err[96];
+  check(!bootPlanInit(&b, bad, STAGE_COUNT, err, sizeof(err)), "forward dependency rejected");
+  bad[STAGE_SERVO].needs = BOOT_BIT(STAGE_SERVO);
+  check(!bootPlanInit(&b, bad, STAGE_COUNT, err, sizeof(err)), "self dependency rejected");
+
+  for (int f = 0; f < 3; f++) {
+    simFaults = f == 2 ? FAULT_TELEMETRY_QUEUE | FAULT_CORR_QUEUE : 1u << f;
+    bool done = simulate(&b, kStages, 2, 0, NULL);
+    simFaults = 0;
+    bool ok = done && b.state[STAGE_QUEUES] == BOOT_READY && b.state[STAGE_SERVICES] == BOOT_FAILED &&
+              b.broken == BOOT_BIT(STAGE_SERVICES) && !bootDegraded(&b);
+    char what[96];
+    snprintf(what, sizeof(what), "%s queue missing: services failed, door unaffected",
+             f == 0 ? "telemetry" : f == 1 ? "correlator" : "telemetry and correlator");
+    check(ok, what);
+  }
+
+  simulate(&b, kStages, 2, 0, NULL);
+  check(b.core[STAGE_SENSORS] == 1, "sensors pinned to core 1");
+  check(b.state[STAGE_I2C_BUS] == BOOT_READY && b.readyUs[STAGE_I2C_BUS] <= b.doorReadyUs,
+        "clock readable when the door is ready");
+
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<double> factor(0.5, 2.0);
+  bool exclusive = true;
+  for (int r = 0; r < 1000 && exclusive; r++) {
+    double scale[STAGE_COUNT];
+    for (double& f : scale) f = factor(rng);
+    simulate(&b, kStages, 2, 0, scale);
+    for (int i = 0; i < STAGE_COUNT; i++)
+      for (int j = i + 1; j < STAGE_COUNT; j++)
+        if ((kStageRes[i] & kStageRes[j]) && b.startUs[i] < b.readyUs[j] && b.startUs[j] < b.readyUs[i]) {
+          printf("  boot %d: %s and %s overlap\n", r, kStages[i].name, kStages[j].name);
+          exclusive = false;
+        }
+  }
+  check(exclusive, "no two stages share LEDC, SPI or Wire at once (1000 boots)");
+  uint32_t twoReady = b.doorReadyUs, twoDone = b.doneUs;
+  simulate(&b, kStages, 1, 0, NULL);
+  check(twoReady < b.doorReadyUs && twoDone < b.doneUs, "two workers ready sooner than one");
+  check(b.doorReadyUs < oldSetupUs(NULL), "one worker ready sooner than the old setup()");
+
+  printf("%d check(s) failed\n", failed);
+  return failed ? 1 : 0;
+}
+
+//========= JITTER =========
+
+static int runJitter(int runs, uint32_t seed, uint32_t failed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> factor(0.5, 2.0);
+  std::vector<double> ready[3], done[3];
+  bootPlan_t b;
+  for (int r = 0; r < runs; r++) {
+    double scale[STAGE_COUNT];
+    for (double& f : scale) f = factor(rng);
+    double old = oldSetupUs(scale) / 1000.0;
+    ready[0].push_back(old);
+    done[0].push_back(old);
+    for (int w = 1; w <= 2; w++) {
+      if (!simulate(&b, kStages, w, failed, scale)) return 1;
+      ready[w].push_back(b.doorReadyUs / 1000.0);
+      done[w].push_back(b.doneUs / 1000.0);
+    }
+  }
+  static const char* kNames[3] = { "old setup()", "1 worker", "2 workers" };
+  printf("%d boots, durations x0.5-2:  door ready p50 / max     complete p50 / max\n", runs);
+  for (int k = 0; k < 3; k++) {
+    std::sort(ready[k].begin(), ready[k].end());
+    std::sort(done[k].begin(), done[k].end());
+    printf("  %-12s %20.1f / %5.1f ms %12.1f / %5.1f ms\n", kNames[k], ready[k][runs / 2], ready[k].back(),
+           done[k][runs / 2], done[k].back());
+  }
+  return 0;
+}
+
+//========= MAIN =========
+
+int main(int argc, char** argv) {
+  int workers = 2, jitter = 0;
+  uint32_t seed = 1, failed = 0;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--scenarios")) return runScenarios();
+    if (!strcmp(argv[i], "--workers") && i + 1 < argc) workers = atoi(argv[++i]) == 1 ? 1 : 2;
+    else if (!strcmp(argv[i], "--jitter") && i + 1 < argc) jitter = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = (uint32_t)atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--fail") && i + 1 < argc) {
+      char* list = argv[++i];
+      for (char* name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+        int s = stageByName(name);
+        if (s < 0) {
+          fprintf(stderr, "unknown stage %s\n", name);
+          return 2;
+        }
+        failed |= BOOT_BIT(s);
+      }
+    } else if (!strcmp(argv[i], "--fault") && i + 1 < argc) {
+      char* list = argv[++i];
+      for (char* name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+        int f = !strcmp(name, kFaultNames[0]) ? 0 : !strcmp(name, kFaultNames[1]) ? 1 : -1;
+        if (f < 0) {
+          fprintf(stderr, "unknown fault %s\n", name);
+          return 2;
+        }
+        simFaults |= 1u << f;
+      }
+    } else {
+      fprintf(stderr, "usage: %s [--workers 1|2] [--fail a,b] [--fault f,g] [--jitter N] [--seed S] | --scenarios\n",
+              argv[0]);
+      return 2;
+    }
+  }
+  if (jitter > 0) return runJitter(jitter, seed, failed);
+
+  bootPlan_t b;
+  if (!simulate(&b, kStages, workers, failed, NULL)) return 1;
+  printf("%d worker(s):\n", workers);
+  printReport(&b);
+  printf("old setup(): door ready and complete at %.1f ms\n", oldSetupUs(NULL) / 1000.0);
+  return 0;
+}
@@ -0,0 +1,237 @@
+/**
+ * @file config_stress.cpp
+ * @brief Host stress test of the runtime configuration's snapshot publication.
+ *
+ * @details
+ * One writer thread publishes configurations as fast as it can while several
+ * reader threads read them through `cfgRead()`. Every configuration the
+ * writer publishes is derived from a single counter `k` (each field a
+ * different multiple of it), so a reader can tell from the fields alone
+ * whether it saw a consistent snapshot. Each reader also checks that versions
+ * never go backwards and that the data is at least as new as the version it
+ * was returned with.
+ *
+ * `--unchecked` makes the readers skip the sequence check; it is the control
+ * showing the test can detect torn reads at all on the machine it runs on.
+ *
+ * `--validate` instead runs the console's `set` path (`cfgSetField()` then
+ * `cfgValidate()`) over a list of edits to the defaults and checks which are
+ * accepted: per-field ranges and the rule that the fast RFID poll is not
+ * slower than the idle poll, whichever of the two is changed.
+ *
+ * Build:
+ *     g++ -std=c++17 -O2 -I../.. -o config_stress config_stress.cpp ../../runtime_config.cpp -lpthread
+ *
+ * Usage:
+ *     config_stress [--readers 3] [--seconds 5] [--unchecked]
+ *     config_stress --validate
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "runtime_config.h"
+
+static cfgStore_t store;
+static std::atomic<bool> running(true);
+
+/** @brief Configuration number `k`; every field is a distinct multiple of k. */
+static void makeConfig(uint32_t k, doorConfig_t* c) {
+  c->closeSumCm = (float)(k & 0xFFFFF);  // exact in a float
+  c->motionVotes = k;
+  c->lockMs = k * 3;
+  c->backlightMs = k * 5;
+  c->samplePeriodMs = k * 7;
+  c->rfidPollMs = k * 11;
+  c->debounceMs = k * 13;
+}
+
+/** @brief True if the fields all belong to the same k. */
+static bool consistent(const doorConfig_t& c) {
+  uint32_t k = c.motionVotes;
+  return c.closeSumCm == (float)(k & 0xFFFFF) && c.lockMs == k * 3 && c.backlightMs == k * 5 &&
+         c.samplePeriodMs == k * 7 && c.rfidPollMs == k * 11 && c.debounceMs == k * 13;
+}
+
+/** @brief Per-reader results. */
+typedef struct {
+  uint64_t reads;
+  uint64_t attempts;  ///< Callback runs, > reads when retries happened
+  uint64_t torn;      ///< Inconsistent snapshots accepted
+  uint64_t backwards; ///< Version or data older than a previous read
+  uint64_t stale;     ///< Data older than the version it came with
+} readerStats_t;
+
+static void reader(bool checked, readerStats_t* st) {
+  uint32_t lastVersion = 0, lastK = 0;
+  while (running.load(std::memory_order_relaxed)) {
+    doorConfig_t snap;
+    uint32_t version;
+    if (checked) {
+      version = cfgRead(&store, [&](const doorConfig_t& c) {
+        st->attempts++;
+        // field by field, in place, like the tasks do
+        snap.motionVotes = c.motionVotes;
+        snap.closeSumCm = c.closeSumCm;
+        snap.lockMs = c.lockMs;
+        snap.backlightMs = c.backlightMs;
+        snap.samplePeriodMs = c.samplePeriodMs;
+        snap.rfidPollMs = c.rfidPollMs;
+        snap.debounceMs = c.debounceMs;
+      });
+    } else {
+      const doorConfig_t* c;
+      cfgReadBegin(&store, &c, &version);
+      st->attempts++;
+      snap.motionVotes = c->motionVotes;
+      snap.closeSumCm = c->closeSumCm;
+      snap.lockMs = c->lockMs;
+      snap.backlightMs = c->backlightMs;
+      snap.samplePeriodMs = c->samplePeriodMs;
+      snap.rfidPollMs = c->rfidPollMs;
+      snap.debounceMs = c->debounceMs;
+    }
+    st->reads++;
+
+    if (!consistent(snap)) {
+      st->torn++;
+      continue;
+    }
+    uint32_t k = snap.motionVotes;
+    if (version < lastVersion || k < lastK) st->backwards++;
+    if (k < version) st->stale++;
+    lastVersion = version;
+    lastK = k;
+  }
+}
+
+/** @brief One `set` sequence applied to the defaults and whether its last edit must be accepted. */
+typedef struct {
+  const char* edits[2][2];  ///< Up to two { name, value } edits, in order; the first must succeed
+  bool accepted;            ///< Expected outcome of the last edit
+} validateCase_t;
+
+/**
+ * @brief Applies one edit the way the console's `set` does: the field, then the whole block.
+ */
+static bool setField(doorConfig_t* cfg, const char* name, const char* value, char* err, size_t errLen) {
+  const cfgField_t* f = cfgFindField(name);
+  if (!f) {
+    snprintf(err, errLen, "unknown field %s", name);
+    return false;
+  }
+  doorConfig_t next = *cfg;
+  if (!cfgSetField(&next, f, value, err, errLen) || !cfgValidate(&next, err, errLen)) return false;
+  *cfg = next;
+  return true;
+}
+
+static int runValidate() {
+  static const validateCase_t cases[] = {
+    { { { "rfid_fast_poll_ms", "100" }, { NULL, NULL } }, true },
+    { { { "rfid_fast_poll_ms", "500" }, { NULL, NULL } }, true },                         // equal to the idle poll
+    { { { "rfid_fast_poll_ms", "600" }, { NULL, NULL } }, false },                        // slower than idle
+    { { { "rfid_poll_ms", "80" }, { NULL, NULL } }, false },                              // idle below fast (100)
+    { { { "rfid_fast_poll_ms", "50" }, { "rfid_poll_ms", "80" } }, true },
+    { { { "rfid_poll_ms", "2000" }, { "rfid_fast_poll_ms", "2000" } }, true },
+    { { { "rfid_poll_ms", "2000" }, { "rfid_fast_poll_ms", "2500" } }, false },
+    { { { "rfid_fast_poll_ms", "10" }, { NULL, NULL } }, false },                         // below its range
+    { { { "rfid_poll_ms", "abc" }, { NULL, NULL } }, false },
+  };
+  int failed = 0;
+  doorConfig_t defaults;
+  cfgDefaults(&defaults);
+  char err[64];
+  bool ok = cfgValidate(&defaults, err, sizeof(err));
+  printf("%-58s %s\n", "defaults", ok ? "ok" : err);
+  failed += !ok;
+
+  for (const validateCase_t& c : cases) {
+    doorConfig_t cfg = defaults;
+    char what[96] = "";
+    bool pass = true, accepted = true;
+    int n = c.edits[1][0] ? 2 : 1;
+    for (int i = 0; i < n; i++) {
+      snprintf(what + strlen(what), sizeof(what) - strlen(what), "%sset %s %s", i ? ", " : "", c.edits[i][0],
+               c.edits[i][1]);
+      doorConfig_t before = cfg;
+      accepted = setField(&cfg, c.edits[i][0], c.edits[i][1], err, sizeof(err));
+      if (i < n - 1) pass &= accepted;
+      else pass &= accepted == c.accepted && (accepted || !memcmp(&before, &cfg, sizeof(cfg)));
+    }
+    printf("%-58s %s%s\n", what, accepted ? "accepted" : "rejected", pass ? "" : "  FAIL");
+    if (!accepted) printf("    %s\n", err);
+    failed += !pass;
+  }
+  printf("%d case(s) failed\n", failed);
+  return failed ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+  int readers = 3;
+  double seconds = 5;
+  bool checked = true;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--readers") && i + 1 < argc) readers = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) seconds = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--unchecked")) checked = false;
+    else if (!strcmp(argv[i], "--validate")) return runValidate();
+    else {
+      fprintf(stderr, "usage: %s [--readers N] [--seconds S] [--unchecked] | --validate\n", argv[0]);
+      return 2;
+    }
+  }
+
+  doorConfig_t c;
+  makeConfig(0, &c);
+  cfgStoreInit(&store, &c);
+
+  std::vector<readerStats_t> stats(readers);
+  memset(stats.data(), 0, stats.size() * sizeof(readerStats_t));
+  std::vector<std::thread> threads;
+  for (int r = 0; r < readers; r++) threads.emplace_back(reader, checked, &stats[r]);
+
+  uint32_t k = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  std::thread writer([&]() {
+    while (running.load(std::memory_order_relaxed)) {
+      doorConfig_t next;
+      makeConfig(++k, &next);
+      cfgPublish(&store, &next);
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+  running = false;
+  writer.join();
+  for (auto& t : threads) t.join();
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  readerStats_t tot;
+  memset(&tot, 0, sizeof(tot));
+  for (const readerStats_t& s : stats) {
+    tot.reads += s.reads;
+    tot.attempts += s.attempts;
+    tot.torn += s.torn;
+    tot.backwards += s.backwards;
+    tot.stale += s.stale;
+  }
+  printf("%s reads, 1 writer, %d readers, %.1f s, %u hardware threads\n", checked ? "checked" : "UNCHECKED",
+         readers, elapsed, std::thread::hardware_concurrency());
+  printf("published %u versions (%.2f M/s)\n", k, k / elapsed / 1e6);
+  printf("reads %llu (%.2f M/s), retried %.4f%%\n", (unsigned long long)tot.reads, tot.reads / elapsed / 1e6,
+         tot.reads ? 100.0 * (tot.attempts - tot.reads) / tot.reads : 0.0);
+  printf("torn %llu, backwards %llu, stale %llu\n", (unsigned long long)tot.torn,
+         (unsigned long long)tot.backwards, (unsigned long long)tot.stale);
+
+  bool failed = tot.backwards || tot.stale || (checked && tot.torn);
+  return failed ? 1 : 0;
+}
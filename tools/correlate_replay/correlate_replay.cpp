@@ -0,0 +1,264 @@
+/**
+ * @file correlate_replay.cpp
+ * @brief Replays recorded door event streams through the event correlator.
+ *
+ * @details
+ * Reads the CSV written by `tools/telemetry_collector` (from a file or
+ * stdin), turns `edge`, `access` and `lock` records into correlator events
+ * and prints every alert `correlator.cpp` raises, exactly as the firmware
+ * would have. Other record types are skipped.
+ *
+ * `--scenarios` replays a set of built-in scripted streams in the same CSV
+ * form and compares the alerts raised against the expected ones; the exit
+ * status is non-zero if any scenario disagrees. `--bench N` times the
+ * correlator on N synthetic events.
+ *
+ * Build:
+ *     g++ -std=c++17 -O2 -I../.. -o correlate_replay correlate_replay.cpp ../../correlator.cpp
+ *
+ * Usage:
+ *     telemetry_collector /dev/ttyUSB0 > capture.csv
+ *     correlate_replay capture.csv
+ *     correlate_replay --scenarios
+ *     correlate_replay --bench 10000000
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "correlator.h"
+
+//========= REPLAY =========
+
+/** @brief Alerts raised during one replay, by flag bit. */
+typedef struct {
+  unsigned counts[3];
+  unsigned events;
+} replayResult_t;
+
+static void recordAlerts(uint8_t alerts, uint32_t t, bool print, replayResult_t* r) {
+  for (int b = 0; b < 3; b++) {
+    if (!(alerts & (1 << b))) continue;
+    r->counts[b]++;
+    if (print) printf("%u,alert,%s\n", (unsigned)t, corrAlertName((uint8_t)(1 << b)));
+  }
+}
+
+/**
+ * @brief Maps one collector CSV line to a correlator event.
+ * @return false for headers, comments and record types the correlator ignores
+ */
+static bool parseLine(const char* line, corrEvent_t* ev) {
+  unsigned t, seq;
+  char type[16], f1[16];
+  if (sscanf(line, "%u,%u,%15[^,],%15[^,\n]", &t, &seq, type, f1) != 4) return false;
+  ev->timestampMs = t;
+
+  if (!strcmp(type, "edge")) {
+    ev->type = atoi(f1) ? CORR_PRESENCE_START : CORR_PRESENCE_END;
+  } else if (!strcmp(type, "access")) {
+    if (!strcmp(f1, "granted") || !strcmp(f1, "regrant")) ev->type = CORR_GRANT;
+    else if (!strcmp(f1, "denied")) ev->type = CORR_DENY;
+    else return false;
+  } else if (!strcmp(type, "lock")) {
+    ev->type = atoi(f1) ? CORR_LOCKED : CORR_UNLOCKED;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Replays a CSV stream; deadlines still open at the end are flushed.
+ */
+static replayResult_t replay(FILE* in, bool print) {
+  correlator_t c;
+  corrInit(&c);
+  replayResult_t r;
+  memset(&r, 0, sizeof(r));
+
+  char line[256];
+  uint32_t last = 0;
+  while (fgets(line, sizeof(line), in)) {
+    corrEvent_t ev;
+    if (!parseLine(line, &ev)) continue;
+    r.events++;
+    last = ev.timestampMs;
+    recordAlerts(corrOnEvent(&c, &ev), ev.timestampMs, print, &r);
+  }
+  uint32_t end = last + CORR_DENIAL_FOLLOW_MS + 1;
+  recordAlerts(corrAdvance(&c, end), end, print, &r);
+  return r;
+}
+
+//========= SCENARIOS =========
+
+/** @brief Scripted stream and the alerts it must raise. */
+typedef struct {
+  const char* name;
+  const char* csv;
+  unsigned expect[3];  ///< presence_no_grant, unlock_no_presence, denials_then_presence
+} scenario_t;
+
+static const scenario_t kScenarios[] = {
+  { "passer-by",
+    "0,0,edge,1,0,1\n"
+    "3000,1,edge,0,0,0\n",
+    { 0, 0, 0 } },
+  { "presence without a badge",
+    "0,0,edge,1,1,0\n"
+    "8000,1,edge,0,0,0\n",
+    { 1, 0, 0 } },
+  { "badge holder",
+    "0,0,edge,1,1,1\n"
+    "2000,1,access,granted,DE AD BE EF\n"
+    "2100,2,lock,0,0\n"
+    "6000,3,edge,0,0,0\n"
+    "12100,4,lock,1,180\n",
+    { 0, 0, 0 } },
+  { "badge read just before presence detected",
+    "0,0,access,granted,DE AD BE EF\n"
+    "100,1,lock,0,0\n"
+    "5000,2,edge,1,1,0\n"
+    "12000,3,edge,0,0,0\n",
+    { 0, 0, 0 } },
+  { "unlock with nobody there",
+    "1000,0,lock,0,0\n"
+    "11000,1,lock,1,180\n",
+    { 0, 1, 0 } },
+  { "unlock, person arrives shortly after",
+    "1000,0,lock,0,0\n"
+    "3000,1,edge,1,1,0\n"
+    "4000,2,edge,0,0,0\n"
+    "11000,3,lock,1,180\n",
+    { 0, 0, 0 } },
+  { "unlock just after person left",
+    "0,0,edge,1,1,0\n"
+    "6000,1,access,granted,DE AD BE EF\n"
+    "6500,2,edge,0,0,0\n"
+    "8000,3,lock,0,0\n"
+    "18000,4,lock,1,180\n",
+    { 0, 0, 0 } },
+  { "denial burst, then someone returns",
+    "0,0,edge,1,1,1\n"
+    "2000,1,access,denied,11 22 33 44\n"
+    "3000,2,access,denied,11 22 33 44\n"
+    "4000,3,access,denied,55 66 77 88\n"
+    "8000,4,edge,0,0,0\n"
+    "60000,5,edge,1,0,1\n"
+    "61000,6,edge,0,0,0\n",
+    { 1, 0, 1 } },
+  { "denials, then an authorized badge",
+    "0,0,edge,1,1,1\n"
+    "2000,1,access,denied,11 22 33 44\n"
+    "3000,2,access,denied,11 22 33 44\n"
+    "4000,3,access,denied,11 22 33 44\n"
+    "4500,4,access,granted,DE AD BE EF\n"
+    "8000,5,edge,0,0,0\n"
+    "60000,6,edge,1,0,1\n"
+    "61000,7,edge,0,0,0\n",
+    { 0, 0, 0 } },
+  { "denials too far apart",
+    "0,0,access,denied,11 22 33 44\n"
+    "40000,1,access,denied,11 22 33 44\n"
+    "80000,2,access,denied,11 22 33 44\n"
+    "90000,3,edge,1,1,0\n"
+    "92000,4,edge,0,0,0\n",
+    { 0, 0, 0 } },
+  { "presence long after a burst",
+    "0,0,access,denied,11 22 33 44\n"
+    "1000,1,access,denied,11 22 33 44\n"
+    "2000,2,access,denied,11 22 33 44\n"
+    "400000,3,edge,1,1,0\n"
+    "401000,4,edge,0,0,0\n",
+    { 0, 0, 0 } },
+  { "millis() wrap during presence",
+    "4294964296,0,edge,1,1,0\n"
+    "3000,1,edge,0,0,0\n",
+    { 1, 0, 0 } },
+  { "unlock with nobody there after 25 days uptime",
+    "2200000000,0,lock,0,0\n"
+    "2200010000,1,lock,1,180\n",
+    { 0, 1, 0 } },
+  { "collector header and other records ignored",
+    "t_ms,seq,type,fields...\n"
+    "0,0,sample,12.5,1,1\n"
+    "10,1,anomaly,1,3,40\n"
+    "20,2,access,ignored,DE AD BE EF\n",
+    { 0, 0, 0 } },
+};
+
+static int runScenarios() {
+  int failed = 0;
+  for (const scenario_t& s : kScenarios) {
+    FILE* f = fmemopen((void*)s.csv, strlen(s.csv), "r");
+    replayResult_t r = replay(f, false);
+    fclose(f);
+    bool ok = memcmp(r.counts, s.expect, sizeof(s.expect)) == 0;
+    printf("%-4s %-44s got %u/%u/%u expected %u/%u/%u\n", ok ? "ok" : "FAIL", s.name, r.counts[0],
+           r.counts[1], r.counts[2], s.expect[0], s.expect[1], s.expect[2]);
+    failed += !ok;
+  }
+  printf("%d/%zu scenarios passed\n", (int)(sizeof(kScenarios) / sizeof(kScenarios[0])) - failed,
+         sizeof(kScenarios) / sizeof(kScenarios[0]));
+  return failed ? 1 : 0;
+}
+
+//========= BENCHMARK =========
+
+static int runBench(long n) {
+  std::mt19937 rng(1);
+  std::vector<corrEvent_t> events(n);
+  uint32_t t = 0;
+  bool present = false;
+  for (long i = 0; i < n; i++) {
+    t += 50 + rng() % 5000;
+    uint32_t r = rng() % 10;
+    uint8_t type = r < 6 ? (present ? CORR_PRESENCE_END : CORR_PRESENCE_START)
+                 : r < 7 ? CORR_GRANT : r < 8 ? CORR_DENY : r < 9 ? CORR_UNLOCKED : CORR_LOCKED;
+    if (type == CORR_PRESENCE_START || type == CORR_PRESENCE_END) present = !present;
+    events[i] = { t, type };
+  }
+
+  correlator_t c;
+  corrInit(&c);
+  unsigned alerts = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (const corrEvent_t& ev : events) alerts += corrOnEvent(&c, &ev) != 0;
+  double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  printf("%ld events in %.3f s: %.1f ns/event, %u with alerts, state %zu B\n", n, s, s * 1e9 / n,
+         alerts, sizeof(correlator_t));
+  return 0;
+}
+
+//========= MAIN =========
+
+int main(int argc, char** argv) {
+  if (argc == 2 && !strcmp(argv[1], "--scenarios")) return runScenarios();
+  if (argc == 3 && !strcmp(argv[1], "--bench")) return runBench(atol(argv[2]));
+
+  FILE* in = stdin;
+  if (argc == 2 && argv[1][0] != '-') {
+    in = fopen(argv[1], "r");
+    if (!in) {
+      perror(argv[1]);
+      return 2;
+    }
+  } else if (argc != 1) {
+    fprintf(stderr, "usage: %s [capture.csv] | --scenarios | --bench N\n", argv[0]);
+    return 2;
+  }
+
+  replayResult_t r = replay(in, true);
+  fprintf(stderr, "%u events: presence_no_grant %u, unlock_no_presence %u, denials_then_presence %u\n",
+          r.events, r.counts[0], r.counts[1], r.counts[2]);
+  return 0;
+}
@@ -0,0 +1,768 @@
+/**
+ * @file door_sim.cpp
+ * @brief Virtual-time discrete-event simulator for soak testing the door logic.
+ *
+ * @details
+ * Drives the firmware's own decision code (`door_logic.h`, `rfid_inventory.h`,
+ * `anomaly.h`, `approach.h`, `rfid_power.h`) against a virtual microsecond clock, so days of door traffic
+ * run in seconds on a Linux host. The FreeRTOS tasks and timers around that
+ * code are modelled one-to-one:
+ * - `sensorProcessTask`: one sample every `DOOR_SAMPLE_MS`, backlight arm on presence
+ *   or approach, reader notification on presence edges and approach wakes,
+ * - `taskRFIDReader` / `taskPrinter`: the reader power state machine, an
+ *   inventory pass every `DOOR_RFID_FAST_POLL_MS` while someone is there and
+ *   every `DOOR_RFID_POLL_MS` during the hold-off, none while the reader
+ *   sleeps, and the access decision with its side effects,
+ * - `ServoRunTask`: follows `isLock` a short latency after each notification,
+ * - `lockTimer` / `backlightTimer`: one-shot timers with stop/start re-arm semantics,
+ * - `LCDTask`: samples the displayed state every 31.25 ms.
+ *
+ * Scripted people arrive at random (Poisson), approach, hover, badge one or
+ * more times and leave. Badge holders, unknown badges, passers-by and
+ * loiterers are mixed; the ultrasonic reading sees the nearest person with
+ * Gaussian noise, echo dropouts and occasional spurious echoes.
+ *
+ * Invariants checked continuously (each violation counted once per episode):
+ * - `servo_mismatch`   servo position disagrees with `isLock` after the servo task settled
+ * - `unlock_too_long`  door held unlocked longer than the lock duration after the last grant
+ * - `unlock_no_grant`  servo unlocked with no authorized scan in the preceding lock duration
+ * - `backlight_gap`    LCD shows presence while the backlight is off
+ * - `reader_asleep`    the mock reader was sent a command while powered down
+ * - `badge_unread`     a badge left the field without being read
+ *
+ * The mock reader counts every command it receives; the report gives reader
+ * commands per hour, the share of time the reader slept and the badge-to-read
+ * latency. `--always-on` disables the power gating for comparison.
+ *
+ * Many doors run in parallel across host cores, each with its own seed.
+ *
+ * Build:
+ *     g++ -std=c++17 -O2 -I../.. -o door_sim door_sim.cpp ../../door_logic.cpp ../../anomaly.cpp \
+ *         ../../access_schedule.cpp ../../approach.cpp ../../rfid_power.cpp ../../presence.cpp -lpthread
+ *
+ * Usage:
+ *     door_sim [--days 7] [--doors 1] [--threads N] [--seed 1] [--rate 30]
+ *              [--noise 2.0] [--dropout 0.02] [--holdoff 5000] [--always-on] [--verbose]
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+#include "door_logic.h"
+#include "rfid_inventory.h"
+#include "anomaly.h"
+#include "access_schedule.h"
+#include "approach.h"
+#include "rfid_power.h"
+#include "presence.h"
+
+//========= CONFIGURATION =========
+static const uint64_t US_PER_MS = 1000ULL;
+static const uint64_t US_PER_S = 1000000ULL;
+static const uint64_t LCD_PERIOD_US = 31250;       ///< LCDTask period
+static const uint64_t SERVO_LATENCY_US = 1000;     ///< Notification to servo write
+static const uint64_t SETTLE_US = 50 * US_PER_MS;  ///< Grace period before mismatch counts
+static const float APPROACH_CM = 250.0f;           ///< Distance at which people appear
+static const float WALK_CM_PER_S = 100.0f;         ///< Walking speed
+static const float PIR_RANGE_CM = 300.0f;          ///< PIR sees people inside this range
+static const float NO_PERSON_CM = 0.0f;            ///< Reading with nobody in front (no echo)
+static const uint32_t RFID_WAKE_US = 1500;         ///< Soft power-up to oscillator ready (MFRC522 start-up)
+static const int READ_HIST_MS = 10;                ///< Badge-to-read histogram bucket width
+static const int READ_HIST_BUCKETS = 300;          ///< Histogram range, 3 s
+
+static const char* const ALLOWED[] = { "DE AD BE EF", "CA FE BA BE", "BF 6D CB 1F", "79 49 4D B2" };
+static const int NUM_ALLOWED = sizeof(ALLOWED) / sizeof(ALLOWED[0]);
+static const accessWindow_t ALWAYS_WINDOWS[] = { { ACCESS_ALL_DAYS, 0, 0 } };
+static const accessScheduleDef_t SIM_SCHEDULES[] = { { "always", ALWAYS_WINDOWS, 1 } };
+static const uint16_t SIM_START_DAY = 9497;  ///< 2026-01-01, day the simulation starts on
+
+/** @brief Simulation parameters shared by all doors. */
+typedef struct {
+  double days;
+  int doors;
+  int threads;
+  uint64_t seed;
+  double ratePerHour;
+  double noiseCm;
+  double dropout;
+  uint32_t holdoffMs;
+  bool alwaysOn;
+  bool verbose;
+} simParams_t;
+
+enum Violation { V_SERVO_MISMATCH = 0, V_UNLOCK_TOO_LONG, V_UNLOCK_NO_GRANT, V_BACKLIGHT_GAP, V_READER_ASLEEP,
+                 V_BADGE_UNREAD, V_COUNT };
+static const char* kViolationNames[V_COUNT] = { "servo_mismatch", "unlock_too_long", "unlock_no_grant", "backlight_gap",
+                                                "reader_asleep", "badge_unread" };
+
+enum PersonKind { P_BADGE = 0, P_UNKNOWN, P_PASSERBY, P_LOITERER, P_KINDS };
+static const char* kKindNames[P_KINDS] = { "badge_holder", "unknown_badge", "passer_by", "loiterer" };
+
+/** @brief Per-door results, summed over all doors at the end. */
+typedef struct {
+  uint64_t samples, inventories, multiCardPasses;
+  uint64_t decisions[4];
+  uint64_t unlocks;
+  uint64_t people[P_KINDS];
+  uint64_t admitted, missedAdmissions;
+  uint64_t anomalies[3];
+  uint64_t rfidCommands, rfidSleeps, rfidWakes, rfidAsleepMs, approachWakes;
+  uint64_t detectingSamples, presences, presenceMs;  ///< Samples with close/motion set; presence events and their time
+  uint64_t badgeReads, badgeReadHist[READ_HIST_BUCKETS + 1];  ///< Last bucket: READ_HIST_BUCKETS * 10 ms and above
+  uint64_t violations[V_COUNT];
+  uint64_t firstViolationUs[V_COUNT];
+} simStats_t;
+
+//========= SIMULATED PICC FIELD =========
+
+/** @brief One card held in front of the reader. */
+typedef struct {
+  uint8_t uid[4];
+  bool halted;  ///< Answered HLTA; stays silent to REQA until removed from the field
+  uint64_t tIn; ///< When the card entered the field
+  bool read;    ///< Returned by an inventory pass since entering the field
+} simCard_t;
+
+/**
+ * @brief Stand-in for MFRC522 exposing the calls used by rfidInventory() and the power gating.
+ *
+ * @details Counts every command. While soft powered down it answers nothing
+ * and counts the access as an error; with the antenna off no card answers.
+ */
+struct SimReader {
+  struct Uid {
+    uint8_t size;
+    uint8_t uidByte[10];
+    uint8_t sak;
+  } uid;
+  std::vector<simCard_t*> field;  ///< Cards currently in the RF field
+  simCard_t* selected = nullptr;
+  bool poweredDown = false;
+  bool antennaOn = true;
+  uint64_t commands = 0;
+  uint64_t asleepCommands = 0;  ///< Commands received while powered down
+
+  /** @brief Counts one command; false if the reader cannot act on it. */
+  bool command() {
+    commands++;
+    if (poweredDown) asleepCommands++;
+    return !poweredDown;
+  }
+  void PCD_SoftPowerDown() {
+    if (command()) poweredDown = true;
+  }
+  void PCD_SoftPowerUp() {
+    commands++;
+    poweredDown = false;
+  }
+  void PCD_AntennaOn() {
+    if (command()) antennaOn = true;
+  }
+  void PCD_AntennaOff() {
+    if (command()) antennaOn = false;
+  }
+
+  bool PICC_IsNewCardPresent() {
+    if (!command() || !antennaOn) return false;
+    for (simCard_t* c : field)
+      if (!c->halted) return true;
+    return false;
+  }
+  bool PICC_ReadCardSerial() {
+    // anticollision resolves towards the highest UID first
+    selected = nullptr;
+    if (!command() || !antennaOn) return false;
+    for (simCard_t* c : field)
+      if (!c->halted && (!selected || memcmp(c->uid, selected->uid, 4) > 0)) selected = c;
+    if (!selected) return false;
+    uid.size = 4;
+    memcpy(uid.uidByte, selected->uid, 4);
+    return true;
+  }
+  void PICC_HaltA() {
+    if (command() && selected) selected->halted = true;
+  }
+  void PCD_StopCrypto1() { command(); }
+};
+
+//========= PEOPLE =========
+
+/** @brief A scripted visitor. */
+typedef struct {
+  int kind;
+  uint64_t tArrive, tAtDoor, tLeave, tGone;  ///< Phase boundaries, tLeave/tGone set when leaving
+  float standCm;                              ///< Distance while standing at the door
+  simCard_t card;                             ///< Badge (unused for passers-by / loiterers)
+  bool cardInField;
+  int attempts;                               ///< Badge attempts left
+  bool admitted;
+  bool leaving;
+} person_t;
+
+enum EventType { E_ARRIVE, E_AT_DOOR, E_BADGE_START, E_BADGE_END, E_LEAVE, E_GONE,
+                 E_LOCK_TIMER, E_BACKLIGHT_TIMER, E_SERVO };
+
+/** @brief Scheduled non-periodic event. */
+typedef struct {
+  uint64_t t;
+  uint64_t seq;   ///< FIFO tie-break
+  int type;
+  int person;     ///< Person index, or timer generation
+} event_t;
+
+struct EventLater {
+  bool operator()(const event_t& a, const event_t& b) const {
+    return a.t != b.t ? a.t > b.t : a.seq > b.seq;
+  }
+};
+
+//========= ONE DOOR =========
+
+/**
+ * @brief Simulates one door for `p.days` of virtual time.
+ */
+class DoorSim {
+ public:
+  DoorSim(const simParams_t& p, uint64_t seed) : p_(p), rng_(seed) {
+    memset(&st_, 0, sizeof(st_));
+    doorSensorInit(&window_);
+    anomalyInit(&anomaly_);
+    approachInit(&tracker_);
+    presenceInit(&presence_);
+    rfidPowerInit(&power_, 0);
+
+    accessCredentialDef_t creds[NUM_ALLOWED];
+    for (int i = 0; i < NUM_ALLOWED; i++) creds[i] = { ALLOWED[i], 0, NULL };
+    accessPolicy_t policy = { SIM_SCHEDULES, 1, creds, NUM_ALLOWED, NULL, 0 };
+    accessTableInit(&access_, accessCreds_, NUM_ALLOWED, &accessSched_, 1);
+    char err[96];
+    if (!accessCompile(&access_, &policy, err, sizeof(err))) fprintf(stderr, "access policy: %s\n", err);
+  }
+
+  simStats_t run() {
+    const uint64_t end = (uint64_t)(p_.days * 86400.0 * US_PER_S);
+    scheduleArrival(0);
+
+    uint64_t nextSample = 0, nextLcd = 0;
+    while (true) {
+      uint64_t tEvt = events_.empty() ? UINT64_MAX : events_.top().t;
+      uint64_t t = std::min({ nextSample, nextLcd, nextRfid_, tEvt });
+      if (t >= end) break;
+      now_ = t;
+
+      if (t == tEvt) {
+        event_t e = events_.top();
+        events_.pop();
+        handleEvent(e);
+      } else if (t == nextSample) {
+        sensorSample();
+        nextSample += DOOR_SAMPLE_MS * US_PER_MS;
+      } else if (t == nextRfid_) {
+        rfidTask();
+      } else {
+        lcdPoll();
+        nextLcd += LCD_PERIOD_US;
+      }
+    }
+
+    st_.rfidCommands = reader_.commands;
+    st_.rfidSleeps = power_.sleeps;
+    st_.rfidWakes = power_.wakes;
+    st_.rfidAsleepMs = rfidPowerAsleepMs(&power_, nowMs());
+    st_.approachWakes = tracker_.wakes;
+    return st_;
+  }
+
+ private:
+  const simParams_t& p_;
+  std::mt19937_64 rng_;
+  std::priority_queue<event_t, std::vector<event_t>, EventLater> events_;
+  uint64_t seq_ = 0;
+  uint64_t now_ = 0;
+  simStats_t st_;
+
+  // — firmware state (globals of the real system) —
+  doorSensorState_t window_;
+  anomalyDetector_t anomaly_;
+  accessTable_t access_;
+  accessCredential_t accessCreds_[NUM_ALLOWED];
+  accessSchedule_t accessSched_;
+  bool closeDist_ = false, motion_ = false;
+  approachTracker_t tracker_;
+  presenceTracker_t presence_;
+  bool someoneThere_ = false;
+  rfidPower_t power_;
+  uint64_t nextRfid_ = 0;
+  uint64_t readerAsleepCommands_ = 0;
+  bool isLock_ = true, backlightOn_ = false;
+  char lastUID_[RFID_UID_STR_LEN] = "";
+  uint64_t lockGen_ = 0, backlightGen_ = 0;
+  bool servoPending_ = false;
+  bool servoLocked_ = true;
+  uint64_t lastGrantUs_ = 0;
+  bool anyGrant_ = false;
+  uint64_t unlockedSince_ = 0;
+  uint64_t lastServoActivityUs_ = 0;
+
+  // — world state —
+  std::vector<person_t> people_;
+  std::vector<int> active_;
+  SimReader reader_;
+  bool inViolation_[V_COUNT] = {};
+
+  double uniform() { return std::uniform_real_distribution<double>(0.0, 1.0)(rng_); }
+  uint64_t secs(double lo, double hi) { return (uint64_t)((lo + (hi - lo) * uniform()) * US_PER_S); }
+  uint32_t nowMs() const { return (uint32_t)(now_ / US_PER_MS); }
+
+  void schedule(uint64_t t, int type, int person) { events_.push({ t, seq_++, type, person }); }
+
+  //— violations, counted once per episode —
+  void violation(int v, bool active) {
+    if (active && !inViolation_[v]) {
+      if (st_.violations[v] == 0) st_.firstViolationUs[v] = now_;
+      st_.violations[v]++;
+      if (p_.verbose && st_.violations[v] <= 3) {
+        fprintf(stderr, "  t=%.3f s %s (lock=%d servoLocked=%d backlight=%d)\n",
+                now_ / 1e6, kViolationNames[v], isLock_, servoLocked_, backlightOn_);
+      }
+    }
+    inViolation_[v] = active;
+  }
+
+  /** @brief Counts a violation that is a single event rather than a state. */
+  void violationEvent(int v) {
+    violation(v, true);
+    violation(v, false);
+  }
+
+  //— people —
+  void scheduleArrival(uint64_t after) {
+    double meanS = 3600.0 / p_.ratePerHour;
+    uint64_t dt = (uint64_t)(std::exponential_distribution<double>(1.0 / meanS)(rng_) * US_PER_S);
+    schedule(after + dt, E_ARRIVE, -1);
+  }
+
+  void arrive() {
+    person_t pr;
+    memset(&pr, 0, sizeof(pr));
+    double r = uniform();
+    pr.kind = r < 0.70 ? P_BADGE : r < 0.80 ? P_UNKNOWN : r < 0.95 ? P_PASSERBY : P_LOITERER;
+    pr.tArrive = now_;
+    pr.standCm = pr.kind == P_PASSERBY ? 60.0f + 90.0f * (float)uniform()
+                 : pr.kind == P_LOITERER ? 20.0f + 40.0f * (float)uniform()
+                                         : 8.0f + 10.0f * (float)uniform();
+    uint64_t walk = (uint64_t)((APPROACH_CM - pr.standCm) / WALK_CM_PER_S * US_PER_S);
+    pr.tAtDoor = now_ + walk;
+    pr.attempts = pr.kind == P_UNKNOWN ? 3 : 2;
+    if (pr.kind == P_BADGE) {
+      const char* u = ALLOWED[rng_() % NUM_ALLOWED];
+      for (int i = 0; i < 4; i++) pr.card.uid[i] = (uint8_t)strtoul(u + 3 * i, NULL, 16);
+    } else {
+      for (int i = 0; i < 4; i++) pr.card.uid[i] = (uint8_t)(rng_() & 0xFF);
+    }
+    st_.people[pr.kind]++;
+
+    int idx = (int)people_.size();
+    people_.push_back(pr);
+    active_.push_back(idx);
+    schedule(pr.tAtDoor, E_AT_DOOR, idx);
+    scheduleArrival(now_);
+  }
+
+  void atDoor(int i) {
+    person_t& pr = people_[i];
+    switch (pr.kind) {
+      case P_BADGE:
+      case P_UNKNOWN:
+        schedule(now_ + secs(0.3, 1.5), E_BADGE_START, i);
+        break;
+      case P_PASSERBY:
+        schedule(now_ + secs(1.0, 6.0), E_LEAVE, i);
+        break;
+      default:
+        schedule(now_ + secs(120.0, 300.0), E_LEAVE, i);
+        break;
+    }
+  }
+
+  void badgeStart(int i) {
+    person_t& pr = people_[i];
+    pr.card.halted = false;
+    pr.card.tIn = now_;
+    pr.card.read = false;
+    pr.cardInField = true;
+    reader_.field.push_back(&pr.card);
+    schedule(now_ + secs(0.6, 1.5), E_BADGE_END, i);
+  }
+
+  void badgeEnd(int i) {
+    person_t& pr = people_[i];
+    pr.cardInField = false;
+    reader_.field.erase(std::remove(reader_.field.begin(), reader_.field.end(), &pr.card), reader_.field.end());
+    if (!pr.card.read) violationEvent(V_BADGE_UNREAD);
+    pr.attempts--;
+    if (!servoLocked_) {
+      pr.admitted = true;
+      schedule(now_ + secs(1.0, 3.0), E_LEAVE, i);
+    } else if (pr.attempts > 0) {
+      schedule(now_ + secs(0.5, 2.0), E_BADGE_START, i);
+    } else {
+      schedule(now_ + secs(0.5, 2.0), E_LEAVE, i);
+    }
+  }
+
+  void leave(int i) {
+    person_t& pr = people_[i];
+    pr.leaving = true;
+    pr.tLeave = now_;
+    pr.tGone = now_ + (uint64_t)((APPROACH_CM - pr.standCm) / WALK_CM_PER_S * US_PER_S);
+    if (pr.kind == P_BADGE) {
+      if (pr.admitted) st_.admitted++;
+      else st_.missedAdmissions++;
+    }
+    schedule(pr.tGone, E_GONE, i);
+  }
+
+  void gone(int i) {
+    active_.erase(std::remove(active_.begin(), active_.end(), i), active_.end());
+    if (active_.empty()) people_.clear();  // indices are only referenced by active people
+  }
+
+  float personDistance(const person_t& pr) const {
+    if (now_ < pr.tAtDoor) {
+      return APPROACH_CM - WALK_CM_PER_S * (float)(now_ - pr.tArrive) / US_PER_S;
+    }
+    if (!pr.leaving) return pr.standCm;
+    return pr.standCm + WALK_CM_PER_S * (float)(now_ - pr.tLeave) / US_PER_S;
+  }
+
+  bool personMoving(const person_t& pr) const { return now_ < pr.tAtDoor || pr.leaving; }
+
+  //— firmware timers —
+  void armLockTimer() { schedule(now_ + DOOR_LOCK_US, E_LOCK_TIMER, (int)++lockGen_); }
+  void armBacklightTimer() { schedule(now_ + DOOR_BACKLIGHT_US, E_BACKLIGHT_TIMER, (int)++backlightGen_); }
+
+  void notifyServo() {
+    if (!servoPending_) schedule(now_ + SERVO_LATENCY_US, E_SERVO, 0);
+    servoPending_ = true;
+  }
+
+  void servoRun() {
+    servoPending_ = false;
+    lastServoActivityUs_ = now_;
+    bool wasLocked = servoLocked_;
+    servoLocked_ = isLock_;
+    if (wasLocked && !servoLocked_) {
+      st_.unlocks++;
+      unlockedSince_ = now_;
+      violation(V_UNLOCK_NO_GRANT, !anyGrant_ || now_ - lastGrantUs_ > DOOR_LOCK_US);
+    }
+  }
+
+  void handleEvent(const event_t& e) {
+    switch (e.type) {
+      case E_ARRIVE: arrive(); break;
+      case E_AT_DOOR: atDoor(e.person); break;
+      case E_BADGE_START: badgeStart(e.person); break;
+      case E_BADGE_END: badgeEnd(e.person); break;
+      case E_LEAVE: leave(e.person); break;
+      case E_GONE: gone(e.person); break;
+      case E_SERVO: servoRun(); break;
+      case E_LOCK_TIMER:
+        if ((uint64_t)e.person == lockGen_) {  // onLockTimer
+          isLock_ = true;
+          notifyServo();
+        }
+        break;
+      case E_BACKLIGHT_TIMER:
+        if ((uint64_t)e.person == backlightGen_) backlightOn_ = false;  // onBacklightTimer
+        break;
+    }
+  }
+
+  //— sensorReadTask + sensorProcessTask —
+  void sensorSample() {
+    st_.samples++;
+    float nearest = 1e9f;
+    bool pir = false;
+    for (int i : active_) {
+      const person_t& pr = people_[i];
+      float d = personDistance(pr);
+      if (d < nearest) nearest = d;
+      if (d < PIR_RANGE_CM && (personMoving(pr) || uniform() < 0.3)) pir = true;
+    }
+
+    float dist = nearest < 400.0f ? nearest : NO_PERSON_CM;
+    if (dist > 0.0f) {
+      dist += (float)(std::normal_distribution<double>(0.0, p_.noiseCm)(rng_));
+      if (dist < 2.0f) dist = 2.0f;
+    }
+    double r = uniform();
+    if (r < p_.dropout) dist = 0.0f;                                    // echo dropout
+    else if (r < p_.dropout + 0.001) dist = 2.0f + 398.0f * (float)uniform();  // spurious echo
+
+    doorSensorUpdate(&window_, dist, pir, DOOR_CLOSE_SUM_CM, DOOR_MOTION_VOTES, &closeDist_, &motion_);
+    uint16_t distanceMm = (uint16_t)(dist * 10.0f + 0.5f);
+    if (closeDist_ || motion_) st_.detectingSamples++;
+    presenceSummary_t summary;
+    uint8_t edges = presenceUpdate(&presence_, nowMs(), distanceMm, closeDist_, motion_, &summary);
+    if (edges & PRESENCE_ENDED) {
+      st_.presences++;
+      st_.presenceMs += summary.durationMs;
+    }
+    bool present = presenceActive(&presence_);
+    uint8_t approach = approachUpdate(&tracker_, distanceMm, DOOR_SAMPLE_MS, APPROACH_LEAD_MS);
+
+    // presence starts and approach wakes notify taskRFIDReader, which then runs at once
+    someoneThere_ = closeDist_ || motion_ || tracker_.awake;
+    if ((edges & PRESENCE_STARTED) || (approach & APPROACH_WAKE)) nextRfid_ = now_;
+
+    uint8_t hour = (uint8_t)((now_ / (3600 * US_PER_S)) % 24);
+    uint8_t ev = anomalyOnSample(&anomaly_, (uint32_t)(now_ / US_PER_MS), hour, dist, pir, present);
+    countAnomalies(ev);
+
+    if ((closeDist_ || motion_ || (approach & APPROACH_WAKE)) && !backlightOn_) {
+      backlightOn_ = true;
+      armBacklightTimer();
+    }
+  }
+
+  void countAnomalies(uint8_t ev) {
+    for (int b = 0; b < 3; b++)
+      if (ev & (1 << b)) st_.anomalies[b]++;
+  }
+
+  //— taskRFIDReader: power gating and polling —
+  void rfidTask() {
+    bool gated = !p_.alwaysOn;
+    switch (rfidPowerUpdate(&power_, someoneThere_ || !gated, nowMs(), p_.holdoffMs)) {
+      case RFID_PWR_SLEEP:
+        reader_.PCD_AntennaOff();
+        reader_.PCD_SoftPowerDown();
+        break;
+      case RFID_PWR_WAKE:
+        reader_.PCD_SoftPowerUp();
+        reader_.PCD_AntennaOn();
+        rfidPowerWoke(&power_, RFID_WAKE_US);
+        nextRfid_ = now_ + RFID_WAKE_US;  // PCD_SoftPowerUp blocks until the oscillator runs
+        return;
+      default:
+        break;
+    }
+
+    if (rfidPowerPolling(&power_)) rfidPoll();
+    violation(V_READER_ASLEEP, reader_.asleepCommands != readerAsleepCommands_);
+    readerAsleepCommands_ = reader_.asleepCommands;
+    nextRfid_ = now_ + (someoneThere_ ? DOOR_RFID_FAST_POLL_MS : DOOR_RFID_POLL_MS) * US_PER_MS;
+  }
+
+  //— taskRFIDReader inventory + taskPrinter —
+  void rfidPoll() {
+    rfidBatch_t batch;
+    uint8_t found = rfidInventory(reader_, &batch);
+    rfidPowerPolled(&power_, batch.commands);
+    for (simCard_t* c : reader_.field) {
+      if (!c->halted || c->read) continue;
+      c->read = true;
+      st_.badgeReads++;
+      st_.badgeReadHist[std::min<uint64_t>((now_ - c->tIn) / (READ_HIST_MS * US_PER_MS), READ_HIST_BUCKETS)]++;
+    }
+    if (found == 0) return;
+    st_.inventories++;
+    if (batch.count > 1) st_.multiCardPasses++;
+
+    // one decision per pass, as processBatch() does
+    uint64_t minute = now_ / (60 * US_PER_S);
+    accessTime_t at;
+    at.day = (uint16_t)(SIM_START_DAY + minute / 1440);
+    at.dayType = (uint8_t)((at.day + 6) % 7);
+    at.slot = (uint8_t)(minute % 1440 / ACCESS_SLOT_MIN);
+    const char* uids[RFID_MAX_CARDS];
+    bool allowed[RFID_MAX_CARDS];
+    for (int i = 0; i < batch.count; i++) {
+      uids[i] = batch.tags[i].str;
+      uint64_t key = accessKeyFromBytes(batch.tags[i].bytes, batch.tags[i].size);
+      allowed[i] = accessCheck(&access_, key, &at) == ACCESS_OK;
+    }
+    uint8_t pick;
+    doorDecision_t d = doorBatchDecide(lastUID_, sizeof(lastUID_), uids, allowed, batch.count, isLock_, &pick);
+    countAnomalies(anomalyOnScan(&anomaly_, (uint32_t)(now_ / US_PER_MS), allowed[pick]));
+    st_.decisions[d]++;
+    switch (d) {
+      case DOOR_GRANTED:
+        isLock_ = false;
+        notifyServo();
+        armLockTimer();
+        if (!backlightOn_) {
+          backlightOn_ = true;
+          armBacklightTimer();
+        }
+        break;
+      case DOOR_REGRANT:
+        isLock_ = false;
+        notifyServo();
+        armLockTimer();
+        break;
+      case DOOR_IGNORED:
+        break;
+      case DOOR_DENIED:
+        isLock_ = true;
+        break;
+    }
+    if (d == DOOR_GRANTED || d == DOOR_REGRANT) {
+      lastGrantUs_ = now_;
+      anyGrant_ = true;
+    }
+  }
+
+  //— LCDTask: what a person at the door sees, plus invariant checks —
+  void lcdPoll() {
+    bool settled = !servoPending_ && now_ - lastServoActivityUs_ > SETTLE_US;
+    violation(V_SERVO_MISMATCH, settled && servoLocked_ != isLock_);
+    violation(V_UNLOCK_TOO_LONG, !servoLocked_ && now_ - unlockedSince_ > DOOR_LOCK_US + SETTLE_US &&
+                                     now_ - lastGrantUs_ > DOOR_LOCK_US + SETTLE_US);
+    violation(V_BACKLIGHT_GAP, (closeDist_ || motion_) && !backlightOn_);
+  }
+};
+
+//========= DRIVER =========
+
+/** @brief CPU time consumed by the calling thread, in seconds. */
+static double threadCpuSeconds() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/** @brief Parses command-line options. */
+static bool parseArgs(int argc, char** argv, simParams_t* p) {
+  p->days = 7;
+  p->doors = 1;
+  p->threads = (int)std::max(1u, std::thread::hardware_concurrency());
+  p->seed = 1;
+  p->ratePerHour = 30;
+  p->noiseCm = 2.0;
+  p->dropout = 0.02;
+  p->holdoffMs = RFID_HOLDOFF_MS;
+  p->alwaysOn = false;
+  p->verbose = false;
+
+  for (int i = 1; i < argc; i++) {
+    const char* a = argv[i];
+    bool hasVal = i + 1 < argc;
+    if (!strcmp(a, "--days") && hasVal) p->days = atof(argv[++i]);
+    else if (!strcmp(a, "--doors") && hasVal) p->doors = atoi(argv[++i]);
+    else if (!strcmp(a, "--threads") && hasVal) p->threads = atoi(argv[++i]);
+    else if (!strcmp(a, "--seed") && hasVal) p->seed = strtoull(argv[++i], NULL, 10);
+    else if (!strcmp(a, "--rate") && hasVal) p->ratePerHour = atof(argv[++i]);
+    else if (!strcmp(a, "--noise") && hasVal) p->noiseCm = atof(argv[++i]);
+    else if (!strcmp(a, "--dropout") && hasVal) p->dropout = atof(argv[++i]);
+    else if (!strcmp(a, "--holdoff") && hasVal) p->holdoffMs = (uint32_t)atoi(argv[++i]);
+    else if (!strcmp(a, "--always-on")) p->alwaysOn = true;
+    else if (!strcmp(a, "--verbose")) p->verbose = true;
+    else return false;
+  }
+  return p->days > 0 && p->doors > 0 && p->threads > 0 && p->ratePerHour > 0;
+}
+
+int main(int argc, char** argv) {
+  simParams_t p;
+  if (!parseArgs(argc, argv, &p)) {
+    fprintf(stderr, "usage: %s [--days D] [--doors N] [--threads T] [--seed S] [--rate people/h]\n"
+                    "          [--noise cm] [--dropout p] [--holdoff ms] [--always-on] [--verbose]\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<simStats_t> results(p.doors);
+  std::vector<double> doorSeconds(p.doors);
+  std::atomic<int> nextDoor(0);
+  auto wallStart = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < std::min(p.threads, p.doors); t++) {
+    workers.emplace_back([&]() {
+      for (int d; (d = nextDoor++) < p.doors;) {
+        if (p.verbose) fprintf(stderr, "door %d:\n", d);
+        double t0 = threadCpuSeconds();
+        DoorSim sim(p, p.seed * 1000003ULL + d);
+        results[d] = sim.run();
+        doorSeconds[d] = threadCpuSeconds() - t0;
+      }
+    });
+  }
+  for (auto& w : workers) w.join();
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+  simStats_t tot;
+  memset(&tot, 0, sizeof(tot));
+  int doorsWithViolation[V_COUNT] = {};
+  for (const simStats_t& r : results) {
+    const uint64_t* src = (const uint64_t*)&r;
+    uint64_t* dst = (uint64_t*)&tot;
+    for (size_t i = 0; i < offsetof(simStats_t, firstViolationUs) / sizeof(uint64_t); i++) dst[i] += src[i];
+    for (int v = 0; v < V_COUNT; v++)
+      if (r.violations[v]) doorsWithViolation[v]++;
+  }
+
+  double serial = 0;
+  for (double s : doorSeconds) serial += s;
+  double simDays = p.days * p.doors;
+  printf("simulated %.1f door-days (%d doors x %.1f days) in %.2f s wall, %.0fx real time\n",
+         simDays, p.doors, p.days, wall, simDays * 86400.0 / wall);
+  printf("%d threads: %.2f s CPU, %.2fx parallel speedup\n",
+         std::min(p.threads, p.doors), serial, serial / wall);
+  printf("samples %llu, inventory passes %llu (multi-card %llu)\n",
+         (unsigned long long)tot.samples, (unsigned long long)tot.inventories,
+         (unsigned long long)tot.multiCardPasses);
+  printf("people:");
+  for (int k = 0; k < P_KINDS; k++) printf(" %s %llu", kKindNames[k], (unsigned long long)tot.people[k]);
+  printf("\ndecisions: granted %llu, regrant %llu, ignored %llu, denied %llu; unlocks %llu\n",
+         (unsigned long long)tot.decisions[0], (unsigned long long)tot.decisions[1],
+         (unsigned long long)tot.decisions[2], (unsigned long long)tot.decisions[3],
+         (unsigned long long)tot.unlocks);
+  printf("badge holders admitted %llu, missed %llu\n",
+         (unsigned long long)tot.admitted, (unsigned long long)tot.missedAdmissions);
+  printf("presences %llu (%.1f/h, mean %.1f s): %llu log lines instead of %llu detecting samples\n",
+         (unsigned long long)tot.presences, tot.presences / (simDays * 24.0),
+         tot.presences ? tot.presenceMs / 1000.0 / tot.presences : 0.0, (unsigned long long)(2 * tot.presences),
+         (unsigned long long)tot.detectingSamples);
+  printf("anomalies: loitering %llu, denial_burst %llu, high_activity %llu\n",
+         (unsigned long long)tot.anomalies[0], (unsigned long long)tot.anomalies[1],
+         (unsigned long long)tot.anomalies[2]);
+
+  double simHours = simDays * 24.0;
+  printf("rfid reader%s: %.0f commands/h, asleep %.1f%%, %.1f sleeps/h, %llu approach wakes\n",
+         p.alwaysOn ? " (always on)" : "", tot.rfidCommands / simHours,
+         100.0 * tot.rfidAsleepMs / (simHours * 3600000.0), tot.rfidSleeps / simHours,
+         (unsigned long long)tot.approachWakes);
+  auto readPct = [&](double q) {
+    uint64_t want = (uint64_t)(q * tot.badgeReads), seen = 0;
+    for (int b = 0; b <= READ_HIST_BUCKETS; b++)
+      if ((seen += tot.badgeReadHist[b]) > want) return (b + 1) * READ_HIST_MS;
+    return (READ_HIST_BUCKETS + 1) * READ_HIST_MS;
+  };
+  printf("badge-to-read %llu badges, p50 <%d ms, p99 <%d ms, max <%d ms\n", (unsigned long long)tot.badgeReads,
+         readPct(0.5), readPct(0.99), readPct(0.99999999));
+
+  int failed = 0;
+  printf("invariants:\n");
+  for (int v = 0; v < V_COUNT; v++) {
+    printf("  %-16s %8llu episodes on %d/%d doors\n", kViolationNames[v],
+           (unsigned long long)tot.violations[v], doorsWithViolation[v], p.doors);
+    if (tot.violations[v]) failed = 1;
+  }
+  return failed;
+}
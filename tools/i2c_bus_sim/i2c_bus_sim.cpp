@@ -0,0 +1,355 @@
+/**
+ * @file i2c_bus_sim.cpp
+ * @brief Drives the I2C bus arbiter against a simulated bus with latency and NACK injection.
+ *
+ * @details
+ * The arbiter from `i2c_bus.cpp` is built for the host and served by the same
+ * `i2cArbServeNext()` loop as `i2cBusTask`. The simulated backend takes a
+ * fixed time per operation on a virtual microsecond clock, can NACK chosen
+ * RTC reads or LCD writes, and logs every operation in bus order. Producers
+ * are scheduled at virtual times, so a request can arrive while another is on
+ * the bus.
+ *
+ * `--scenarios` checks RTC reads overtaking queued and in-progress LCD
+ * batches, coalescing of superseded field writes, batches larger than
+ * `I2C_LCD_BATCH`, drops on full queues, NACKed operations completing with an
+ * error while the rest is served, and the occupancy and wait statistics. The
+ * exit status is non-zero on any mismatch.
+ *
+ * `--load S` runs S seconds of door-like traffic (RTC reads from the sensor
+ * and access tasks, bursts of LCD field updates) and prints the statistics,
+ * in particular the worst RTC wait against the cost of one LCD field.
+ *
+ * Build:
+ *     g++ -std=c++17 -O2 -I../.. -o i2c_bus_sim i2c_bus_sim.cpp ../../i2c_bus.cpp
+ *
+ * Usage:
+ *     i2c_bus_sim --scenarios
+ *     i2c_bus_sim --load 3600
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+#include "i2c_bus.h"
+
+#define RTC_US 450        ///< DS3231 probe and 7-register read at 100 kHz
+#define LCD_FIELD_US 4000 ///< Cursor move and 8 characters through the PCF8574 backpack
+#define BACKLIGHT_US 200  ///< One expander write
+
+//========= SIMULATED BUS =========
+
+/** @brief A producer action at a virtual time. */
+typedef struct {
+  int64_t at;
+  std::function<void()> fire;
+} event_t;
+
+static int64_t simNow = 0;               ///< Virtual clock, microseconds
+static std::vector<event_t> events;      ///< Pending producer actions, sorted by time
+static std::vector<std::string> busLog;  ///< Operations in bus order
+static std::set<int> nackRtc, nackLcd;   ///< Operation numbers (from 1) that NACK
+static int rtcOps, lcdOps;
+static i2cArbiter_t arb;
+
+static int64_t simClock() { return simNow; }
+
+/** @brief Schedules a producer action. */
+static void at(int64_t us, std::function<void()> fire) {
+  event_t e = { us, fire };
+  events.insert(std::upper_bound(events.begin(), events.end(), e,
+                                 [](const event_t& a, const event_t& b) { return a.at < b.at; }),
+                e);
+}
+
+/** @brief Advances the clock, firing producer actions that fall inside the interval. */
+static void advance(int64_t us) {
+  int64_t end = simNow + us;
+  while (!events.empty() && events.front().at <= end) {
+    event_t e = events.front();
+    events.erase(events.begin());
+    simNow = e.at > simNow ? e.at : simNow;
+    e.fire();
+  }
+  simNow = end;
+}
+
+static bool simRtcRead(rtcTime_t* out) {
+  advance(RTC_US);
+  bool ok = !nackRtc.count(++rtcOps);
+  busLog.push_back(ok ? "R" : "R!");
+  rtcTime_t t = { 2025, 6, 1, 12, (uint8_t)(simNow / 60000000 % 60), (uint8_t)(simNow / 1000000 % 60), 0 };
+  *out = t;
+  return ok;
+}
+
+static bool simLcdText(uint8_t row, uint8_t col, uint8_t width, const char* text) {
+  (void)width;
+  advance(LCD_FIELD_US);
+  bool ok = !nackLcd.count(++lcdOps);
+  busLog.push_back(std::string(ok ? "L" : "L!") + (char)('0' + row) + ":" + std::to_string(col) + "=" + text);
+  return ok;
+}
+
+static bool simLcdBacklight(bool on) {
+  advance(BACKLIGHT_US);
+  bool ok = !nackLcd.count(++lcdOps);
+  busLog.push_back(std::string(ok ? "B" : "B!") + (on ? "on" : "off"));
+  return ok;
+}
+
+static const i2cBackend_t simBackend = { simRtcRead, simLcdText, simLcdBacklight };
+
+static void reset() {
+  simNow = 0;
+  events.clear();
+  busLog.clear();
+  nackRtc.clear();
+  nackLcd.clear();
+  rtcOps = lcdOps = 0;
+  i2cArbInit(&arb);
+}
+
+/** @brief Serves requests and fires producers until both run out, like i2cBusTask. */
+static void run() {
+  while (1) {
+    if (i2cArbServeNext(&arb, &simBackend, simClock)) continue;
+    if (events.empty()) break;
+    advance(events.front().at - simNow);
+  }
+}
+
+//========= PRODUCERS =========
+
+/** @brief Result of one RTC read as seen by its callback. */
+typedef struct {
+  bool completed;
+  bool ok;
+  bool gotTime;
+} readResult_t;
+
+static void readDone(bool ok, const rtcTime_t* time, void* ctx) {
+  readResult_t* r = (readResult_t*)ctx;
+  r->completed = true;
+  r->ok = ok;
+  r->gotTime = time != NULL;
+}
+
+static bool rtcRead(readResult_t* r) {
+  i2cRequest_t req;
+  memset(&req, 0, sizeof(req));
+  req.op = I2C_OP_RTC_READ;
+  req.done = r ? readDone : NULL;
+  req.ctx = r;
+  return i2cArbSubmit(&arb, I2C_PRIO_HIGH, &req, simClock);
+}
+
+static bool lcdText(uint8_t row, uint8_t col, const char* text) {
+  i2cRequest_t req;
+  memset(&req, 0, sizeof(req));
+  req.op = I2C_OP_LCD_TEXT;
+  req.row = row;
+  req.col = col;
+  req.width = 8;
+  strncpy(req.text, text, I2C_LCD_TEXT_MAX);
+  return i2cArbSubmit(&arb, I2C_PRIO_LOW, &req, simClock);
+}
+
+static bool backlight(bool on) {
+  i2cRequest_t req;
+  memset(&req, 0, sizeof(req));
+  req.op = I2C_OP_LCD_BACKLIGHT;
+  req.on = on;
+  return i2cArbSubmit(&arb, I2C_PRIO_LOW, &req, simClock);
+}
+
+//========= SCENARIOS =========
+
+static std::string join(const std::vector<std::string>& v) {
+  std::string s;
+  for (const std::string& x : v) s += (s.empty() ? "" : " ") + x;
+  return s;
+}
+
+/** @brief Compares the bus log and prints the outcome. */
+static bool expectLog(const char* name, const std::vector<std::string>& want, bool extra = true) {
+  bool ok = busLog == want && extra;
+  printf("%-36s %s\n", name, ok ? "ok" : "FAIL");
+  if (!ok) printf("    want %s\n    got  %s\n", join(want).c_str(), join(busLog).c_str());
+  return ok;
+}
+
+static bool rtcBeforeQueuedLcd() {
+  reset();
+  lcdText(0, 0, "a");
+  lcdText(0, 8, "b");
+  lcdText(1, 0, "c");
+  rtcRead(NULL);
+  rtcRead(NULL);
+  run();
+  return expectLog("RTC reads before queued LCD", { "R", "R", "L0:0=a", "L0:8=b", "L1:0=c" });
+}
+
+static bool rtcOvertakesBatch() {
+  reset();
+  const char* text[] = { "f0", "f1", "f2", "f3", "f4", "f5" };
+  for (int i = 0; i < 6; i++) lcdText(i / 2, (i % 2) * 8, text[i]);
+  at(LCD_FIELD_US + 100, [] { rtcRead(NULL); });  // while the second field is on the bus
+  run();
+  i2cBusStats_t& s = arb.stats;
+  bool waitOk = s.maxWaitUs[I2C_PRIO_HIGH] <= LCD_FIELD_US && s.served[I2C_PRIO_HIGH] == 1;
+  bool busyOk = s.dev[I2C_DEV_LCD].busyUs == 6 * LCD_FIELD_US && s.dev[I2C_DEV_RTC].busyUs == RTC_US;
+  if (!waitOk || !busyOk) {
+    printf("    RTC max wait %u us (at most %d), LCD busy %llu us, RTC busy %llu us\n", s.maxWaitUs[I2C_PRIO_HIGH],
+           LCD_FIELD_US, (unsigned long long)s.dev[I2C_DEV_LCD].busyUs,
+           (unsigned long long)s.dev[I2C_DEV_RTC].busyUs);
+  }
+  return expectLog("RTC read overtakes an LCD batch",
+                   { "L0:0=f0", "L0:8=f1", "R", "L1:0=f2", "L1:8=f3", "L2:0=f4", "L2:8=f5" }, waitOk && busyOk);
+}
+
+static bool supersededWrites() {
+  reset();
+  const char* text[] = { "1", "2", "3", "4", "5" };
+  lcdText(0, 0, "state");
+  for (int i = 0; i < 5; i++) lcdText(0, 8, text[i]);
+  backlight(true);
+  backlight(false);
+  run();
+  bool ok = arb.stats.coalesced == 5;
+  if (!ok) printf("    coalesced %u, want 5\n", arb.stats.coalesced);
+  return expectLog("superseded writes coalesced", { "L0:0=state", "L0:8=5", "Boff" }, ok);
+}
+
+static bool largeBatch() {
+  reset();
+  std::vector<std::string> want;
+  for (int i = 0; i < 12; i++) {
+    std::string t = "x" + std::to_string(i);
+    lcdText(i % 2, i * 2 % 16 + i / 8, t.c_str());
+    want.push_back("L" + std::to_string(i % 2) + ":" + std::to_string(i * 2 % 16 + i / 8) + "=" + t);
+  }
+  // lands in the queue while the first batch is written: a second batch, not merged into the first
+  at(100, [] { lcdText(0, 0, "late"); });
+  want.push_back("L0:0=late");
+  run();
+  return expectLog("more fields than one batch", want);
+}
+
+static bool fullQueues() {
+  reset();
+  int lcd = 0, rtc = 0;
+  for (int i = 0; i < 20; i++) lcd += lcdText(0, (uint8_t)i, "q");
+  for (int i = 0; i < 10; i++) rtc += rtcRead(NULL);
+  run();
+  i2cBusStats_t& s = arb.stats;
+  bool ok = lcd == I2C_LOW_QUEUE_LEN && rtc == I2C_HIGH_QUEUE_LEN && s.dropped == 6 &&
+            s.served[I2C_PRIO_HIGH] == I2C_HIGH_QUEUE_LEN && s.served[I2C_PRIO_LOW] == I2C_LOW_QUEUE_LEN;
+  printf("%-36s %s\n", "full queues drop", ok ? "ok" : "FAIL");
+  if (!ok) {
+    printf("    accepted %d LCD, %d RTC, dropped %u, served %u high, %u low\n", lcd, rtc, s.dropped,
+           s.served[I2C_PRIO_HIGH], s.served[I2C_PRIO_LOW]);
+  }
+  return ok;
+}
+
+static bool nacks() {
+  reset();
+  nackRtc.insert(2);
+  nackLcd.insert(2);
+  readResult_t r[3] = {};
+  for (int i = 0; i < 3; i++) rtcRead(&r[i]);
+  lcdText(0, 0, "a");
+  lcdText(0, 8, "b");
+  lcdText(1, 0, "c");
+  run();
+  i2cBusStats_t& s = arb.stats;
+  bool ok = r[0].completed && r[0].ok && r[0].gotTime && r[1].completed && !r[1].ok && !r[1].gotTime &&
+            r[2].completed && r[2].ok && r[2].gotTime && s.dev[I2C_DEV_RTC].nacks == 1 &&
+            s.dev[I2C_DEV_LCD].nacks == 1 && s.dev[I2C_DEV_RTC].transactions == 3 &&
+            s.dev[I2C_DEV_LCD].transactions == 3;
+  if (!ok) {
+    printf("    reads ok %d/%d/%d, nacks RTC %u LCD %u\n", r[0].ok, r[1].ok, r[2].ok, s.dev[I2C_DEV_RTC].nacks,
+           s.dev[I2C_DEV_LCD].nacks);
+  }
+  return expectLog("NACKs complete with an error", { "R", "R!", "R", "L0:0=a", "L!0:8=b", "L1:0=c" }, ok);
+}
+
+static int runScenarios() {
+  int failed = 0;
+  failed += !rtcBeforeQueuedLcd();
+  failed += !rtcOvertakesBatch();
+  failed += !supersededWrites();
+  failed += !largeBatch();
+  failed += !fullQueues();
+  failed += !nacks();
+  printf("%d scenario(s) failed\n", failed);
+  return failed ? 1 : 0;
+}
+
+//========= LOAD =========
+
+static uint32_t seed = 1;
+static uint32_t rnd(uint32_t n) {
+  seed = seed * 1103515245u + 12345u;
+  return (seed >> 8) % n;
+}
+
+/** @brief RTC reads at random intervals around `meanMs`. */
+static void rtcProducer(int64_t t, int64_t endUs, uint32_t meanMs) {
+  if (t >= endUs) return;
+  at(t, [=] {
+    rtcRead(NULL);
+    rtcProducer(t + 1000 * (int64_t)(meanMs / 2 + rnd(meanMs)), endUs, meanMs);
+  });
+}
+
+/** @brief The LCD task refreshing both fields, plus occasional backlight changes. */
+static void lcdProducer(int64_t t, int64_t endUs) {
+  if (t >= endUs) return;
+  at(t, [=] {
+    lcdText(0, 8, rnd(2) ? "YES" : "NO");
+    lcdText(1, 7, rnd(2) ? "LOCKED" : "OPEN");
+    if (rnd(10) == 0) backlight(rnd(2));
+    lcdProducer(t + 1000 * (int64_t)(50 + rnd(200)), endUs);
+  });
+}
+
+static int runLoad(long seconds) {
+  reset();
+  int64_t endUs = seconds * 1000000LL;
+  rtcProducer(0, endUs, 60000);  // anomaly hour refresh
+  rtcProducer(0, endUs, 5000);   // presence / scan timestamps
+  lcdProducer(0, endUs);
+  run();
+
+  i2cBusStats_t& s = arb.stats;
+  printf("%ld s of traffic, bus busy %.2f%%\n", seconds,
+         100.0 * (s.dev[I2C_DEV_RTC].busyUs + s.dev[I2C_DEV_LCD].busyUs) / endUs);
+  printf("RTC: %u reads, avg wait %.0f us, max wait %u us (one LCD field is %d us)\n", s.served[I2C_PRIO_HIGH],
+         s.served[I2C_PRIO_HIGH] ? (double)s.waitUs[I2C_PRIO_HIGH] / s.served[I2C_PRIO_HIGH] : 0.0,
+         s.maxWaitUs[I2C_PRIO_HIGH], LCD_FIELD_US);
+  printf("LCD: %u writes, avg wait %.0f us, max wait %u us, coalesced %u, dropped %u\n", s.served[I2C_PRIO_LOW],
+         s.served[I2C_PRIO_LOW] ? (double)s.waitUs[I2C_PRIO_LOW] / s.served[I2C_PRIO_LOW] : 0.0,
+         s.maxWaitUs[I2C_PRIO_LOW], s.coalesced, s.dropped);
+  return s.maxWaitUs[I2C_PRIO_HIGH] <= LCD_FIELD_US + RTC_US * I2C_HIGH_QUEUE_LEN ? 0 : 1;
+}
+
+//========= MAIN =========
+
+int main(int argc, char** argv) {
+  if (argc == 2 && !strcmp(argv[1], "--scenarios")) return runScenarios();
+  if (argc == 3 && !strcmp(argv[1], "--load")) return runLoad(atol(argv[2]));
+  fprintf(stderr, "usage: %s --scenarios | --load seconds\n", argv[0]);
+  return 2;
+}
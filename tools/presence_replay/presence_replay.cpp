@@ -0,0 +1,236 @@
+/**
+ * @file presence_replay.cpp
+ * @brief Checks the presence tracker against scripted traces and replays recorded captures.
+ *
+ * @details
+ * `--scenarios` builds traces of 20 ms samples from scripted segments (so
+ * long of proximity at some distance, motion, nothing...) and compares the
+ * started / ended events and every ended summary with the expected values:
+ * start time, duration, sample count, min and mean distance. The scripts cover
+ * an empty doorway, a single presence, a one-sample blip, gaps shorter and
+ * longer than `PRESENCE_OFF_MS`, motion without an echo, a presence still open
+ * at the end of the trace, a presence spanning the `millis()` wrap and a
+ * ten-minute presence. The exit status is non-zero on any mismatch.
+ *
+ * Recorded mode reads the CSV written by `tools/telemetry_collector` (from a
+ * file or stdin; the firmware must be streaming raw samples) and feeds the
+ * `close` / `motion` flags of every `sample` record through
+ * `presenceUpdate()`, printing the events the firmware would have raised in
+ * the collector's own `presence` format. `--bench N` times the tracker on N
+ * samples.
+ *
+ * Build:
+ *     g++ -std=c++17 -O2 -I../.. -o presence_replay presence_replay.cpp ../../presence.cpp
+ *
+ * Usage:
+ *     presence_replay --scenarios
+ *     presence_replay [capture.csv]
+ *     presence_replay --bench 10000000
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "presence.h"
+
+#define SAMPLE_MS 20  ///< Firmware sample period (DOOR_SAMPLE_MS)
+
+//========= SCRIPTED TRACES =========
+
+/** @brief One stretch of identical samples. */
+typedef struct {
+  uint32_t ms;   ///< Length of the stretch
+  uint16_t mm;   ///< Distance, 0 for no echo
+  bool close;    ///< Proximity flag
+  bool motion;   ///< Motion flag
+} segment_t;
+
+/** @brief A scripted trace and the events it must produce. */
+typedef struct {
+  const char* name;
+  uint32_t t0;                               ///< Time of the first sample
+  std::vector<segment_t> segments;
+  unsigned starts;                           ///< Expected started events
+  std::vector<presenceSummary_t> ended;      ///< Expected ended summaries, in order
+} scenario_t;
+
+static segment_t idle(uint32_t ms) { return { ms, 0, false, false }; }
+static segment_t near(uint32_t ms, uint16_t mm) { return { ms, mm, true, false }; }
+static segment_t moving(uint32_t ms) { return { ms, 0, false, true }; }
+
+static presenceSummary_t summary(uint32_t startMs, uint32_t durationMs, uint32_t samples, uint16_t minMm,
+                                 uint16_t meanMm, bool close, bool motion) {
+  presenceSummary_t s = { startMs, durationMs, samples, minMm, meanMm, close, motion };
+  return s;
+}
+
+static std::vector<scenario_t> scenarios() {
+  std::vector<scenario_t> v;
+  v.push_back({ "empty doorway", 0, { idle(5000) }, 0, {} });
+  v.push_back({ "single presence", 1000, { idle(100), near(1000, 500), idle(1000) }, 1,
+                { summary(1100, 980, 50, 500, 500, true, false) } });
+  v.push_back({ "one-sample blip", 0, { idle(100), near(SAMPLE_MS, 300), idle(1000) }, 0, {} });
+  v.push_back({ "gap shorter than off time", 0, { near(400, 600), idle(300), near(400, 400), idle(1000) }, 1,
+                { summary(0, 1080, 40, 400, 500, true, false) } });
+  v.push_back({ "gap longer than off time", 0, { near(400, 600), idle(600), near(400, 400), idle(1000) }, 2,
+                { summary(0, 380, 20, 600, 600, true, false), summary(1000, 380, 20, 400, 400, true, false) } });
+  v.push_back({ "motion without echo", 0, { idle(200), moving(500), idle(1000) }, 1,
+                { summary(200, 480, 25, 0, 0, false, true) } });
+  v.push_back({ "echo and motion mixed", 0,
+                { near(100, 450), moving(100), near(100, 550), moving(100), idle(1000) }, 1,
+                { summary(0, 380, 20, 450, 500, true, true) } });
+  v.push_back({ "open at end of trace", 0, { idle(100), near(2000, 700) }, 1, {} });
+  v.push_back({ "across millis() wrap", 0xFFFFFF00u, { near(1000, 500), idle(1000) }, 1,
+                { summary(0xFFFFFF00u, 980, 50, 500, 500, true, false) } });
+
+  // ten minutes alternating 400 / 600 mm: exercises the wide sum
+  scenario_t lng = { "ten-minute presence", 0, {}, 1, { summary(0, 599980, 30000, 400, 500, true, false) } };
+  for (int i = 0; i < 15000; i++) {
+    lng.segments.push_back(near(SAMPLE_MS, 400));
+    lng.segments.push_back(near(SAMPLE_MS, 600));
+  }
+  lng.segments.push_back(idle(1000));
+  v.push_back(lng);
+  return v;
+}
+
+static bool sameSummary(const presenceSummary_t& a, const presenceSummary_t& b) {
+  return a.startMs == b.startMs && a.durationMs == b.durationMs && a.samples == b.samples && a.minMm == b.minMm &&
+         a.meanMm == b.meanMm && a.close == b.close && a.motion == b.motion;
+}
+
+static void printSummary(const char* label, const presenceSummary_t& s) {
+  printf("    %s start %u, %u ms, %u samples, min %u mm, mean %u mm, close %d, motion %d\n", label, s.startMs,
+         s.durationMs, s.samples, s.minMm, s.meanMm, s.close, s.motion);
+}
+
+/**
+ * @brief Runs one scenario; returns true if the events match.
+ */
+static bool runScenario(const scenario_t& sc) {
+  presenceTracker_t p;
+  presenceInit(&p);
+  unsigned starts = 0;
+  std::vector<presenceSummary_t> ended;
+  uint32_t t = sc.t0;
+  unsigned samples = 0;
+  for (const segment_t& seg : sc.segments) {
+    for (uint32_t ms = 0; ms < seg.ms; ms += SAMPLE_MS, t += SAMPLE_MS, samples++) {
+      presenceSummary_t s;
+      uint8_t ev = presenceUpdate(&p, t, seg.mm, seg.close, seg.motion, &s);
+      if (ev & PRESENCE_STARTED) starts++;
+      if (ev & PRESENCE_ENDED) ended.push_back(s);
+    }
+  }
+
+  bool ok = starts == sc.starts && ended.size() == sc.ended.size();
+  for (size_t i = 0; ok && i < ended.size(); i++) ok = sameSummary(ended[i], sc.ended[i]);
+  printf("%-28s %6u samples: %u started, %zu ended, %s at end  %s\n", sc.name, samples, starts, ended.size(),
+         presenceActive(&p) ? "present" : "empty", ok ? "ok" : "FAIL");
+  if (!ok) {
+    printf("    expected %u started, %zu ended\n", sc.starts, sc.ended.size());
+    for (const presenceSummary_t& s : sc.ended) printSummary("want", s);
+    for (const presenceSummary_t& s : ended) printSummary("got ", s);
+  }
+  return ok;
+}
+
+static int runScenarios() {
+  int failed = 0;
+  for (const scenario_t& sc : scenarios()) failed += !runScenario(sc);
+  printf("%d scenario(s) failed\n", failed);
+  return failed ? 1 : 0;
+}
+
+//========= RECORDED TRACES =========
+
+/**
+ * @brief Replays the `sample` records of a collector CSV.
+ */
+static int replay(FILE* in) {
+  presenceTracker_t p;
+  presenceInit(&p);
+  char line[256];
+  unsigned samples = 0, starts = 0, ends = 0;
+  while (fgets(line, sizeof(line), in)) {
+    unsigned t, seq, pir, close, motion;
+    char type[16];
+    float cm;
+    if (sscanf(line, "%u,%u,%15[^,],%f,%u,%u,%u", &t, &seq, type, &cm, &pir, &close, &motion) != 7 ||
+        strcmp(type, "sample")) {
+      continue;
+    }
+    samples++;
+
+    presenceSummary_t s;
+    uint8_t ev = presenceUpdate(&p, t, (uint16_t)lroundf(cm * 10.0f), close, motion, &s);
+    if (ev & PRESENCE_STARTED) {
+      starts++;
+      printf("%u,presence,start\n", t);
+    }
+    if (ev & PRESENCE_ENDED) {
+      ends++;
+      printf("%u,presence,%u,%u,%u,%.1f,%.1f\n", t, s.startMs, s.durationMs, s.samples, s.minMm / 10.0,
+             s.meanMm / 10.0);
+    }
+  }
+  fprintf(stderr, "%u samples: %u presences started, %u ended, present at end %d\n", samples, starts, ends,
+          presenceActive(&p));
+  return 0;
+}
+
+//========= BENCHMARK =========
+
+static int runBench(long n) {
+  std::vector<segment_t> z;
+  uint32_t seed = 1;
+  while ((long)z.size() < n) {
+    seed = seed * 1103515245u + 12345u;
+    uint32_t len = 1 + (seed >> 16) % 200;
+    segment_t seg = (seed & 0x300) ? idle(0) : near(0, (uint16_t)(300 + (seed >> 8) % 1000));
+    seg.motion = (seed & 0xC00) == 0;
+    for (uint32_t i = 0; i < len && (long)z.size() < n; i++) z.push_back(seg);
+  }
+
+  presenceTracker_t p;
+  presenceInit(&p);
+  unsigned events = 0;
+  uint32_t t = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (const segment_t& s : z) {
+    presenceSummary_t sum;
+    events += presenceUpdate(&p, t += SAMPLE_MS, s.mm, s.close, s.motion, &sum) != PRESENCE_NONE;
+  }
+  double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  printf("%ld samples in %.3f s: %.1f ns/sample, %u events, state %zu B\n", n, sec, sec * 1e9 / n, events,
+         sizeof(presenceTracker_t));
+  return 0;
+}
+
+//========= MAIN =========
+
+int main(int argc, char** argv) {
+  if (argc == 2 && !strcmp(argv[1], "--scenarios")) return runScenarios();
+  if (argc == 3 && !strcmp(argv[1], "--bench")) return runBench(atol(argv[2]));
+
+  FILE* in = stdin;
+  if (argc == 2 && argv[1][0] != '-') {
+    in = fopen(argv[1], "r");
+    if (!in) {
+      perror(argv[1]);
+      return 2;
+    }
+  } else if (argc != 1) {
+    fprintf(stderr, "usage: %s --scenarios | [capture.csv] | --bench N\n", argv[0]);
+    return 2;
+  }
+  return replay(in);
+}
@@ -0,0 +1,235 @@
+/**
+ * @file profiler_sim.cpp
+ * @brief Checks the CPU profiler's window accounting against synthetic task counters.
+ *
+ * @details
+ * Feeds `profAccount()` the samples the board would take from
+ * `uxTaskGetSystemState()` at the end of successive windows, on two cores
+ * with their idle tasks, and checks the report: window length, per-core busy
+ * share, per-task CPU share and wakeups, ISR rates and durations. The
+ * scenarios cover the first window since boot, counter wrap-around, tasks
+ * created and deleted between reports, empty windows and the ISR maximum
+ * reset. A last check times a real `PROF_ISR_BEGIN()`/`PROF_ISR_END()` pair
+ * on the host clock. The exit status is non-zero on any mismatch.
+ *
+ * Build:
+ *     g++ -std=c++17 -O2 -I../.. -o profiler_sim profiler_sim.cpp ../../profiler.cpp
+ *
+ * Usage:
+ *     profiler_sim --scenarios
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "profiler.h"
+
+//========= SIMULATED TASKS =========
+
+/** @brief Stand-ins for task handles: only their addresses matter. */
+static char idle0, idle1, sensor, reader, printer, burst;
+static const void* idleHandles[] = { &idle0, &idle1 };
+
+#define CPU_MHZ 240  ///< Cycle counter ticks per microsecond
+
+static profAccount_t acc;
+static profReport_t rep;
+static int failures = 0;
+
+static void check(const char* what, bool ok) {
+  printf("  %-52s %s\n", what, ok ? "ok" : "FAIL");
+  failures += !ok;
+}
+
+static bool near(float a, float b) { return fabsf(a - b) < 0.05f; }
+
+static const profTaskLine_t* line(const char* name) {
+  for (int i = 0; i < rep.numTasks; i++)
+    if (!strcmp(rep.tasks[i].name, name)) return &rep.tasks[i];
+  return NULL;
+}
+
+static void reset() {
+  memset(&acc, 0, sizeof(acc));
+  memset(profIsrStats, 0, sizeof(profIsrStats));
+}
+
+//========= SCENARIOS =========
+
+/** @brief First report covers the time since boot. */
+static void firstWindow() {
+  printf("first window since boot\n");
+  reset();
+  // 2 s since boot: core 0 idles 1.5 s, core 1 idles 1.9 s
+  profTaskSample_t t[] = {
+    { &idle0, "IDLE0", 1500000, 0, 900 },
+    { &idle1, "IDLE1", 1900000, 0, 900 },
+    { &sensor, "Sensor", 400000, 100, 1200 },
+    { &printer, "Printer", 100000, 4, 2400 },
+  };
+  bool ok = profAccount(&acc, t, 4, 2000000, idleHandles, 2, profIsrStats, CPU_MHZ, &rep);
+  check("report produced", ok);
+  check("window 2000 ms", rep.windowUs == 2000000);
+  check("core0 busy 25%", near(rep.coreBusy[0], 25.0f));
+  check("core1 busy 5%", near(rep.coreBusy[1], 5.0f));
+  check("Sensor 20% cpu, 50 wakes/s", near(line("Sensor")->cpuPct, 20.0f) && near(line("Sensor")->wakesPerSec, 50.0f));
+  check("Printer 5% cpu, 2 wakes/s", near(line("Printer")->cpuPct, 5.0f) && near(line("Printer")->wakesPerSec, 2.0f));
+  check("stack high-water mark passed through", line("Printer")->stackFree == 2400);
+}
+
+/** @brief Second window is a delta, across a 32-bit wrap of every counter. */
+static void counterWrap() {
+  printf("second window across counter wrap\n");
+  reset();
+  uint32_t base = 0xFFFFFFFFu - 500000;
+  profTaskSample_t t0[] = {
+    { &idle0, "IDLE0", base, 0, 900 },
+    { &idle1, "IDLE1", base - 7, 0, 900 },
+    { &sensor, "Sensor", base - 3, 0xFFFFFFF0u, 1200 },
+  };
+  profAccount(&acc, t0, 3, base, idleHandles, 2, profIsrStats, CPU_MHZ, &rep);
+
+  // 1 s later: idle0 +600 ms, idle1 +900 ms, Sensor +300 ms and 40 wakes
+  profTaskSample_t t1[] = {
+    { &idle0, "IDLE0", base + 600000, 0, 900 },
+    { &idle1, "IDLE1", base - 7 + 900000, 0, 900 },
+    { &sensor, "Sensor", base - 3 + 300000, 0xFFFFFFF0u + 40, 1150 },
+  };
+  bool ok = profAccount(&acc, t1, 3, base + 1000000, idleHandles, 2, profIsrStats, CPU_MHZ, &rep);
+  check("report produced", ok);
+  check("window 1000 ms", rep.windowUs == 1000000);
+  check("core0 busy 40%", near(rep.coreBusy[0], 40.0f));
+  check("core1 busy 10%", near(rep.coreBusy[1], 10.0f));
+  check("Sensor 30% cpu, 40 wakes/s", near(line("Sensor")->cpuPct, 30.0f) && near(line("Sensor")->wakesPerSec, 40.0f));
+}
+
+/** @brief Tasks created during a window are charged their whole counter; deleted ones vanish. */
+static void taskChurn() {
+  printf("task created and deleted between reports\n");
+  reset();
+  profTaskSample_t t0[] = {
+    { &idle0, "IDLE0", 800000, 0, 900 },
+    { &idle1, "IDLE1", 900000, 0, 900 },
+    { &reader, "RFID", 100000, 10, 1000 },
+    { &burst, "Burst", 50000, 1, 500 },
+  };
+  profAccount(&acc, t0, 4, 1000000, idleHandles, 2, profIsrStats, CPU_MHZ, &rep);
+
+  // Burst deleted, Printer created 0.5 s into the window and ran 50 ms
+  profTaskSample_t t1[] = {
+    { &idle0, "IDLE0", 1600000, 0, 900 },
+    { &idle1, "IDLE1", 1850000, 0, 900 },
+    { &reader, "RFID", 200000, 20, 1000 },
+    { &printer, "Printer", 50000, 3, 2400 },
+  };
+  profAccount(&acc, t1, 4, 2000000, idleHandles, 2, profIsrStats, CPU_MHZ, &rep);
+  check("deleted task not reported", line("Burst") == NULL);
+  check("new task charged its own counter (5%)", near(line("Printer")->cpuPct, 5.0f));
+  check("new task wakes from zero (3/s)", near(line("Printer")->wakesPerSec, 3.0f));
+  check("surviving task delta (10%)", near(line("RFID")->cpuPct, 10.0f));
+
+  // the new task's slot is kept for the next window
+  profTaskSample_t t2[] = {
+    { &idle0, "IDLE0", 2600000, 0, 900 },
+    { &idle1, "IDLE1", 2850000, 0, 900 },
+    { &reader, "RFID", 300000, 30, 1000 },
+    { &printer, "Printer", 70000, 5, 2400 },
+  };
+  profAccount(&acc, t2, 4, 3000000, idleHandles, 2, profIsrStats, CPU_MHZ, &rep);
+  check("new task then reported as a delta (2%)", near(line("Printer")->cpuPct, 2.0f));
+}
+
+/** @brief An empty window neither reports nor advances the counters. */
+static void emptyWindow() {
+  printf("empty window\n");
+  reset();
+  profTaskSample_t t[] = {
+    { &idle0, "IDLE0", 500000, 0, 900 },
+    { &sensor, "Sensor", 500000, 50, 1200 },
+  };
+  profAccount(&acc, t, 2, 1000000, idleHandles, 1, profIsrStats, CPU_MHZ, &rep);
+  check("no report for a zero-length window",
+        !profAccount(&acc, t, 2, 1000000, idleHandles, 1, profIsrStats, CPU_MHZ, &rep));
+  check("no report without tasks", !profAccount(&acc, t, 0, 2000000, idleHandles, 1, profIsrStats, CPU_MHZ, &rep));
+  t[0].runTime = 1250000;
+  t[1].runTime = 750000;
+  profAccount(&acc, t, 2, 2000000, idleHandles, 1, profIsrStats, CPU_MHZ, &rep);
+  check("next window still measured from the last report", rep.windowUs == 1000000 &&
+        near(rep.coreBusy[0], 25.0f) && near(line("Sensor")->cpuPct, 25.0f));
+  profTaskSample_t noIdle[] = { { &sensor, "Sensor", 900000, 60, 1200 } };
+  profAccount(&acc, noIdle, 1, 3000000, idleHandles, 2, profIsrStats, CPU_MHZ, &rep);
+  check("core without an idle sample is negative", rep.coreBusy[0] < 0.0f && rep.coreBusy[1] < 0.0f);
+}
+
+/** @brief ISR rates, mean and maximum per window; the maximum starts over each window. */
+static void isrAccounting() {
+  printf("ISR accounting\n");
+  reset();
+  profTaskSample_t t[] = { { &idle0, "IDLE0", 0, 0, 900 } };
+
+  // earlier windows left the echo cycle total 600000 short of wrapping
+  profIsrStats[PROF_ISR_ECHO].count = 1000;
+  profIsrStats[PROF_ISR_ECHO].cycles = 0xFFFFFFFFu - 600000 + 1;
+  profAccount(&acc, t, 1, 500000, idleHandles, 1, profIsrStats, CPU_MHZ, &rep);
+
+  // 1 s: 200 echo interrupts of 12 us average, longest 30 us
+  profIsrStats[PROF_ISR_ECHO].count += 200;
+  profIsrStats[PROF_ISR_ECHO].cycles += 200 * 12 * CPU_MHZ;
+  profIsrStats[PROF_ISR_ECHO].maxCycles = 30 * CPU_MHZ;
+  t[0].runTime = 900000;
+  profAccount(&acc, t, 1, 1500000, idleHandles, 1, profIsrStats, CPU_MHZ, &rep);
+  const profIsrLine_t* e = &rep.isrs[PROF_ISR_ECHO];
+  check("echoISR 200/s", near(e->perSec, 200.0f));
+  check("echoISR avg 12 us, max 30 us", near(e->avgUs, 12.0f) && near(e->maxUs, 30.0f));
+  check("echoISR 0.24% of the window", near(e->totalPct, 0.24f));
+  check("maximum reset for the next window", profIsrStats[PROF_ISR_ECHO].maxCycles == 0);
+  check("idle timer reports zero", rep.isrs[PROF_ISR_LOCK_TIMER].perSec == 0.0f &&
+        rep.isrs[PROF_ISR_LOCK_TIMER].avgUs == 0.0f);
+
+  // next 1 s: 100 more of 5 us; the cycle total wraps
+  profIsrStats[PROF_ISR_ECHO].count += 100;
+  profIsrStats[PROF_ISR_ECHO].cycles += 100 * 5 * CPU_MHZ;
+  profIsrStats[PROF_ISR_ECHO].maxCycles = 6 * CPU_MHZ;
+  t[0].runTime = 1800000;
+  profAccount(&acc, t, 1, 2500000, idleHandles, 1, profIsrStats, CPU_MHZ, &rep);
+  check("cycle total wrapped", profIsrStats[PROF_ISR_ECHO].cycles < 600000);
+  check("second window: 100/s, avg 5 us, max 6 us",
+        near(e->perSec, 100.0f) && near(e->avgUs, 5.0f) && near(e->maxUs, 6.0f));
+}
+
+/** @brief The real macros time an ISR body on the host clock. */
+static void isrMacros() {
+  printf("ISR macros on the host clock\n");
+  reset();
+  for (int n = 0; n < 3; n++) {
+    PROF_ISR_BEGIN();
+    volatile uint32_t spin = 0;
+    for (int i = 0; i < 10000; i++) spin += i;
+    PROF_ISR_END(PROF_ISR_BACKLIGHT_TIMER);
+  }
+  const profIsrStats_t* s = &profIsrStats[PROF_ISR_BACKLIGHT_TIMER];
+  check("three invocations counted", s->count == 3);
+  check("time accumulated, maximum within total", s->cycles > 0 && s->maxCycles > 0 && s->maxCycles <= s->cycles);
+}
+
+//========= MAIN =========
+
+int main(int argc, char** argv) {
+  if (argc != 2 || strcmp(argv[1], "--scenarios")) {
+    fprintf(stderr, "usage: %s --scenarios\n", argv[0]);
+    return 2;
+  }
+  firstWindow();
+  counterWrap();
+  taskChurn();
+  emptyWindow();
+  isrAccounting();
+  isrMacros();
+  printf("%d check(s) failed\n", failures);
+  return failures ? 1 : 0;
+}
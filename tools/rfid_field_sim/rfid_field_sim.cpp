@@ -0,0 +1,267 @@
+/**
+ * @file rfid_field_sim.cpp
+ * @brief Checks the RFID inventory pass and the per-pass access decision against a simulated PICC field.
+ *
+ * @details
+ * A simulated MFRC522 exposes the calls `rfidInventory()` uses. Its field
+ * holds any number of cards with 4-, 7- or 10-byte UIDs. Anticollision
+ * resolves towards the highest UID first; two cards with the same UID answer
+ * as one and are halted together; a card can be made to fail a number of
+ * selects first, like a collision that noise keeps from resolving.
+ *
+ * Each scenario is a sequence of passes. A pass either presents a new field
+ * or polls the cards still in it (halted cards stay silent), then runs the
+ * inventory and the decision `taskPrinter` makes for the whole pass
+ * (`doorBatchDecide()` over `accessCheck()` of every card) against a small
+ * compiled policy. The formatted UIDs of the batch, the decision and the card
+ * it names must match the expected ones; the exit status is non-zero on any
+ * mismatch.
+ *
+ * Build:
+ *     g++ -std=c++17 -O2 -I../.. -o rfid_field_sim rfid_field_sim.cpp ../../door_logic.cpp \
+ *         ../../access_schedule.cpp
+ *
+ * Usage:
+ *     rfid_field_sim --scenarios
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "access_schedule.h"
+#include "door_logic.h"
+#include "rfid_inventory.h"
+
+//========= SIMULATED PICC FIELD =========
+
+/** @brief One card in the field. */
+typedef struct {
+  uint8_t size;
+  uint8_t uid[10];
+  uint8_t failSelects;  ///< Selects that fail before this card resolves
+  bool halted;          ///< Answered HLTA; silent to REQA until it leaves the field
+} simCard_t;
+
+/** @brief Orders UIDs the way the simulated anticollision resolves them. */
+static int uidCompare(const simCard_t* a, const simCard_t* b) {
+  uint8_t pa[10] = { 0 }, pb[10] = { 0 };
+  memcpy(pa, a->uid, a->size);
+  memcpy(pb, b->uid, b->size);
+  int c = memcmp(pa, pb, sizeof(pa));
+  return c ? c : a->size - b->size;
+}
+
+/**
+ * @brief Stand-in for MFRC522 exposing the calls used by rfidInventory().
+ */
+struct FieldReader {
+  struct Uid {
+    uint8_t size;
+    uint8_t uidByte[10];
+    uint8_t sak;
+  } uid;
+  std::vector<simCard_t> field;
+  int selected = -1;
+
+  bool PICC_IsNewCardPresent() {
+    for (const simCard_t& c : field)
+      if (!c.halted) return true;
+    return false;
+  }
+  bool PICC_ReadCardSerial() {
+    selected = -1;
+    for (size_t i = 0; i < field.size(); i++) {
+      if (!field[i].halted && (selected < 0 || uidCompare(&field[i], &field[selected]) > 0)) selected = (int)i;
+    }
+    if (selected < 0) return false;
+    if (field[selected].failSelects) {
+      field[selected].failSelects--;
+      selected = -1;
+      return false;
+    }
+    uid.size = field[selected].size;
+    memcpy(uid.uidByte, field[selected].uid, uid.size);
+    return true;
+  }
+  void PICC_HaltA() {
+    if (selected < 0) return;
+    // every card that answered the select with the same UID takes the HLTA
+    simCard_t sel = field[selected];
+    for (simCard_t& c : field)
+      if (!c.halted && !uidCompare(&c, &sel)) c.halted = true;
+  }
+  void PCD_StopCrypto1() {}
+};
+
+/** @brief Builds a card from "04 52 0A ..." form. */
+static simCard_t card(const char* uid, uint8_t failSelects = 0) {
+  simCard_t c;
+  memset(&c, 0, sizeof(c));
+  const char* p = uid;
+  while (*p && c.size < sizeof(c.uid)) {
+    char* end;
+    c.uid[c.size++] = (uint8_t)strtoul(p, &end, 16);
+    p = *end == ' ' ? end + 1 : end;
+  }
+  c.failSelects = failSelects;
+  return c;
+}
+
+//========= POLICY =========
+
+#define ACCESS_COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static const accessWindow_t alwaysWindows[] = { { ACCESS_EVERY_DAY, ACCESS_HM(0, 0), ACCESS_HM(24, 0) } };
+static const accessScheduleDef_t schedules[] = { { "always", alwaysWindows, ACCESS_COUNT(alwaysWindows) } };
+static const accessCredentialDef_t credentials[] = {
+  { "DE AD BE EF", 0, NULL },
+  { "CA FE BA BE", 0, NULL },
+  { "04 52 0A F2 3C 5D 80", 0, NULL },
+  { "04 52 0A F2 3C 5D 81", 0, "2020-01-01" }  // expired
+};
+
+static accessTable_t table;
+static accessCredential_t credStorage[ACCESS_COUNT(credentials)];
+static accessSchedule_t schedStorage[ACCESS_COUNT(schedules)];
+
+//========= SCENARIOS =========
+
+/** @brief One reader poll and what taskPrinter must make of it. */
+typedef struct {
+  std::vector<simCard_t> present;  ///< New field; empty keeps the cards already there
+  bool locked;                     ///< Lock flag before the pass
+  std::vector<std::string> uids;   ///< Expected batch, in read order
+  doorDecision_t decision;         ///< Expected decision
+  const char* acted;               ///< UID the decision is about
+} pass_t;
+
+typedef struct {
+  const char* name;
+  std::vector<pass_t> passes;
+} scenario_t;
+
+static const char* kDecisions[] = { "granted", "regrant", "ignored", "denied" };
+
+static const char* A = "DE AD BE EF";  ///< Authorized
+static const char* B = "CA FE BA BE";  ///< Authorized
+static const char* U = "12 34 56 78";  ///< Unknown
+static const char* L7 = "04 52 0A F2 3C 5D 80";  ///< Authorized 7-byte
+static const char* X7 = "04 52 0A F2 3C 5D 81";  ///< Expired 7-byte, collides with L7 down to the last bit
+static const char* U10 = "88 04 11 22 33 44 55 66 77 99";  ///< 10-byte, never on the list
+
+static std::vector<scenario_t> scenarios() {
+  std::vector<scenario_t> v;
+  v.push_back({ "single authorized card", { { { card(A) }, true, { A }, DOOR_GRANTED, A } } });
+  v.push_back({ "single unknown card", { { { card(U) }, true, { U }, DOOR_DENIED, U } } });
+  v.push_back({ "wallet: authorized and unknown",
+                { { { card(U), card(A) }, true, { A, U }, DOOR_GRANTED, A },
+                  { { card(A), card(U) }, false, { A, U }, DOOR_IGNORED, A } } });
+  v.push_back({ "unknown cards only: one denial", { { { card(U), card("01 02 03 04") }, true,
+                                                       { U, "01 02 03 04" }, DOOR_DENIED, U } } });
+  v.push_back({ "two authorized cards held together",
+                { { { card(A), card(B) }, true, { A, B }, DOOR_GRANTED, A },
+                  { { card(B), card(A) }, false, { A, B }, DOOR_IGNORED, A },
+                  { { card(A), card(B) }, true, { A, B }, DOOR_REGRANT, A } } });
+  v.push_back({ "last grant preferred in a new wallet",
+                { { { card(B) }, true, { B }, DOOR_GRANTED, B },
+                  { { card(A), card(B) }, true, { A, B }, DOOR_REGRANT, B } } });
+  v.push_back({ "7-byte UIDs colliding to the last bit",
+                { { { card(L7), card(X7) }, true, { X7, L7 }, DOOR_GRANTED, L7 } } });
+  v.push_back({ "expired 7-byte card alone", { { { card(X7) }, true, { X7 }, DOOR_DENIED, X7 } } });
+  v.push_back({ "10-byte UID formatted in full", { { { card(U10), card(A) }, true, { A, U10 }, DOOR_GRANTED, A } } });
+  v.push_back({ "cloned UIDs answer as one", { { { card(A), card(A), card(U) }, true, { A, U }, DOOR_GRANTED, A } } });
+  v.push_back({ "noisy collision retried", { { { card(U), card("F0 00 00 01", RFID_SELECT_RETRIES) }, true,
+                                               { "F0 00 00 01", U }, DOOR_DENIED, "F0 00 00 01" } } });
+  v.push_back({ "unresolvable collision ends the pass",
+                { { { card(A), card(U, RFID_SELECT_RETRIES + 1) }, true, { A }, DOOR_GRANTED, A },
+                  { { card("F0 00 00 01", RFID_SELECT_RETRIES + 1), card(A) }, true, {}, DOOR_DENIED, NULL } } });
+
+  std::vector<simCard_t> six;
+  const char* sixUids[] = { "F0 00 00 01", "E0 00 00 02", "D0 00 00 03", "C0 00 00 04", "B0 00 00 05", A };
+  for (const char* u : sixUids) six.push_back(card(u));
+  v.push_back({ "more cards than one pass",
+                { { six, true, { "F0 00 00 01", "E0 00 00 02", "DE AD BE EF", "D0 00 00 03" }, DOOR_GRANTED, A },
+                  { {}, false, { "C0 00 00 04", "B0 00 00 05" }, DOOR_DENIED, "C0 00 00 04" } } });
+  return v;
+}
+
+static std::string join(const std::vector<std::string>& v) {
+  std::string s;
+  for (const std::string& x : v) s += (s.empty() ? "" : " | ") + x;
+  return s.empty() ? "(none)" : s;
+}
+
+/**
+ * @brief Runs one scenario; returns true if every pass matches.
+ */
+static bool runScenario(const scenario_t& sc) {
+  FieldReader reader;
+  char lastUID[RFID_UID_STR_LEN] = "";
+  bool ok = true;
+  accessTime_t now;
+  accessTimeFromCalendar(&table, 2025, 6, 2, 12, 0, &now);  // a Monday noon
+
+  for (size_t p = 0; p < sc.passes.size(); p++) {
+    const pass_t& pass = sc.passes[p];
+    if (!pass.present.empty()) reader.field = pass.present;
+
+    rfidBatch_t batch;
+    rfidInventory(reader, &batch);
+    std::vector<std::string> got;
+    const char* uids[RFID_MAX_CARDS];
+    bool allowed[RFID_MAX_CARDS];
+    for (int i = 0; i < batch.count; i++) {
+      got.push_back(batch.tags[i].str);
+      uids[i] = batch.tags[i].str;
+      allowed[i] = accessCheck(&table, accessKeyFromBytes(batch.tags[i].bytes, batch.tags[i].size), &now) == ACCESS_OK;
+    }
+
+    bool passOk = got == pass.uids;
+    const char* acted = NULL;
+    doorDecision_t d = DOOR_DENIED;
+    if (batch.count) {
+      uint8_t pick;
+      d = doorBatchDecide(lastUID, sizeof(lastUID), uids, allowed, batch.count, pass.locked, &pick);
+      acted = uids[pick];
+    }
+    passOk = passOk && d == pass.decision &&
+             ((!acted && !pass.acted) || (acted && pass.acted && !strcmp(acted, pass.acted)));
+    if (!passOk) {
+      printf("    pass %zu: read %s -> %s %s\n", p + 1, join(got).c_str(), kDecisions[d], acted ? acted : "-");
+      printf("    want     %s -> %s %s\n", join(pass.uids).c_str(), kDecisions[pass.decision],
+             pass.acted ? pass.acted : "-");
+    }
+    ok = ok && passOk;
+  }
+  printf("%-40s %zu pass(es)  %s\n", sc.name, sc.passes.size(), ok ? "ok" : "FAIL");
+  return ok;
+}
+
+static int runScenarios() {
+  int failed = 0;
+  for (const scenario_t& sc : scenarios()) failed += !runScenario(sc);
+  printf("%d scenario(s) failed\n", failed);
+  return failed ? 1 : 0;
+}
+
+//========= MAIN =========
+
+int main(int argc, char** argv) {
+  accessPolicy_t policy = { schedules, ACCESS_COUNT(schedules), credentials, ACCESS_COUNT(credentials), NULL, 0 };
+  accessTableInit(&table, credStorage, ACCESS_COUNT(credentials), schedStorage, ACCESS_COUNT(schedules));
+  char err[96];
+  if (!accessCompile(&table, &policy, err, sizeof(err))) {
+    fprintf(stderr, "policy: %s\n", err);
+    return 2;
+  }
+  if (argc == 2 && !strcmp(argv[1], "--scenarios")) return runScenarios();
+  fprintf(stderr, "usage: %s --scenarios\n", argv[0]);
+  return 2;
+}
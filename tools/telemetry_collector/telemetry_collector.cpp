@@ -0,0 +1,310 @@
+/**
+ * @file telemetry_collector.cpp
+ * @brief Linux host collector for the Smart Security Door binary telemetry stream.
+ *
+ * @details
+ * Reads COBS-framed telemetry records (see `telemetry_proto.h`) from a serial
+ * device or pseudo-terminal, validates version and CRC, and writes one line per
+ * record to stdout as CSV or JSON. Every `--stats` seconds a summary is written
+ * to stderr with per-type message rates, sequence gaps, out-of-order records,
+ * rejected frames and the UART link utilization at the configured baud rate
+ * (10 bits per byte, 8N1). A record a little behind the last sequence number
+ * is late, not a gap; a large backward jump means the device restarted.
+ *
+ * Plain-text `Serial.print` output that shares the UART is skipped: it never
+ * decodes to a valid record and is only counted as rejected bytes.
+ *
+ * Build:
+ *     g++ -std=c++17 -O2 -I../.. -o telemetry_collector telemetry_collector.cpp
+ *
+ * Usage:
+ *     telemetry_collector /dev/ttyUSB0 [--baud 115200] [--format csv|json] [--stats 5]
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "telemetry_proto.h"
+
+//========= STATE =========
+enum OutputFormat { FMT_CSV, FMT_JSON };
+
+/** @brief Counters accumulated between two stats reports. */
+typedef struct {
+  uint64_t msgs[TLM_PRESENCE + 1];  ///< Valid records per ::TelemetryMsgType (index 0 unused)
+  uint64_t bytes;                  ///< Raw bytes received, including rejected ones
+  uint64_t badFrames;              ///< Frames rejected by COBS, length, version or CRC
+  uint64_t seqGaps;                ///< Records missing according to the sequence number
+  uint64_t outOfOrder;             ///< Records fewer than `SEQ_REORDER_WINDOW` behind the last one
+} collectorStats_t;
+
+#define SEQ_REORDER_WINDOW 8  ///< Producers take seq before queueing, so two tasks can swap a few records;
+                              ///< larger backward jumps are taken as a device restart
+
+static const char* kTypeNames[] = { "?", "sample", "edge", "access", "lock", "anomaly", "alert", "presence" };
+static const char* kDecisionNames[] = { "granted", "regrant", "ignored", "denied" };
+
+//========= HELPERS =========
+
+/** @brief Monotonic time in seconds. */
+static double nowSec() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/** @brief Maps a numeric baud rate to a termios constant. */
+static speed_t baudConstant(long baud) {
+  switch (baud) {
+    case 9600: return B9600;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+    case 460800: return B460800;
+    case 921600: return B921600;
+    default: return B115200;
+  }
+}
+
+/**
+ * @brief Puts a tty into raw 8N1 mode. Non-tty inputs (files, pipes) are left untouched.
+ */
+static void configureTty(int fd, long baud) {
+  if (!isatty(fd)) return;
+  struct termios t;
+  if (tcgetattr(fd, &t) != 0) return;
+  cfmakeraw(&t);
+  cfsetispeed(&t, baudConstant(baud));
+  cfsetospeed(&t, baudConstant(baud));
+  t.c_cflag |= CLOCAL | CREAD;
+  t.c_cc[VMIN] = 1;
+  t.c_cc[VTIME] = 0;
+  tcsetattr(fd, TCSANOW, &t);
+}
+
+/**
+ * @brief Prints a decoded record in the selected output format.
+ */
+static void printRecord(const tlmHeader_t* h, const uint8_t* p, OutputFormat fmt) {
+  char fields[160] = "";
+
+  switch (h->type) {
+    case TLM_SENSOR_SAMPLE: {
+      tlmSensorSample_t s;
+      memcpy(&s, p, sizeof(s));
+      snprintf(fields, sizeof(fields),
+               fmt == FMT_CSV ? "%.1f,%u,%u,%u"
+                              : "\"distance_cm\":%.1f,\"pir\":%u,\"close\":%u,\"motion\":%u",
+               s.distanceMm / 10.0, s.motion, s.flags & 1, (s.flags >> 1) & 1);
+      break;
+    }
+    case TLM_DETECTION_EDGE: {
+      tlmDetectionEdge_t e;
+      memcpy(&e, p, sizeof(e));
+      snprintf(fields, sizeof(fields),
+               fmt == FMT_CSV ? "%u,%u,%u" : "\"present\":%u,\"close\":%u,\"motion\":%u",
+               e.present, e.flags & 1, (e.flags >> 1) & 1);
+      break;
+    }
+    case TLM_ACCESS_DECISION: {
+      tlmAccessDecision_t a;
+      memcpy(&a, p, sizeof(a));
+      char uid[32] = "";
+      for (int i = 0; i < a.uidLen && i < 10; i++) {
+        snprintf(uid + strlen(uid), sizeof(uid) - strlen(uid), i ? " %02X" : "%02X", a.uid[i]);
+      }
+      const char* d = a.decision < 4 ? kDecisionNames[a.decision] : "?";
+      snprintf(fields, sizeof(fields),
+               fmt == FMT_CSV ? "%s,%s" : "\"decision\":\"%s\",\"uid\":\"%s\"", d, uid);
+      break;
+    }
+    case TLM_LOCK_STATE: {
+      tlmLockState_t l;
+      memcpy(&l, p, sizeof(l));
+      snprintf(fields, sizeof(fields),
+               fmt == FMT_CSV ? "%u,%u" : "\"locked\":%u,\"servo_deg\":%u", l.locked, l.servoAngle);
+      break;
+    }
+    case TLM_ANOMALY: {
+      tlmAnomaly_t a;
+      memcpy(&a, p, sizeof(a));
+      snprintf(fields, sizeof(fields),
+               fmt == FMT_CSV ? "%u,%u,%u" : "\"events\":%u,\"bucket\":%u,\"dwell_s\":%u",
+               a.events, a.bucket, a.dwellS);
+      break;
+    }
+    case TLM_ALERT: {
+      tlmAlert_t a;
+      memcpy(&a, p, sizeof(a));
+      snprintf(fields, sizeof(fields), fmt == FMT_CSV ? "%u" : "\"alert\":%u", a.alert);
+      break;
+    }
+    case TLM_PRESENCE: {
+      tlmPresence_t s;
+      memcpy(&s, p, sizeof(s));
+      snprintf(fields, sizeof(fields),
+               fmt == FMT_CSV ? "%u,%u,%u,%.1f,%.1f"
+                              : "\"start_ms\":%u,\"duration_ms\":%u,\"samples\":%u,\"min_cm\":%.1f,\"mean_cm\":%.1f",
+               (unsigned)s.startMs, (unsigned)s.durationMs, (unsigned)s.samples, s.minMm / 10.0, s.meanMm / 10.0);
+      break;
+    }
+  }
+
+  if (fmt == FMT_CSV) {
+    printf("%u,%u,%s,%s\n", (unsigned)h->timestampMs, h->seq, kTypeNames[h->type], fields);
+  } else {
+    printf("{\"t_ms\":%u,\"seq\":%u,\"type\":\"%s\",%s}\n",
+           (unsigned)h->timestampMs, h->seq, kTypeNames[h->type], fields);
+  }
+}
+
+/**
+ * @brief Validates and prints one COBS frame (delimiter already stripped).
+ * @return true if the frame held a valid record
+ */
+static bool handleFrame(const uint8_t* frame, size_t len, OutputFormat fmt,
+                        collectorStats_t* st, int* lastSeq) {
+  uint8_t rec[TLM_MAX_FRAME];
+  if (len == 0 || len > sizeof(rec)) return false;
+
+  size_t n = tlmCobsDecode(frame, len, rec);
+  if (n < sizeof(tlmHeader_t) + TLM_CRC_SIZE) return false;
+
+  uint16_t crc = rec[n - 2] | (rec[n - 1] << 8);
+  if (tlmCrc16(rec, n - TLM_CRC_SIZE) != crc) return false;
+
+  tlmHeader_t h;
+  memcpy(&h, rec, sizeof(h));
+  if (h.version != TLM_PROTO_VERSION) return false;
+  int plen = tlmPayloadSize(h.type);
+  if (plen < 0 || (size_t)plen != n - sizeof(h) - TLM_CRC_SIZE) return false;
+
+  if (*lastSeq >= 0) {
+    uint16_t ahead = (uint16_t)(h.seq - (uint16_t)(*lastSeq + 1));
+    uint16_t behind = (uint16_t)(*lastSeq - h.seq);
+    if (behind < SEQ_REORDER_WINDOW) {
+      st->outOfOrder++;  // late or repeated record: printed, but the sequence stays where it was
+    } else {
+      if (ahead < 0x8000) st->seqGaps += ahead;
+      *lastSeq = h.seq;
+    }
+  } else {
+    *lastSeq = h.seq;
+  }
+  st->msgs[h.type]++;
+
+  printRecord(&h, rec + sizeof(h), fmt);
+  return true;
+}
+
+/**
+ * @brief Writes rates and link utilization for the last interval to stderr.
+ */
+static void reportStats(const collectorStats_t* st, double interval, long baud) {
+  uint64_t total = 0;
+  for (int i = 1; i <= TLM_PRESENCE; i++) total += st->msgs[i];
+  double util = 100.0 * (st->bytes * 10.0) / (baud * interval);
+
+  fprintf(stderr, "[stats %.1fs] %.1f msg/s (", interval, total / interval);
+  for (int i = 1; i <= TLM_PRESENCE; i++) {
+    fprintf(stderr, "%s%s %.1f", i > 1 ? ", " : "", kTypeNames[i], st->msgs[i] / interval);
+  }
+  fprintf(stderr, ") | %.0f B/s, link %.2f%% of %ld baud | bad frames %llu, seq gaps %llu, out of order %llu\n",
+          st->bytes / interval, util, baud, (unsigned long long)st->badFrames, (unsigned long long)st->seqGaps,
+          (unsigned long long)st->outOfOrder);
+}
+
+//========= MAIN =========
+int main(int argc, char** argv) {
+  const char* path = NULL;
+  long baud = 115200;
+  double statsInterval = 5.0;
+  OutputFormat fmt = FMT_CSV;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--baud") && i + 1 < argc) {
+      baud = atol(argv[++i]);
+    } else if (!strcmp(argv[i], "--format") && i + 1 < argc) {
+      fmt = !strcmp(argv[++i], "json") ? FMT_JSON : FMT_CSV;
+    } else if (!strcmp(argv[i], "--stats") && i + 1 < argc) {
+      statsInterval = atof(argv[++i]);
+    } else if (argv[i][0] != '-') {
+      path = argv[i];
+    } else {
+      path = NULL;
+      break;
+    }
+  }
+  if (!path || baud <= 0 || statsInterval <= 0) {
+    fprintf(stderr, "usage: %s <device> [--baud N] [--format csv|json] [--stats seconds]\n", argv[0]);
+    return 2;
+  }
+
+  int fd = open(path, O_RDONLY | O_NOCTTY);
+  if (fd < 0) {
+    fprintf(stderr, "open %s: %s\n", path, strerror(errno));
+    return 1;
+  }
+  configureTty(fd, baud);
+
+  setvbuf(stdout, NULL, _IOLBF, 0);
+  if (fmt == FMT_CSV) printf("t_ms,seq,type,fields...\n");
+
+  collectorStats_t st;
+  memset(&st, 0, sizeof(st));
+  int lastSeq = -1;
+  uint8_t frame[TLM_MAX_FRAME];
+  size_t frameLen = 0;
+  bool overflow = false;
+  double lastReport = nowSec();
+
+  while (1) {
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    int timeoutMs = (int)(statsInterval * 1000 - (nowSec() - lastReport) * 1000);
+    int r = poll(&pfd, 1, timeoutMs > 0 ? timeoutMs : 0);
+    if (r < 0 && errno != EINTR) break;
+
+    if (r > 0) {
+      uint8_t buf[512];
+      ssize_t n = read(fd, buf, sizeof(buf));
+      if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR)) break;  // EOF / peer closed
+      for (ssize_t i = 0; i < n; i++) {
+        st.bytes++;
+        if (buf[i] == 0x00) {
+          if (overflow || !handleFrame(frame, frameLen, fmt, &st, &lastSeq)) {
+            if (frameLen > 0 || overflow) st.badFrames++;
+          }
+          frameLen = 0;
+          overflow = false;
+        } else if (frameLen < sizeof(frame)) {
+          frame[frameLen++] = buf[i];
+        } else {
+          overflow = true;
+        }
+      }
+    }
+
+    double now = nowSec();
+    if (now - lastReport >= statsInterval) {
+      reportStats(&st, now - lastReport, baud);
+      memset(&st, 0, sizeof(st));
+      lastReport = now;
+    }
+  }
+
+  double now = nowSec();
+  if (now - lastReport > 0) reportStats(&st, now - lastReport, baud);
+  close(fd);
+  return 0;
+}
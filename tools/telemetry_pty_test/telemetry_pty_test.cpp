@@ -0,0 +1,276 @@
+/**
+ * @file telemetry_pty_test.cpp
+ * @brief Runs the telemetry collector against a pseudo-terminal standing in for the door.
+ *
+ * @details
+ * Opens a pty, starts `telemetry_collector` on its slave side and, once the
+ * collector has put the line into raw mode (its CSV header appears), writes a
+ * known stream to the master the way `telemetry.cpp` batches it: a leading
+ * `0x00`, then COBS frames. The stream mixes valid records of every kind
+ * with a corrupted CRC, a wrong protocol version, a truncated frame,
+ * plain-text `Serial.print` output, a skipped sequence number, a late
+ * (out-of-sequence) record and a restart of the sequence counter.
+ *
+ * The collector's CSV lines must match the valid records exactly, in order,
+ * and its final stats line on stderr must report the expected bad frames,
+ * sequence gaps and out-of-order records. The exit status is non-zero on any
+ * mismatch.
+ *
+ * Build:
+ *     g++ -std=c++17 -O2 -I../.. -o telemetry_pty_test telemetry_pty_test.cpp
+ *
+ * Usage:
+ *     telemetry_pty_test [path/to/telemetry_collector]
+ *
+ * @section author Author
+ * Created by Sanjay Varghese, 2025
+ * Additionally modified by Sai Jayanth Kalisi, 2025
+ * Additionally modified by Ankit Telluri, 2025
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "telemetry_proto.h"
+
+#define WAIT_MS 3000  ///< Longest wait for the collector to print something
+
+//========= STREAM =========
+
+/** @brief Bytes sent to the pty and the collector output they must produce. */
+typedef struct {
+  std::vector<uint8_t> bytes;
+  std::vector<std::string> csv;  ///< Expected CSV lines, header excluded
+  unsigned badFrames;
+  unsigned seqGaps;
+  unsigned outOfOrder;
+} stream_t;
+
+/**
+ * @brief Builds one raw record (header, payload, CRC) as the firmware does.
+ */
+static std::vector<uint8_t> record(uint8_t type, uint16_t seq, uint32_t ms, const void* payload, uint8_t len) {
+  tlmHeader_t h = { TLM_PROTO_VERSION, type, seq, ms };
+  std::vector<uint8_t> r(sizeof(h) + len + TLM_CRC_SIZE);
+  memcpy(r.data(), &h, sizeof(h));
+  memcpy(r.data() + sizeof(h), payload, len);
+  uint16_t crc = tlmCrc16(r.data(), sizeof(h) + len);
+  r[sizeof(h) + len] = crc & 0xFF;
+  r[sizeof(h) + len + 1] = crc >> 8;
+  return r;
+}
+
+/** @brief Appends the COBS frame of a raw record, delimiter included. */
+static void frame(stream_t* s, const std::vector<uint8_t>& rec) {
+  uint8_t out[TLM_MAX_FRAME + 8];
+  size_t n = tlmCobsEncode(rec.data(), rec.size(), out);
+  s->bytes.insert(s->bytes.end(), out, out + n);
+}
+
+/** @brief Appends a valid record and the CSV line it must produce. */
+static void good(stream_t* s, uint8_t type, uint16_t seq, uint32_t ms, const void* payload, uint8_t len,
+                 const char* fields) {
+  frame(s, record(type, seq, ms, payload, len));
+  static const char* names[] = { "?", "sample", "edge", "access", "lock", "anomaly", "alert", "presence" };
+  s->csv.push_back(std::to_string(ms) + "," + std::to_string(seq) + "," + names[type] + "," + fields);
+}
+
+static stream_t buildStream() {
+  stream_t s = { {}, {}, 0, 0, 0 };
+  s.bytes.push_back(0x00);  // batch start, as telemetry.cpp sends it
+
+  tlmSensorSample_t sample = { 1234, 1, 0x03 };
+  good(&s, TLM_SENSOR_SAMPLE, 10, 1000, &sample, sizeof(sample), "123.4,1,1,1");
+  tlmDetectionEdge_t edge = { 1, 0x01 };
+  good(&s, TLM_DETECTION_EDGE, 11, 1020, &edge, sizeof(edge), "1,1,0");
+  tlmAccessDecision_t access = { TLM_DECISION_GRANTED, 7, { 0x04, 0x52, 0x0A, 0xF2, 0x3C, 0x5D, 0x80 } };
+  good(&s, TLM_ACCESS_DECISION, 12, 1100, &access, sizeof(access), "granted,04 52 0A F2 3C 5D 80");
+
+  // corrupted CRC
+  tlmLockState_t lock = { 0, 90 };
+  std::vector<uint8_t> bad = record(TLM_LOCK_STATE, 13, 1200, &lock, sizeof(lock));
+  bad.back() ^= 0x55;
+  frame(&s, bad);
+  s.badFrames++;
+
+  // wrong protocol version (CRC recomputed so only the version is wrong)
+  bad = record(TLM_LOCK_STATE, 13, 1200, &lock, sizeof(lock));
+  bad[0] = TLM_PROTO_VERSION + 1;
+  uint16_t crc = tlmCrc16(bad.data(), bad.size() - TLM_CRC_SIZE);
+  bad[bad.size() - 2] = crc & 0xFF;
+  bad[bad.size() - 1] = crc >> 8;
+  frame(&s, bad);
+  s.badFrames++;
+
+  // plain-text Serial output between two batches, then the next batch start
+  const char* text = "Access Granted. Unlocking...\r\n";
+  s.bytes.insert(s.bytes.end(), text, text + strlen(text));
+  s.bytes.push_back(0x00);
+  s.badFrames++;
+
+  // seq 13 was lost with the bad frames above, so this is a gap of one
+  good(&s, TLM_LOCK_STATE, 14, 1210, &lock, sizeof(lock), "0,90");
+
+  // truncated frame: the tail of a record cut off by a UART overrun
+  tlmAlert_t alert = { 2 };
+  frame(&s, record(TLM_ALERT, 15, 1300, &alert, sizeof(alert)));
+  s.bytes.erase(s.bytes.end() - 4, s.bytes.end() - 1);
+  s.badFrames++;
+
+  tlmAnomaly_t anomaly = { 0x05, 3, 42 };
+  good(&s, TLM_ANOMALY, 16, 1400, &anomaly, sizeof(anomaly), "5,3,42");  // 15 lost: gap of one
+
+  // 15 turns up late: printed, counted out of order, not a gap and not a rewind
+  good(&s, TLM_ALERT, 15, 1300, &alert, sizeof(alert), "2");
+  s.outOfOrder++;
+
+  tlmPresence_t presence = { 1020, 4980, 250, 412, 655 };
+  good(&s, TLM_PRESENCE, 17, 6000, &presence, sizeof(presence), "1020,4980,250,41.2,65.5");
+  good(&s, TLM_SENSOR_SAMPLE, 20, 6060, &sample, sizeof(sample), "123.4,1,1,1");  // 18, 19 lost
+
+  // the door rebooted: the sequence restarts without counting a gap
+  good(&s, TLM_LOCK_STATE, 0, 15, &lock, sizeof(lock), "0,90");
+  good(&s, TLM_LOCK_STATE, 1, 35, &lock, sizeof(lock), "0,90");
+  s.seqGaps = 1 + 1 + 2;
+  return s;
+}
+
+//========= COLLECTOR =========
+
+/**
+ * @brief Reads from `fd` into `out` until `want` appears or the wait expires.
+ */
+static bool readUntil(int fd, std::string* out, const std::string& want) {
+  while (out->find(want) == std::string::npos) {
+    struct pollfd p = { fd, POLLIN, 0 };
+    if (poll(&p, 1, WAIT_MS) <= 0) return false;
+    char buf[512];
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n <= 0) return false;
+    out->append(buf, n);
+  }
+  return true;
+}
+
+/** @brief Reads `fd` until EOF or the wait expires. */
+static void readAll(int fd, std::string* out) {
+  while (1) {
+    struct pollfd p = { fd, POLLIN, 0 };
+    if (poll(&p, 1, WAIT_MS) <= 0) return;
+    char buf[512];
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n <= 0) return;
+    out->append(buf, n);
+  }
+}
+
+static std::vector<std::string> lines(const std::string& s) {
+  std::vector<std::string> v;
+  size_t start = 0, nl;
+  while ((nl = s.find('\n', start)) != std::string::npos) {
+    v.push_back(s.substr(start, nl - start));
+    start = nl + 1;
+  }
+  return v;
+}
+
+//========= MAIN =========
+
+int main(int argc, char** argv) {
+  const char* collector = argc > 1 ? argv[1] : "../telemetry_collector/telemetry_collector";
+  signal(SIGPIPE, SIG_IGN);
+
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+    perror("posix_openpt");
+    return 2;
+  }
+  const char* slave = ptsname(master);
+
+  int out[2], err[2];
+  if (pipe(out) != 0 || pipe(err) != 0) {
+    perror("pipe");
+    return 2;
+  }
+  pid_t pid = fork();
+  if (pid == 0) {
+    dup2(out[1], STDOUT_FILENO);
+    dup2(err[1], STDERR_FILENO);
+    close(out[0]);
+    close(err[0]);
+    close(master);
+    execl(collector, collector, slave, "--stats", "600", (char*)NULL);
+    fprintf(stderr, "exec %s: %s\n", collector, strerror(errno));
+    _exit(127);
+  }
+  close(out[1]);
+  close(err[1]);
+
+  stream_t s = buildStream();
+  std::string csv;
+  if (!readUntil(out[0], &csv, "t_ms,seq,type,fields...\n")) {
+    std::string e;
+    readAll(err[0], &e);
+    fprintf(stderr, "collector did not start: %s", e.c_str());
+    kill(pid, SIGKILL);
+    return 1;
+  }
+
+  // the collector has configured the line; send the stream in uneven chunks
+  size_t chunks[] = { 1, 7, 3, 64, 2, 29 };
+  for (size_t off = 0, k = 0; off < s.bytes.size(); k++) {
+    size_t n = chunks[k % (sizeof(chunks) / sizeof(chunks[0]))];
+    if (n > s.bytes.size() - off) n = s.bytes.size() - off;
+    if (write(master, s.bytes.data() + off, n) != (ssize_t)n) {
+      perror("write");
+      return 2;
+    }
+    off += n;
+  }
+
+  // wait for the last record before hanging up: a hangup may discard unread input
+  bool complete = readUntil(out[0], &csv, s.csv.back() + "\n");
+  close(master);
+  readAll(out[0], &csv);
+  std::string stats;
+  readAll(err[0], &stats);
+  int status = 0;
+  waitpid(pid, &status, 0);
+
+  int failed = 0;
+  std::vector<std::string> got = lines(csv);
+  got.erase(got.begin());
+  printf("%zu bytes sent, %zu records expected, %zu printed%s\n", s.bytes.size(), s.csv.size(), got.size(),
+         complete ? "" : " (timed out)");
+  for (size_t i = 0; i < s.csv.size() || i < got.size(); i++) {
+    const char* want = i < s.csv.size() ? s.csv[i].c_str() : "-";
+    const char* have = i < got.size() ? got[i].c_str() : "-";
+    bool ok = i < s.csv.size() && i < got.size() && s.csv[i] == got[i];
+    failed += !ok;
+    printf("  %-36s %s\n", have, ok ? "ok" : (std::string("FAIL, want ") + want).c_str());
+  }
+
+  char want[96];
+  snprintf(want, sizeof(want), "bad frames %u, seq gaps %u, out of order %u\n", s.badFrames, s.seqGaps,
+           s.outOfOrder);
+  std::vector<std::string> report = lines(stats);
+  bool statsOk = !report.empty() && report.back().find(want, 0, strlen(want) - 1) != std::string::npos;
+  printf("stats: %s\n  %s\n", statsOk ? "ok" : "FAIL", report.empty() ? "(none)" : report.back().c_str());
+  if (!statsOk) printf("  want ... %s", want);
+  failed += !statsOk;
+
+  bool exitOk = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  if (!exitOk) printf("collector exit status %d: FAIL\n", status);
+  failed += !exitOk;
+
+  printf("%d check(s) failed\n", failed);
+  return failed ? 1 : 0;
+}